@@ -47,6 +47,7 @@ class QgsBoundaryAlgorithm : public QgsProcessingFeatureBasedAlgorithm
 
     QString outputName() const override;
     QgsWkbTypes::Type outputWkbType( QgsWkbTypes::Type inputWkbType ) const override;
+    bool supportsParallelProcessing() const override { return true; }
     QgsFeatureList processFeature( const QgsFeature &feature,  QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
 };
 
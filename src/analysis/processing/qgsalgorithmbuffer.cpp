@@ -16,6 +16,7 @@
  ***************************************************************************/
 
 #include "qgsalgorithmbuffer.h"
+#include "qgscascadedunion.h"
 
 ///@cond PRIVATE
 
@@ -151,17 +152,21 @@ QVariantMap QgsBufferAlgorithm::processAlgorithm( const QVariantMap &parameters,
     current++;
   }
 
-  if ( dissolve )
+  QVariantMap outputs;
+  outputs.insert( QStringLiteral( "OUTPUT" ), dest );
+
+  if ( dissolve && !feedback->isCanceled() )
   {
-    QgsGeometry finalGeometry = QgsGeometry::unaryUnion( bufferedGeometriesForDissolve );
+    QgsGeometry finalGeometry = QgsCascadedUnion::unaryUnion( bufferedGeometriesForDissolve, feedback );
+    if ( feedback->isCanceled() )
+      return outputs;
+
     QgsFeature f;
     f.setGeometry( finalGeometry );
     f.setAttributes( dissolveAttrs );
     sink->addFeature( f, QgsFeatureSink::FastInsert );
   }
 
-  QVariantMap outputs;
-  outputs.insert( QStringLiteral( "OUTPUT" ), dest );
   return outputs;
 }
 
@@ -16,6 +16,7 @@
  ***************************************************************************/
 
 #include "qgsalgorithmclip.h"
+#include "qgscascadedunion.h"
 #include "qgsgeometryengine.h"
 
 ///@cond PRIVATE
@@ -104,7 +105,9 @@ QVariantMap QgsClipAlgorithm::processAlgorithm( const QVariantMap &parameters, Q
   QgsGeometry combinedClipGeom;
   if ( clipGeoms.length() > 1 )
   {
-    combinedClipGeom = QgsGeometry::unaryUnion( clipGeoms );
+    combinedClipGeom = QgsCascadedUnion::unaryUnion( clipGeoms, feedback );
+    if ( feedback->isCanceled() )
+      return outputs;
     singleClipFeature = false;
   }
   else
@@ -16,9 +16,18 @@
  ***************************************************************************/
 
 #include "qgsalgorithmdissolve.h"
+#include "qgscascadedunion.h"
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <algorithm>
 
 ///@cond PRIVATE
 
+//! Number of categories collected at once for each thread, between progress reports
+static const int CATEGORIES_PER_THREAD = 4;
+
 //
 // QgsCollectorAlgorithm
 //
@@ -50,8 +59,10 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
   {
     // dissolve all - not using fields
     bool firstFeature = true;
-    // we dissolve geometries in blocks using unaryUnion
     QVector< QgsGeometry > geomQueue;
+    // full queues are collected separately, and their results only
+    // collected together at the end, so that no result keeps growing
+    QVector< QgsGeometry > partialResults;
     QgsFeature outputFeature;
 
     while ( it.nextFeature( f ) )
@@ -70,12 +81,10 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       if ( f.hasGeometry() && f.geometry() )
       {
         geomQueue.append( f.geometry() );
-        if ( maxQueueLength > 0 && geomQueue.length() > maxQueueLength )
+        if ( maxQueueLength > 0 && geomQueue.length() >= maxQueueLength )
         {
-          // queue too long, combine it
-          QgsGeometry tempOutputGeometry = collector( geomQueue );
+          partialResults << collector( geomQueue );
           geomQueue.clear();
-          geomQueue << tempOutputGeometry;
         }
       }
 
@@ -83,8 +92,13 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       current++;
     }
 
-    outputFeature.setGeometry( collector( geomQueue ) );
-    sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
+    if ( !feedback->isCanceled() )
+    {
+      partialResults << geomQueue;
+      geomQueue.clear();
+      outputFeature.setGeometry( collector( partialResults ) );
+      sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
+    }
   }
   else
   {
@@ -124,30 +138,61 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       }
     }
 
-    int numberFeatures = attributeHash.count();
-    QHash< QVariant, QgsAttributes >::const_iterator attrIt = attributeHash.constBegin();
-    for ( ; attrIt != attributeHash.constEnd(); ++attrIt )
+    // categories are collected on several threads at once, in batches
+    // so that progress can be reported from this thread
+    struct CategoryJob
+    {
+      QVariant key;
+      bool hasGeometry = false;
+      QVector< QgsGeometry > geometries;
+      QgsGeometry result;
+    };
+    auto collectCategory = [&collector]( CategoryJob & job )
+    {
+      if ( job.hasGeometry )
+        job.result = collector( job.geometries );
+      job.geometries.clear();
+    };
+
+    const QList< QVariant > keys = attributeHash.keys();
+    const int numberFeatures = keys.count();
+    const int batchSize = std::max( 1, QThread::idealThreadCount() ) * CATEGORIES_PER_THREAD;
+    for ( int start = 0; start < numberFeatures; start += batchSize )
     {
       if ( feedback->isCanceled() )
       {
         break;
       }
 
-      QgsFeature outputFeature;
-      if ( geometryHash.contains( attrIt.key() ) )
+      QVector< CategoryJob > jobs;
+      for ( int i = start; i < std::min( start + batchSize, numberFeatures ); ++i )
       {
-        QgsGeometry geom = collector( geometryHash.value( attrIt.key() ) );
-        if ( !geom.isMultipart() )
+        CategoryJob job;
+        job.key = keys.at( i );
+        job.hasGeometry = geometryHash.contains( job.key );
+        job.geometries = geometryHash.take( job.key );
+        jobs << job;
+      }
+      QtConcurrent::blockingMap( jobs, collectCategory );
+
+      for ( const CategoryJob &job : qgis::as_const( jobs ) )
+      {
+        QgsFeature outputFeature;
+        if ( job.hasGeometry )
         {
-          geom.convertToMultiType();
+          QgsGeometry geom = job.result;
+          if ( !geom.isMultipart() )
+          {
+            geom.convertToMultiType();
+          }
+          outputFeature.setGeometry( geom );
         }
-        outputFeature.setGeometry( geom );
-      }
-      outputFeature.setAttributes( attrIt.value() );
-      sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
+        outputFeature.setAttributes( attributeHash.value( job.key ) );
+        sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
 
-      feedback->setProgress( current * 100.0 / numberFeatures );
-      current++;
+        feedback->setProgress( current * 100.0 / numberFeatures );
+        current++;
+      }
     }
   }
 
@@ -214,7 +259,7 @@ QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameter
 {
   return processCollection( parameters, context, feedback, []( const QVector< QgsGeometry > &parts )->QgsGeometry
   {
-    return QgsGeometry::unaryUnion( parts );
+    return QgsCascadedUnion::unaryUnion( parts );
   }, 10000 );
 }
 
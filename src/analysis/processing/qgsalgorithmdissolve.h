@@ -32,6 +32,15 @@ class QgsCollectorAlgorithm : public QgsProcessingAlgorithm
 {
   protected:
 
+    /**
+     * Collects the geometries of the source features, grouped by the values of the
+     * selected fields. Several groups may be passed to \a collector at the same time
+     * from different threads.
+     *
+     * When all features are collected together and \a maxQueueLength is greater than 0,
+     * every \a maxQueueLength geometries are collected into a partial result as they are
+     * read, so that the whole source is never held in memory at once.
+     */
     QVariantMap processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
                                    const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector, int maxQueueLength = 0 );
 };
@@ -17,9 +17,44 @@
 
 #include "qgsalgorithmextractbylocation.h"
 #include "qgsgeometryengine.h"
+#include "qgspackedrtree.h"
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <algorithm>
 
 ///@cond PRIVATE
 
+//! Intersect sources with fewer features are tested with requests on the target source
+static const long INDEXED_JOIN_MIN_FEATURES = 100;
+
+//! Maximum number of features of the smaller source indexed in memory
+static const long INDEXED_JOIN_MAX_FEATURES = 2000000;
+
+//! Number of streamed features tested at once
+static const int INDEXED_JOIN_BLOCK_SIZE = 1000;
+
+//! Part of a block of streamed features tested by one thread
+struct QgsLocationJoinJob
+{
+  int begin = 0;
+  int end = 0;
+  QgsFeatureIds found;
+  QgsFeatureIds intersected;
+};
+
+//! Splits \a count streamed features between \a jobs
+static void splitJobs( QVector< QgsLocationJoinJob > &jobs, int count )
+{
+  const int jobSize = ( count + jobs.size() - 1 ) / jobs.size();
+  for ( int i = 0; i < jobs.size(); ++i )
+  {
+    jobs[i].begin = std::min( i * jobSize, count );
+    jobs[i].end = std::min( ( i + 1 ) * jobSize, count );
+  }
+}
+
 void QgsLocationBasedAlgorithm::addPredicateParameter()
 {
   std::unique_ptr< QgsProcessingParameterEnum > predicateParam( new QgsProcessingParameterEnum( QStringLiteral( "PREDICATE" ),
@@ -90,6 +125,27 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
     predicates << reversePredicate( static_cast< Predicate >( i ) );
   }
 
+  // a few intersect features are best tested with requests on the target source, which
+  // may use the provider's own spatial index. Otherwise the smaller side is indexed in
+  // memory and the larger one is read only once
+  const long targetCount = targetSource->featureCount();
+  const long intersectCount = intersectSource->featureCount();
+  if ( targetCount < 0 || intersectCount < INDEXED_JOIN_MIN_FEATURES
+       || std::min( targetCount, intersectCount ) > INDEXED_JOIN_MAX_FEATURES )
+    processByRequests( context, targetSource, intersectSource, predicates, handleFeatureFunction, onlyRequireTargetIds, feedback );
+  else if ( intersectCount <= targetCount )
+    processByIndexingIntersectSource( context, targetSource, intersectSource, predicates, handleFeatureFunction, onlyRequireTargetIds, feedback );
+  else
+    processByIndexingTargetSource( context, targetSource, intersectSource, predicates, handleFeatureFunction, onlyRequireTargetIds, feedback );
+}
+
+void QgsLocationBasedAlgorithm::processByRequests( const QgsProcessingContext &context, QgsFeatureSource *targetSource,
+    QgsFeatureSource *intersectSource,
+    const QList< Predicate > &predicates,
+    const std::function < void( const QgsFeature & ) > &handleFeatureFunction,
+    bool onlyRequireTargetIds,
+    QgsFeedback *feedback )
+{
   QgsFeatureIds disjointSet;
   if ( predicates.contains( Disjoint ) )
     disjointSet = targetSource->allFeatureIds();
@@ -143,35 +199,16 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
       for ( Predicate predicate : qgis::as_const( predicates ) )
       {
         bool isMatch = false;
-        switch ( predicate )
+        if ( predicate == Disjoint )
         {
-          case Intersects:
-            isMatch = engine->intersects( testFeature.geometry().constGet() );
-            break;
-          case Contains:
-            isMatch = engine->contains( testFeature.geometry().constGet() );
-            break;
-          case Disjoint:
-            if ( engine->intersects( testFeature.geometry().constGet() ) )
-            {
-              disjointSet.remove( testFeature.id() );
-            }
-            break;
-          case IsEqual:
-            isMatch = engine->isEqual( testFeature.geometry().constGet() );
-            break;
-          case Touches:
-            isMatch = engine->touches( testFeature.geometry().constGet() );
-            break;
-          case Overlaps:
-            isMatch = engine->overlaps( testFeature.geometry().constGet() );
-            break;
-          case Within:
-            isMatch = engine->within( testFeature.geometry().constGet() );
-            break;
-          case Crosses:
-            isMatch = engine->crosses( testFeature.geometry().constGet() );
-            break;
+          if ( engine->intersects( testFeature.geometry().constGet() ) )
+          {
+            disjointSet.remove( testFeature.id() );
+          }
+        }
+        else
+        {
+          isMatch = testPredicate( engine.get(), predicate, testFeature.geometry().constGet() );
         }
         if ( isMatch )
         {
@@ -201,6 +238,245 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
   }
 }
 
+void QgsLocationBasedAlgorithm::processByIndexingIntersectSource( const QgsProcessingContext &context, QgsFeatureSource *targetSource,
+    QgsFeatureSource *intersectSource,
+    const QList< Predicate > &predicates,
+    const std::function < void( const QgsFeature & ) > &handleFeatureFunction,
+    bool onlyRequireTargetIds,
+    QgsFeedback *feedback )
+{
+  // target features are streamed and prepared, so the predicates are tested the way the user wants them
+  QList< Predicate > targetPredicates;
+  for ( Predicate predicate : predicates )
+    targetPredicates << reversePredicate( predicate );
+  const bool testDisjoint = targetPredicates.contains( Disjoint );
+
+  QgsPackedRTree index;
+  QHash< QgsFeatureId, QgsGeometry > geometries;
+  QgsFeatureRequest request = QgsFeatureRequest().setSubsetOfAttributes( QgsAttributeList() ).setDestinationCrs( targetSource->sourceCrs(), context.transformContext() );
+  QgsFeatureIterator intersectIt = intersectSource->getFeatures( request );
+  QgsFeature f;
+  while ( intersectIt.nextFeature( f ) )
+  {
+    if ( feedback->isCanceled() )
+      return;
+
+    if ( !f.hasGeometry() )
+      continue;
+
+    index.add( f.id(), f.geometry().boundingBox() );
+    geometries.insert( f.id(), f.geometry() );
+  }
+  index.finish();
+
+  request = QgsFeatureRequest();
+  if ( onlyRequireTargetIds )
+    request.setSubsetOfAttributes( QgsAttributeList() );
+  QgsFeatureIterator targetIt = targetSource->getFeatures( request );
+
+  QVector< QgsLocationJoinJob > jobs( std::max( 1, QThread::idealThreadCount() ) );
+  QVector< QgsFeature > features;
+  QVector< bool > matches;
+  // jobs only read the shared index and geometries, and each one builds its own geometry
+  // engines, which use the GEOS context of the thread they run on
+  auto testFeatures = [&]( QgsLocationJoinJob & job )
+  {
+    for ( int i = job.begin; i < job.end; ++i )
+    {
+      const QgsFeature &feature = features.at( i );
+      if ( !feature.hasGeometry() )
+      {
+        matches[i] = testDisjoint;
+        continue;
+      }
+
+      const QList< QgsFeatureId > candidates = index.intersects( feature.geometry().boundingBox() );
+      std::unique_ptr< QgsGeometryEngine > engine;
+      bool isMatch = false;
+      bool intersectsAny = false;
+      for ( QgsFeatureId id : candidates )
+      {
+        if ( !engine )
+        {
+          engine.reset( QgsGeometry::createGeometryEngine( feature.geometry().constGet() ) );
+          if ( candidates.size() > 1 )
+            engine->prepareGeometry();
+        }
+
+        const QgsGeometry geometry = geometries.value( id );
+        for ( Predicate predicate : qgis::as_const( targetPredicates ) )
+        {
+          if ( predicate == Disjoint )
+          {
+            if ( !intersectsAny )
+              intersectsAny = engine->intersects( geometry.constGet() );
+          }
+          else if ( testPredicate( engine.get(), predicate, geometry.constGet() ) )
+          {
+            isMatch = true;
+            break;
+          }
+        }
+        if ( isMatch )
+          break;
+      }
+      matches[i] = isMatch || ( testDisjoint && !intersectsAny );
+    }
+  };
+
+  const long count = targetSource->featureCount();
+  double step = count > 0 ? 100.0 / count : 1;
+  int current = 0;
+  while ( !feedback->isCanceled() && targetIt.nextFeatures( features, INDEXED_JOIN_BLOCK_SIZE ) > 0 )
+  {
+    matches.fill( false, features.size() );
+    splitJobs( jobs, features.size() );
+    QtConcurrent::blockingMap( jobs, testFeatures );
+
+    for ( int i = 0; i < features.size(); ++i )
+    {
+      if ( matches.at( i ) )
+        handleFeatureFunction( features.at( i ) );
+    }
+
+    current += features.size();
+    feedback->setProgress( current * step );
+  }
+}
+
+void QgsLocationBasedAlgorithm::processByIndexingTargetSource( const QgsProcessingContext &context, QgsFeatureSource *targetSource,
+    QgsFeatureSource *intersectSource,
+    const QList< Predicate > &predicates,
+    const std::function < void( const QgsFeature & ) > &handleFeatureFunction,
+    bool onlyRequireTargetIds,
+    QgsFeedback *feedback )
+{
+  QgsPackedRTree index;
+  QHash< QgsFeatureId, QgsGeometry > geometries;
+  QgsFeatureIterator targetIt = targetSource->getFeatures( QgsFeatureRequest().setSubsetOfAttributes( QgsAttributeList() ) );
+  QgsFeature f;
+  while ( targetIt.nextFeature( f ) )
+  {
+    if ( feedback->isCanceled() )
+      return;
+
+    if ( !f.hasGeometry() )
+      continue;
+
+    index.add( f.id(), f.geometry().boundingBox() );
+    geometries.insert( f.id(), f.geometry() );
+  }
+  index.finish();
+
+  QgsFeatureRequest request = QgsFeatureRequest().setSubsetOfAttributes( QgsAttributeList() ).setDestinationCrs( targetSource->sourceCrs(), context.transformContext() );
+  QgsFeatureIterator intersectIt = intersectSource->getFeatures( request );
+
+  // each job keeps the target features it found over all blocks, which are merged at the end.
+  // As above, jobs build their own geometry engines, using the GEOS context of their thread
+  QVector< QgsLocationJoinJob > jobs( std::max( 1, QThread::idealThreadCount() ) );
+  QVector< QgsFeature > features;
+  auto testFeatures = [&]( QgsLocationJoinJob & job )
+  {
+    for ( int i = job.begin; i < job.end; ++i )
+    {
+      const QgsFeature &feature = features.at( i );
+      if ( !feature.hasGeometry() )
+        continue;
+
+      const QList< QgsFeatureId > candidates = index.intersects( feature.geometry().boundingBox() );
+      std::unique_ptr< QgsGeometryEngine > engine;
+      for ( QgsFeatureId id : candidates )
+      {
+        if ( job.found.contains( id ) )
+          continue;
+
+        if ( !engine )
+        {
+          engine.reset( QgsGeometry::createGeometryEngine( feature.geometry().constGet() ) );
+          if ( candidates.size() > 1 )
+            engine->prepareGeometry();
+        }
+
+        const QgsGeometry geometry = geometries.value( id );
+        for ( Predicate predicate : predicates )
+        {
+          if ( predicate == Disjoint )
+          {
+            if ( !job.intersected.contains( id ) && engine->intersects( geometry.constGet() ) )
+              job.intersected.insert( id );
+          }
+          else if ( testPredicate( engine.get(), predicate, geometry.constGet() ) )
+          {
+            job.found.insert( id );
+            break;
+          }
+        }
+      }
+    }
+  };
+
+  const long count = intersectSource->featureCount();
+  double step = count > 0 ? 100.0 / count : 1;
+  int current = 0;
+  while ( !feedback->isCanceled() && intersectIt.nextFeatures( features, INDEXED_JOIN_BLOCK_SIZE ) > 0 )
+  {
+    splitJobs( jobs, features.size() );
+    QtConcurrent::blockingMap( jobs, testFeatures );
+
+    current += features.size();
+    feedback->setProgress( current * step );
+  }
+  if ( feedback->isCanceled() )
+    return;
+
+  QgsFeatureIds foundSet;
+  QgsFeatureIds intersectedSet;
+  for ( const QgsLocationJoinJob &job : qgis::as_const( jobs ) )
+  {
+    foundSet.unite( job.found );
+    intersectedSet.unite( job.intersected );
+  }
+  if ( predicates.contains( Disjoint ) )
+  {
+    QgsFeatureIds disjointSet = targetSource->allFeatureIds();
+    disjointSet.subtract( intersectedSet );
+    foundSet.unite( disjointSet );
+  }
+
+  request = QgsFeatureRequest().setFilterFids( foundSet );
+  if ( onlyRequireTargetIds )
+    request.setSubsetOfAttributes( QgsAttributeList() ).setFlags( QgsFeatureRequest::NoGeometry );
+  QgsFeatureIterator foundIt = targetSource->getFeatures( request );
+  while ( foundIt.nextFeature( f ) )
+  {
+    handleFeatureFunction( f );
+  }
+}
+
+bool QgsLocationBasedAlgorithm::testPredicate( QgsGeometryEngine *engine, Predicate predicate, const QgsAbstractGeometry *geometry )
+{
+  switch ( predicate )
+  {
+    case Intersects:
+      return engine->intersects( geometry );
+    case Contains:
+      return engine->contains( geometry );
+    case IsEqual:
+      return engine->isEqual( geometry );
+    case Touches:
+      return engine->touches( geometry );
+    case Overlaps:
+      return engine->overlaps( geometry );
+    case Within:
+      return engine->within( geometry );
+    case Crosses:
+      return engine->crosses( geometry );
+    case Disjoint:
+      break;
+  }
+  return false;
+}
+
 
 //
 // QgsSelectByLocationAlgorithm
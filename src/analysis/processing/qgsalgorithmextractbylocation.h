@@ -23,6 +23,8 @@
 #include "qgis.h"
 #include "qgsprocessingalgorithm.h"
 
+class QgsGeometryEngine;
+
 ///@cond PRIVATE
 
 
@@ -50,6 +52,28 @@ class QgsLocationBasedAlgorithm : public QgsProcessingAlgorithm
     Predicate reversePredicate( Predicate predicate ) const;
     QStringList predicateOptionsList() const;
     void process( const QgsProcessingContext &context, QgsFeatureSource *targetSource, QgsFeatureSource *intersectSource, const QList<int> &selectedPredicates, const std::function< void( const QgsFeature & )> &handleFeatureFunction, bool onlyRequireTargetIds, QgsFeedback *feedback );
+
+  private:
+
+    /**
+     * Tests each intersect feature against the target features found by a request on its
+     * bounding box. Used when there are few intersect features, or when the layers are
+     * too large to be indexed in memory.
+     */
+    void processByRequests( const QgsProcessingContext &context, QgsFeatureSource *targetSource, QgsFeatureSource *intersectSource, const QList< Predicate > &predicates, const std::function< void( const QgsFeature & )> &handleFeatureFunction, bool onlyRequireTargetIds, QgsFeedback *feedback );
+
+    /**
+     * Indexes the intersect features in memory, and streams the target features once.
+     */
+    void processByIndexingIntersectSource( const QgsProcessingContext &context, QgsFeatureSource *targetSource, QgsFeatureSource *intersectSource, const QList< Predicate > &predicates, const std::function< void( const QgsFeature & )> &handleFeatureFunction, bool onlyRequireTargetIds, QgsFeedback *feedback );
+
+    /**
+     * Indexes the target features in memory, and streams the intersect features once.
+     */
+    void processByIndexingTargetSource( const QgsProcessingContext &context, QgsFeatureSource *targetSource, QgsFeatureSource *intersectSource, const QList< Predicate > &predicates, const std::function< void( const QgsFeature & )> &handleFeatureFunction, bool onlyRequireTargetIds, QgsFeedback *feedback );
+
+    //! Returns true if the geometry of \a engine matches \a predicate with \a geometry. Disjoint is not handled.
+    static bool testPredicate( QgsGeometryEngine *engine, Predicate predicate, const QgsAbstractGeometry *geometry );
 };
 
 
@@ -46,6 +46,7 @@ class QgsMultipartToSinglepartAlgorithm : public QgsProcessingFeatureBasedAlgori
 
   protected:
 
+    bool supportsParallelProcessing() const override { return true; }
     QgsFeatureList processFeature( const QgsFeature &feature,
                                    QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
 
@@ -0,0 +1,92 @@
+/***************************************************************************
+                         qgscascadedunion.cpp
+                         --------------------
+    begin                : December 2017
+    copyright            : (C) 2017 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgscascadedunion.h"
+#include "qgsfeedback.h"
+#include "qgspackedrtree.h"
+
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+
+//! Number of input geometries united together in the first level of the cascade
+static const int PARTITION_SIZE = 500;
+
+//! Number of partial results united together in the next levels of the cascade
+static const int MERGE_GROUP_SIZE = 4;
+
+///@cond PRIVATE
+struct QgsUnionJob
+{
+  QVector< QgsGeometry > geometries;
+  QgsGeometry result;
+};
+///@endcond
+
+QgsGeometry QgsCascadedUnion::unaryUnion( const QVector< QgsGeometry > &geometries, QgsFeedback *feedback )
+{
+  if ( geometries.size() < 2 * PARTITION_SIZE || QThreadPool::globalInstance()->maxThreadCount() < 2 )
+    return QgsGeometry::unaryUnion( geometries );
+
+  // the packed tree already sorts its entries along a Hilbert curve
+  QgsPackedRTree tree;
+  for ( int i = 0; i < geometries.size(); ++i )
+  {
+    if ( !geometries.at( i ).isNull() )
+      tree.add( i, geometries.at( i ).boundingBox() );
+  }
+  tree.finish();
+
+  QVector< QgsUnionJob > jobs;
+  for ( int i = 0; i < tree.count(); i += PARTITION_SIZE )
+  {
+    QgsUnionJob job;
+    const int end = std::min( i + PARTITION_SIZE, tree.count() );
+    job.geometries.reserve( end - i );
+    for ( int j = i; j < end; ++j )
+      job.geometries << geometries.at( static_cast< int >( tree.entryId( j ) ) );
+    jobs << job;
+  }
+
+  auto uniteJob = [feedback]( QgsUnionJob & job )
+  {
+    if ( !feedback || !feedback->isCanceled() )
+      job.result = QgsGeometry::unaryUnion( job.geometries );
+    job.geometries.clear();
+  };
+
+  // partial results stay in the order of the curve, so neighbouring results are united together
+  while ( jobs.size() > 1 )
+  {
+    QtConcurrent::blockingMap( jobs, uniteJob );
+    if ( feedback && feedback->isCanceled() )
+      return QgsGeometry();
+
+    QVector< QgsUnionJob > nextJobs;
+    for ( int i = 0; i < jobs.size(); i += MERGE_GROUP_SIZE )
+    {
+      QgsUnionJob job;
+      for ( int j = i; j < std::min( i + MERGE_GROUP_SIZE, jobs.size() ); ++j )
+        job.geometries << jobs.at( j ).result;
+      nextJobs << job;
+    }
+    jobs = nextJobs;
+  }
+
+  return QgsGeometry::unaryUnion( jobs.value( 0 ).geometries );
+}
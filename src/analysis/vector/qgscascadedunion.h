@@ -0,0 +1,57 @@
+/***************************************************************************
+                         qgscascadedunion.h
+                         ------------------
+    begin                : December 2017
+    copyright            : (C) 2017 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSCASCADEDUNION_H
+#define QGSCASCADEDUNION_H
+
+#define SIP_NO_FILE
+
+#include "qgis_analysis.h"
+#include "qgsgeometry.h"
+
+#include <QVector>
+
+class QgsFeedback;
+
+/**
+ * \ingroup analysis
+ * Unites large sets of geometries on all the available cores.
+ *
+ * Geometries are first sorted along a Hilbert curve, so that neighbouring geometries
+ * end up in the same partition. Partitions are united on separate threads, then groups
+ * of neighbouring partial results are united level by level until a single geometry is
+ * left. Small sets of geometries, or any set when the global thread pool is limited to
+ * a single thread, are directly passed to QgsGeometry::unaryUnion().
+ *
+ * unaryUnion() may be called from several threads at once.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.0
+ */
+class ANALYSIS_EXPORT QgsCascadedUnion
+{
+  public:
+
+    /**
+     * Unites all the \a geometries, as QgsGeometry::unaryUnion() does. The optional
+     * \a feedback is only used to cancel the union, in which case a null geometry is returned.
+     */
+    static QgsGeometry unaryUnion( const QVector< QgsGeometry > &geometries, QgsFeedback *feedback = nullptr );
+
+};
+
+#endif // QGSCASCADEDUNION_H
@@ -257,7 +257,6 @@ void QgsFieldCalculator::accept()
     }
 
     //go through all the features and change the new attribute
-    QgsFeature feature;
     bool calculationSuccess = true;
     QString error;
 
@@ -277,33 +276,42 @@ void QgsFieldCalculator::accept()
       req.setFilterFids( mVectorLayer->selectedFeatureIds() );
     }
     QgsFeatureIterator fit = mVectorLayer->getFeatures( req );
-    while ( fit.nextFeature( feature ) )
+
+    // expressions which do not depend on the row number are evaluated for blocks of features at once
+    const int blockSize = exp.referencedVariables().contains( QStringLiteral( "row_number" ) ) ? 1 : 1000;
+    QVector<QgsFeature> features;
+    QVector<QVariant> values;
+    while ( fit.nextFeatures( features, blockSize ) > 0 )
     {
-      expContext.setFeature( feature );
       expContext.lastScope()->addVariable( QgsExpressionContextScope::StaticVariable( QStringLiteral( "row_number" ), rownum, true ) );
-
-      QVariant value = exp.evaluate( &expContext );
+      values = exp.evaluate( features, &expContext );
       if ( exp.hasEvalError() )
       {
         calculationSuccess = false;
         error = exp.evalErrorString();
         break;
       }
-      else if ( updatingGeom )
+
+      for ( int i = 0; i < features.count(); ++i )
       {
-        if ( value.canConvert< QgsGeometry >() )
+        const QgsFeature &feature = features.at( i );
+        QVariant value = values.at( i );
+        if ( updatingGeom )
         {
-          QgsGeometry geom = value.value< QgsGeometry >();
-          mVectorLayer->changeGeometry( feature.id(), geom );
+          if ( value.canConvert< QgsGeometry >() )
+          {
+            QgsGeometry geom = value.value< QgsGeometry >();
+            mVectorLayer->changeGeometry( feature.id(), geom );
+          }
+        }
+        else
+        {
+          ( void )field.convertCompatible( value );
+          mVectorLayer->changeAttributeValue( feature.id(), mAttributeId, value, newField ? emptyAttribute : feature.attributes().value( mAttributeId ) );
         }
-      }
-      else
-      {
-        ( void )field.convertCompatible( value );
-        mVectorLayer->changeAttributeValue( feature.id(), mAttributeId, value, newField ? emptyAttribute : feature.attributes().value( mAttributeId ) );
-      }
 
-      rownum++;
+        rownum++;
+      }
     }
 
     QApplication::restoreOverrideCursor();
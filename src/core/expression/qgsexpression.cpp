@@ -374,6 +374,18 @@ QVariant QgsExpression::evaluate( const QgsExpressionContext *context )
   return d->mRootNode->eval( this, context );
 }
 
+QVector<QVariant> QgsExpression::evaluate( const QVector<QgsFeature> &features, QgsExpressionContext *context )
+{
+  d->mEvalErrorString = QString();
+  if ( !d->mRootNode )
+  {
+    d->mEvalErrorString = tr( "No root node! Parsing failed?" );
+    return QVector<QVariant>( features.count() );
+  }
+
+  return d->mRootNode->eval( this, context, features );
+}
+
 bool QgsExpression::hasEvalError() const
 {
   return !d->mEvalErrorString.isNull();
@@ -21,6 +21,7 @@
 #include <QStringList>
 #include <QVariant>
 #include <QList>
+#include <QVector>
 #include <QDomDocument>
 #include <QCoreApplication>
 #include <QSet>
@@ -231,6 +232,20 @@ class CORE_EXPORT QgsExpression
      */
     QVariant evaluate( const QgsExpressionContext *context );
 
+    /**
+     * Evaluate the expression for each feature of \a features and return the results, in
+     * the same order. The feature of \a context is set to the evaluated features in turn.
+     * Arithmetic, comparisons and logical operators on numeric fields of a prepared
+     * expression are evaluated for the whole list at once.
+     * hasEvalError() reports the first error raised by any of the features.
+     * \param features features to evaluate the expression for
+     * \param context context for evaluating expression
+     * \note prepare() should be called before calling this method.
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    QVector<QVariant> evaluate( const QVector<QgsFeature> &features, QgsExpressionContext *context ) SIP_SKIP;
+
     //! Returns true if an error occurred when evaluating last input
     bool hasEvalError() const;
     //! Returns evaluation error
@@ -79,6 +79,18 @@ QVariant QgsExpressionFunction::run( QgsExpressionNode::NodeList *args, const Qg
     }
   }
 
+  if ( context && !lazyEval() && isCacheable() )
+  {
+    QVariant result;
+    if ( context->cachedFunctionResult( mName, argValues, result ) )
+      return result;
+
+    result = func( argValues, context, parent, node );
+    if ( !parent->hasEvalError() )
+      context->setCachedFunctionResult( mName, argValues, result );
+    return result;
+  }
+
   return func( argValues, context, parent, node );
 }
 
@@ -120,6 +132,11 @@ bool QgsExpressionFunction::isDeprecated() const
   return mGroups.isEmpty() ? false : mGroups.contains( QStringLiteral( "deprecated" ) );
 }
 
+bool QgsExpressionFunction::isCacheable() const
+{
+  return false;
+}
+
 bool QgsExpressionFunction::operator==( const QgsExpressionFunction &other ) const
 {
   return ( QString::compare( mName, other.mName, Qt::CaseInsensitive ) == 0 );
@@ -196,6 +213,16 @@ void QgsStaticExpressionFunction::setIsStatic( bool isStatic )
   mIsStatic = isStatic;
 }
 
+bool QgsStaticExpressionFunction::isCacheable() const
+{
+  return mIsCacheable;
+}
+
+void QgsStaticExpressionFunction::setIsCacheable( bool cacheable )
+{
+  mIsCacheable = cacheable;
+}
+
 void QgsStaticExpressionFunction::setPrepareFunction( const std::function<bool ( const QgsExpressionNodeFunction *, QgsExpression *, const QgsExpressionContext * )> &prepareFunc )
 {
   mPrepareFunc = prepareFunc;
@@ -4193,15 +4220,25 @@ const QList<QgsExpressionFunction *> &QgsExpression::Functions()
         << new QgsStaticExpressionFunction( QStringLiteral( "y_max" ), 1, fcnYMax, QStringLiteral( "GeometryGroup" ), QString(), false, QSet<QString>(), false, QStringList() << QStringLiteral( "ymax" ) )
         << new QgsStaticExpressionFunction( QStringLiteral( "geom_from_wkt" ), 1, fcnGeomFromWKT, QStringLiteral( "GeometryGroup" ), QString(), false, QSet<QString>(), false, QStringList() << QStringLiteral( "geomFromWKT" ) )
         << new QgsStaticExpressionFunction( QStringLiteral( "geom_from_gml" ), 1, fcnGeomFromGML, QStringLiteral( "GeometryGroup" ), QString(), false, QSet<QString>(), false, QStringList() << QStringLiteral( "geomFromGML" ) )
+        << new QgsStaticExpressionFunction( QStringLiteral( "intersects_bbox" ), 2, fcnBbox, QStringLiteral( "GeometryGroup" ), QString(), false, QSet<QString>(), false, QStringList() << QStringLiteral( "bbox" ) );
+
+    // geometry predicates are costly, their results are cached for the evaluated feature
+    const QList< QgsStaticExpressionFunction * > predicateFunctions = QList< QgsStaticExpressionFunction * >()
         << new QgsStaticExpressionFunction( QStringLiteral( "relate" ), -1, fcnRelate, QStringLiteral( "GeometryGroup" ) )
-        << new QgsStaticExpressionFunction( QStringLiteral( "intersects_bbox" ), 2, fcnBbox, QStringLiteral( "GeometryGroup" ), QString(), false, QSet<QString>(), false, QStringList() << QStringLiteral( "bbox" ) )
         << new QgsStaticExpressionFunction( QStringLiteral( "disjoint" ), 2, fcnDisjoint, QStringLiteral( "GeometryGroup" ) )
         << new QgsStaticExpressionFunction( QStringLiteral( "intersects" ), 2, fcnIntersects, QStringLiteral( "GeometryGroup" ) )
         << new QgsStaticExpressionFunction( QStringLiteral( "touches" ), 2, fcnTouches, QStringLiteral( "GeometryGroup" ) )
         << new QgsStaticExpressionFunction( QStringLiteral( "crosses" ), 2, fcnCrosses, QStringLiteral( "GeometryGroup" ) )
         << new QgsStaticExpressionFunction( QStringLiteral( "contains" ), 2, fcnContains, QStringLiteral( "GeometryGroup" ) )
         << new QgsStaticExpressionFunction( QStringLiteral( "overlaps" ), 2, fcnOverlaps, QStringLiteral( "GeometryGroup" ) )
-        << new QgsStaticExpressionFunction( QStringLiteral( "within" ), 2, fcnWithin, QStringLiteral( "GeometryGroup" ) )
+        << new QgsStaticExpressionFunction( QStringLiteral( "within" ), 2, fcnWithin, QStringLiteral( "GeometryGroup" ) );
+    for ( QgsStaticExpressionFunction *predicate : predicateFunctions )
+    {
+      predicate->setIsCacheable( true );
+      sFunctions << predicate;
+    }
+
+    sFunctions
         << new QgsStaticExpressionFunction( QStringLiteral( "translate" ), 3, fcnTranslate, QStringLiteral( "GeometryGroup" ) )
         << new QgsStaticExpressionFunction( QStringLiteral( "buffer" ), -1, fcnBuffer, QStringLiteral( "GeometryGroup" ) )
         << new QgsStaticExpressionFunction( QStringLiteral( "offset_curve" ), QgsExpressionFunction::ParameterList() << QgsExpressionFunction::Parameter( QStringLiteral( "geometry" ) )
@@ -263,6 +263,15 @@ class CORE_EXPORT QgsExpressionFunction
      */
     virtual bool isDeprecated() const;
 
+    /**
+     * Returns true if the results of the function only depend on its arguments, and are costly
+     * enough to be worth caching. Results of such functions are cached by the expression context
+     * for the feature being evaluated, so that the same call made by several expressions for a
+     * feature (e.g. by several symbol layers and labels) only runs once.
+     * \since QGIS 3.0
+     */
+    virtual bool isCacheable() const;
+
     /**
      * Returns the first group which the function belongs to.
      * \note consider using groups() instead, as some functions naturally belong in multiple groups
@@ -453,6 +462,17 @@ class QgsStaticExpressionFunction : public QgsExpressionFunction
      */
     void setIsStatic( bool isStatic );
 
+    bool isCacheable() const override;
+
+    /**
+     * Tag this function as cacheable. Results of cacheable functions are cached per feature
+     * and per argument values by the expression context.
+     *
+     * \see isCacheable()
+     * \since QGIS 3.0
+     */
+    void setIsCacheable( bool cacheable );
+
     /**
      * Set a function that will be called in the prepare step to determine if the function is
      * static or not.
@@ -473,6 +493,7 @@ class QgsStaticExpressionFunction : public QgsExpressionFunction
     std::function < bool( const QgsExpressionNodeFunction *node,  QgsExpression *parent, const QgsExpressionContext *context ) > mPrepareFunc;
     QSet<QString> mReferencedColumns;
     bool mIsStatic = false;
+    bool mIsCacheable = false;
 };
 
 /**
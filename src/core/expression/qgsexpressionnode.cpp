@@ -15,6 +15,9 @@
 
 #include "qgsexpressionnode.h"
 #include "qgsexpression.h"
+#include "qgsexpressionprogram.h"
+#include "qgsexpressioncontext.h"
+#include "qgsfeature.h"
 
 
 QVariant QgsExpressionNode::eval( QgsExpression *parent, const QgsExpressionContext *context )
@@ -25,11 +28,51 @@ QVariant QgsExpressionNode::eval( QgsExpression *parent, const QgsExpressionCont
   }
   else
   {
-    QVariant res = evalNode( parent, context );
+    QVariant res;
+    if ( mProgram && mProgram->run( parent, context, res ) )
+      return res;
+
+    res = evalNode( parent, context );
     return res;
   }
 }
 
+QVector<QVariant> QgsExpressionNode::eval( QgsExpression *parent, QgsExpressionContext *context, const QVector<QgsFeature> &features )
+{
+  const int count = features.count();
+  QVector<QVariant> results;
+  if ( mHasCachedValue )
+  {
+    results.fill( mCachedStaticValue, count );
+    return results;
+  }
+
+  QVector<bool> handled;
+  if ( !mProgram || !mProgram->run( parent, context, features, results, handled ) )
+  {
+    results.resize( count );
+    handled.fill( false, count );
+  }
+
+  // errors are raised per feature, keep the first one
+  QString error = parent->evalErrorString();
+  for ( int i = 0; i < count; ++i )
+  {
+    if ( handled.at( i ) )
+      continue;
+
+    parent->setEvalErrorString( QString() );
+    if ( context )
+      context->setFeature( features.at( i ) );
+    results[i] = eval( parent, context );
+    if ( error.isNull() && parent->hasEvalError() )
+      error = parent->evalErrorString();
+  }
+  parent->setEvalErrorString( error );
+
+  return results;
+}
+
 bool QgsExpressionNode::prepare( QgsExpression *parent, const QgsExpressionContext *context )
 {
   if ( isStatic( parent, context ) )
@@ -39,12 +82,21 @@ bool QgsExpressionNode::prepare( QgsExpression *parent, const QgsExpressionConte
       mHasCachedValue = true;
     else
       mHasCachedValue = false;
+    mProgram.reset();
     return true;
   }
   else
   {
     mHasCachedValue = false;
-    return prepareNode( parent, context );
+    if ( !prepareNode( parent, context ) )
+    {
+      mProgram.reset();
+      return false;
+    }
+
+    // numeric operators are compiled once prepared, so that column indexes are resolved
+    mProgram = QgsExpressionProgram::compile( this );
+    return true;
   }
 }
 
@@ -19,12 +19,16 @@
 
 #include <QSet>
 #include <QVariant>
+#include <QVector>
 #include <QCoreApplication>
+#include <memory>
 
 #include "qgis.h"
 
 class QgsExpression;
 class QgsExpressionContext;
+class QgsExpressionProgram;
+class QgsFeature;
 
 /**
  * \ingroup core
@@ -191,6 +195,16 @@ class CORE_EXPORT QgsExpressionNode SIP_ABSTRACT
      */
     QVariant eval( QgsExpression *parent, const QgsExpressionContext *context );
 
+    /**
+     * Evaluate this node for each feature of \a features with the given context and parent.
+     * Compiled nodes run over the whole list at once, the feature of \a context is only
+     * set to the features which still need to be evaluated one by one.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    QVector<QVariant> eval( QgsExpression *parent, QgsExpressionContext *context, const QVector<QgsFeature> &features ) SIP_SKIP;
+
     /**
      * Generate a clone of this node.
      * Ownership is transferred to the caller.
@@ -278,6 +292,11 @@ class CORE_EXPORT QgsExpressionNode SIP_ABSTRACT
 
     bool mHasCachedValue = false;
     QVariant mCachedStaticValue;
+
+    //! Compiled form of this node, used by eval() when set
+    std::shared_ptr< const QgsExpressionProgram > mProgram;
+
+    friend class QgsExpressionProgram;
 };
 
 Q_DECLARE_METATYPE( QgsExpressionNode * )
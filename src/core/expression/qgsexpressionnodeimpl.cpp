@@ -16,6 +16,7 @@
 #include "qgsexpressionnodeimpl.h"
 #include "qgsexpressionutils.h"
 #include "qgsexpression.h"
+#include "qgsexpressioncontext.h"
 
 #include "qgsgeometry.h"
 #include "qgsfeaturerequest.h"
@@ -843,6 +844,14 @@ bool QgsExpressionNodeInOperator::isStatic( QgsExpression *parent, const QgsExpr
 
 QVariant QgsExpressionNodeFunction::evalNode( QgsExpression *parent, const QgsExpressionContext *context )
 {
+  if ( mVariableLookup && context )
+  {
+    // @variable references reuse the variable position resolved for the current scopes
+    const QVariant value = context->variable( *mVariableLookup );
+    if ( !mVariableLookup->isVarFunctionOverridden() )
+      return value;
+  }
+
   QString name = QgsExpression::QgsExpression::Functions()[mFnIndex]->name();
   QgsExpressionFunction *fd = context && context->hasFunction( name ) ? context->function( name ) : QgsExpression::QgsExpression::Functions()[mFnIndex];
 
@@ -896,6 +905,7 @@ QgsExpressionNodeFunction::QgsExpressionNodeFunction( int fnIndex, QgsExpression
 QgsExpressionNodeFunction::~QgsExpressionNodeFunction()
 {
   delete mArgs;
+  delete mVariableLookup;
 }
 
 QgsExpressionNode::NodeType QgsExpressionNodeFunction::nodeType() const
@@ -916,6 +926,16 @@ bool QgsExpressionNodeFunction::prepareNode( QgsExpression *parent, const QgsExp
       res = res && n->prepare( parent, context );
     }
   }
+
+  delete mVariableLookup;
+  mVariableLookup = nullptr;
+  if ( fd->name() == QLatin1String( "var" ) && mArgs && mArgs->count() == 1 )
+  {
+    // variables named by a literal are resolved once and then read without hashing their name
+    const QgsExpressionNodeLiteral *var = dynamic_cast<const QgsExpressionNodeLiteral *>( mArgs->list().at( 0 ) );
+    if ( var && var->value().type() == QVariant::String && !var->value().isNull() )
+      mVariableLookup = new QgsExpressionContextVariableLookup( var->value().toString() );
+  }
   return res;
 }
 
@@ -20,6 +20,8 @@
 #include "qgsexpressionnode.h"
 #include "qgsinterval.h"
 
+class QgsExpressionContextVariableLookup;
+
 /**
  * \ingroup core
  * A unary node is either negative as in boolean (not) or as in numbers (minus).
@@ -246,6 +248,9 @@ class CORE_EXPORT QgsExpressionNodeFunction : public QgsExpressionNode
   private:
     int mFnIndex;
     NodeList *mArgs = nullptr;
+
+    //! Resolved variable for @variable references, set when prepared
+    QgsExpressionContextVariableLookup *mVariableLookup = nullptr;
 };
 
 /**
@@ -305,6 +310,8 @@ class CORE_EXPORT QgsExpressionNodeColumnRef : public QgsExpressionNode
   private:
     QString mName;
     int mIndex;
+
+    friend class QgsExpressionProgram;
 };
 
 /**
@@ -0,0 +1,568 @@
+/***************************************************************************
+                               qgsexpressionprogram.cpp
+                             -------------------
+    begin                : October 2017
+    copyright            : (C) 2017 by QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsexpressionprogram.h"
+#include "qgsexpression.h"
+#include "qgsexpressioncontext.h"
+#include "qgsexpressionnodeimpl.h"
+#include "qgsexpressionfunction.h"
+#include "qgsfeature.h"
+
+#include <algorithm>
+#include <cmath>
+
+///@cond PRIVATE
+
+std::shared_ptr< const QgsExpressionProgram > QgsExpressionProgram::compile( const QgsExpressionNode *node )
+{
+  switch ( node->nodeType() )
+  {
+    case QgsExpressionNode::ntUnaryOperator:
+    case QgsExpressionNode::ntBinaryOperator:
+    case QgsExpressionNode::ntFunction:
+      break;
+    default:
+      // compiling a single literal or column reference gains nothing
+      return nullptr;
+  }
+
+  std::shared_ptr< QgsExpressionProgram > program( new QgsExpressionProgram() );
+  if ( !program->compileNode( node, 0 ) )
+    return nullptr;
+
+  // comparisons and logical operators return the int values used for three-value logic,
+  // arithmetic on integers returns a long long
+  switch ( program->mInstructions.constLast().op )
+  {
+    case Not:
+    case Equal:
+    case NotEqual:
+    case LessThan:
+    case GreaterThan:
+    case LessOrEqual:
+    case GreaterOrEqual:
+    case And:
+    case Or:
+      program->mIntegerResultType = QVariant::Int;
+      break;
+    default:
+      program->mIntegerResultType = QVariant::LongLong;
+      break;
+  }
+  return program;
+}
+
+bool QgsExpressionProgram::pushConstant( const QVariant &value )
+{
+  Value v;
+  v.i = 0;
+  v.d = 0;
+  if ( value.isNull() )
+  {
+    v.type = Null;
+  }
+  else
+  {
+    switch ( value.type() )
+    {
+      case QVariant::Int:
+      case QVariant::UInt:
+      case QVariant::LongLong:
+      case QVariant::ULongLong:
+        v.type = Integer;
+        v.i = value.toLongLong();
+        v.d = v.i;
+        break;
+      case QVariant::Double:
+        v.type = Double;
+        v.d = value.toDouble();
+        break;
+      default:
+        return false;
+    }
+  }
+
+  mInstructions << Instruction { PushConstant, mConstants.count() };
+  mConstants << v;
+  return true;
+}
+
+bool QgsExpressionProgram::compileNode( const QgsExpressionNode *node, int depth )
+{
+  if ( depth >= MAX_STACK_DEPTH )
+    return false;
+  mStackDepth = std::max( mStackDepth, depth + 1 );
+
+  if ( node->mHasCachedValue )
+    return pushConstant( node->mCachedStaticValue );
+
+  switch ( node->nodeType() )
+  {
+    case QgsExpressionNode::ntLiteral:
+      return pushConstant( static_cast< const QgsExpressionNodeLiteral * >( node )->value() );
+
+    case QgsExpressionNode::ntColumnRef:
+    {
+      const QgsExpressionNodeColumnRef *column = static_cast< const QgsExpressionNodeColumnRef * >( node );
+      // only columns resolved while preparing can be read by index
+      if ( column->mIndex < 0 )
+        return false;
+      mInstructions << Instruction { PushAttribute, column->mIndex };
+      return true;
+    }
+
+    case QgsExpressionNode::ntUnaryOperator:
+    {
+      const QgsExpressionNodeUnaryOperator *unary = static_cast< const QgsExpressionNodeUnaryOperator * >( node );
+      if ( !compileNode( unary->operand(), depth ) )
+        return false;
+      mInstructions << Instruction { unary->op() == QgsExpressionNodeUnaryOperator::uoNot ? Not : Negate, 0 };
+      return true;
+    }
+
+    case QgsExpressionNode::ntBinaryOperator:
+    {
+      const QgsExpressionNodeBinaryOperator *binary = static_cast< const QgsExpressionNodeBinaryOperator * >( node );
+      OpCode op;
+      switch ( binary->op() )
+      {
+        case QgsExpressionNodeBinaryOperator::boPlus:
+          op = Add;
+          break;
+        case QgsExpressionNodeBinaryOperator::boMinus:
+          op = Subtract;
+          break;
+        case QgsExpressionNodeBinaryOperator::boMul:
+          op = Multiply;
+          break;
+        case QgsExpressionNodeBinaryOperator::boDiv:
+          op = Divide;
+          break;
+        case QgsExpressionNodeBinaryOperator::boMod:
+          op = Modulo;
+          break;
+        case QgsExpressionNodeBinaryOperator::boIntDiv:
+          op = IntDivide;
+          break;
+        case QgsExpressionNodeBinaryOperator::boPow:
+          op = Power;
+          break;
+        case QgsExpressionNodeBinaryOperator::boEQ:
+          op = Equal;
+          break;
+        case QgsExpressionNodeBinaryOperator::boNE:
+          op = NotEqual;
+          break;
+        case QgsExpressionNodeBinaryOperator::boLT:
+          op = LessThan;
+          break;
+        case QgsExpressionNodeBinaryOperator::boGT:
+          op = GreaterThan;
+          break;
+        case QgsExpressionNodeBinaryOperator::boLE:
+          op = LessOrEqual;
+          break;
+        case QgsExpressionNodeBinaryOperator::boGE:
+          op = GreaterOrEqual;
+          break;
+        case QgsExpressionNodeBinaryOperator::boAnd:
+          op = And;
+          break;
+        case QgsExpressionNodeBinaryOperator::boOr:
+          op = Or;
+          break;
+        default:
+          // string, pattern and IS operators stay on the tree
+          return false;
+      }
+
+      if ( !compileNode( binary->opLeft(), depth ) || !compileNode( binary->opRight(), depth + 1 ) )
+        return false;
+      mInstructions << Instruction { op, 0 };
+      return true;
+    }
+
+    case QgsExpressionNode::ntFunction:
+    {
+      const QgsExpressionNodeFunction *function = static_cast< const QgsExpressionNodeFunction * >( node );
+      const QString name = QgsExpression::Functions()[function->fnIndex()]->name();
+      OpCode op;
+      if ( name == QLatin1String( "abs" ) )
+        op = Abs;
+      else if ( name == QLatin1String( "sqrt" ) )
+        op = Sqrt;
+      else
+        return false;
+
+      if ( !function->args() || function->args()->count() != 1 || !compileNode( function->args()->at( 0 ), depth ) )
+        return false;
+      mInstructions << Instruction { op, 0 };
+      if ( !mFunctions.contains( name ) )
+        mFunctions << name;
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+bool QgsExpressionProgram::canRun( QgsExpression *parent, const QgsExpressionContext *context ) const
+{
+  // the tree returns NULL as soon as an error has been raised, let it do so
+  if ( parent && parent->hasEvalError() )
+    return false;
+
+  // functions registered in the context replace the built-in ones
+  if ( context )
+  {
+    for ( const QString &name : mFunctions )
+    {
+      if ( context->hasFunction( name ) )
+        return false;
+    }
+  }
+  return true;
+}
+
+bool QgsExpressionProgram::readAttribute( const QVariant &attribute, Value &value )
+{
+  if ( attribute.isNull() )
+  {
+    value.type = Null;
+    return true;
+  }
+
+  switch ( attribute.type() )
+  {
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+      value.type = Integer;
+      value.i = attribute.toLongLong();
+      value.d = value.i;
+      return true;
+    case QVariant::Double:
+      value.type = Double;
+      value.d = attribute.toDouble();
+      return true;
+    default:
+      // not a number, let the tree deal with it
+      return false;
+  }
+}
+
+bool QgsExpressionProgram::applyUnary( OpCode op, Value &value )
+{
+  switch ( op )
+  {
+    case Not:
+      if ( value.type != Null )
+      {
+        const bool truth = value.type == Integer ? value.i != 0 : !qgsDoubleNear( value.d, 0.0 );
+        value.type = Integer;
+        value.i = truth ? 0 : 1;
+        value.d = value.i;
+      }
+      return true;
+
+    case Negate:
+      // the tree negates NULL as an integer
+      if ( value.type == Null )
+        return false;
+      // non finite doubles raise conversion errors on the tree
+      if ( value.type == Double && !std::isfinite( value.d ) )
+        return false;
+      value.i = -value.i;
+      value.d = -value.d;
+      return true;
+
+    default:
+      // abs() and sqrt() return NULL for NULL arguments
+      if ( value.type == Null )
+        return true;
+      if ( !std::isfinite( value.d ) )
+        return false;
+      value.type = Double;
+      value.d = op == Abs ? std::fabs( value.d ) : std::sqrt( value.d );
+      return true;
+  }
+}
+
+bool QgsExpressionProgram::applyBinary( OpCode op, Value &left, const Value &right )
+{
+  if ( op == And || op == Or )
+  {
+    // three-value logic, NULL is unknown
+    const int tvlL = left.type == Null ? -1 : ( left.type == Integer ? left.i != 0 : !qgsDoubleNear( left.d, 0.0 ) );
+    const int tvlR = right.type == Null ? -1 : ( right.type == Integer ? right.i != 0 : !qgsDoubleNear( right.d, 0.0 ) );
+    int res;
+    if ( op == And )
+      res = tvlL == 0 || tvlR == 0 ? 0 : ( tvlL < 0 || tvlR < 0 ? -1 : 1 );
+    else
+      res = tvlL == 1 || tvlR == 1 ? 1 : ( tvlL < 0 || tvlR < 0 ? -1 : 0 );
+    left.type = res < 0 ? Null : Integer;
+    left.i = res;
+    left.d = res;
+    return true;
+  }
+
+  if ( left.type == Null || right.type == Null )
+  {
+    // NULL operands raise conversion errors on the tree for integer divisions
+    if ( op == IntDivide )
+      return false;
+    left.type = Null;
+    return true;
+  }
+
+  if ( ( op == Add || op == Subtract || op == Multiply || op == Modulo ) && left.type == Integer && right.type == Integer )
+  {
+    // both are integers - use integer arithmetics
+    if ( op == Modulo && right.i == 0 )
+    {
+      left.type = Null;
+      return true;
+    }
+    if ( op == Add )
+      left.i = left.i + right.i;
+    else if ( op == Subtract )
+      left.i = left.i - right.i;
+    else if ( op == Multiply )
+      left.i = left.i * right.i;
+    else
+      left.i = left.i % right.i;
+    left.d = left.i;
+    return true;
+  }
+
+  // non finite doubles raise conversion errors on the tree
+  if ( !std::isfinite( left.d ) || !std::isfinite( right.d ) )
+    return false;
+
+  switch ( op )
+  {
+    case Add:
+    case Subtract:
+    case Multiply:
+    case Divide:
+    case Modulo:
+      if ( ( op == Divide || op == Modulo ) && right.d == 0. )
+      {
+        left.type = Null;
+        return true;
+      }
+      left.type = Double;
+      if ( op == Add )
+        left.d = left.d + right.d;
+      else if ( op == Subtract )
+        left.d = left.d - right.d;
+      else if ( op == Multiply )
+        left.d = left.d * right.d;
+      else if ( op == Divide )
+        left.d = left.d / right.d;
+      else
+        left.d = std::fmod( left.d, right.d );
+      return true;
+
+    case IntDivide:
+      if ( right.d == 0. )
+      {
+        left.type = Null;
+        return true;
+      }
+      left.type = Integer;
+      left.i = qlonglong( std::floor( left.d / right.d ) );
+      left.d = left.i;
+      return true;
+
+    case Power:
+      left.type = Double;
+      left.d = std::pow( left.d, right.d );
+      return true;
+
+    default:
+    {
+      const double diff = left.d - right.d;
+      bool res;
+      switch ( op )
+      {
+        case Equal:
+          res = qgsDoubleNear( diff, 0.0 );
+          break;
+        case NotEqual:
+          res = !qgsDoubleNear( diff, 0.0 );
+          break;
+        case LessThan:
+          res = diff < 0;
+          break;
+        case GreaterThan:
+          res = diff > 0;
+          break;
+        case LessOrEqual:
+          res = diff <= 0;
+          break;
+        default:
+          res = diff >= 0;
+          break;
+      }
+      left.type = Integer;
+      left.i = res ? 1 : 0;
+      left.d = left.i;
+      return true;
+    }
+  }
+}
+
+QVariant QgsExpressionProgram::toVariant( const Value &value ) const
+{
+  switch ( value.type )
+  {
+    case Integer:
+      return mIntegerResultType == QVariant::Int ? QVariant( static_cast< int >( value.i ) ) : QVariant( value.i );
+    case Double:
+      return QVariant( value.d );
+    case Null:
+      break;
+  }
+  return QVariant();
+}
+
+bool QgsExpressionProgram::run( QgsExpression *parent, const QgsExpressionContext *context, QVariant &result ) const
+{
+  if ( !canRun( parent, context ) )
+    return false;
+
+  Value stack[MAX_STACK_DEPTH];
+  int top = -1;
+
+  QgsFeature feature;
+  bool hasFeature = false;
+
+  for ( const Instruction &instruction : mInstructions )
+  {
+    switch ( instruction.op )
+    {
+      case PushConstant:
+        stack[++top] = mConstants.at( instruction.arg );
+        break;
+
+      case PushAttribute:
+        if ( !hasFeature )
+        {
+          if ( !context || !context->hasFeature() )
+            return false;
+          feature = context->feature();
+          hasFeature = true;
+        }
+        if ( !readAttribute( feature.attribute( instruction.arg ), stack[++top] ) )
+          return false;
+        break;
+
+      case Negate:
+      case Not:
+      case Abs:
+      case Sqrt:
+        if ( !applyUnary( instruction.op, stack[top] ) )
+          return false;
+        break;
+
+      default:
+        --top;
+        if ( !applyBinary( instruction.op, stack[top], stack[top + 1] ) )
+          return false;
+        break;
+    }
+  }
+
+  result = toVariant( stack[top] );
+  return true;
+}
+
+bool QgsExpressionProgram::run( QgsExpression *parent, const QgsExpressionContext *context, const QVector<QgsFeature> &features,
+                                QVector<QVariant> &results, QVector<bool> &handled ) const
+{
+  if ( !canRun( parent, context ) )
+    return false;
+
+  const int count = features.count();
+  results.resize( count );
+  handled.fill( true, count );
+
+  // one column of values per stack slot, each instruction runs over all the features
+  std::vector< std::vector< Value > > stack( mStackDepth, std::vector< Value >( count ) );
+  int top = -1;
+
+  for ( const Instruction &instruction : mInstructions )
+  {
+    switch ( instruction.op )
+    {
+      case PushConstant:
+      {
+        std::vector< Value > &column = stack[++top];
+        std::fill( column.begin(), column.end(), mConstants.at( instruction.arg ) );
+        break;
+      }
+
+      case PushAttribute:
+      {
+        std::vector< Value > &column = stack[++top];
+        for ( int i = 0; i < count; ++i )
+        {
+          if ( handled.at( i ) && !readAttribute( features.at( i ).attribute( instruction.arg ), column[i] ) )
+            handled[i] = false;
+        }
+        break;
+      }
+
+      case Negate:
+      case Not:
+      case Abs:
+      case Sqrt:
+      {
+        std::vector< Value > &column = stack[top];
+        for ( int i = 0; i < count; ++i )
+        {
+          if ( handled.at( i ) && !applyUnary( instruction.op, column[i] ) )
+            handled[i] = false;
+        }
+        break;
+      }
+
+      default:
+      {
+        --top;
+        std::vector< Value > &left = stack[top];
+        const std::vector< Value > &right = stack[top + 1];
+        for ( int i = 0; i < count; ++i )
+        {
+          if ( handled.at( i ) && !applyBinary( instruction.op, left[i], right[i] ) )
+            handled[i] = false;
+        }
+        break;
+      }
+    }
+  }
+
+  const std::vector< Value > &column = stack[top];
+  for ( int i = 0; i < count; ++i )
+  {
+    if ( handled.at( i ) )
+      results[i] = toVariant( column[i] );
+  }
+  return true;
+}
+
+///@endcond
@@ -0,0 +1,155 @@
+/***************************************************************************
+                               qgsexpressionprogram.h
+                             -------------------
+    begin                : October 2017
+    copyright            : (C) 2017 by QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSEXPRESSIONPROGRAM_H
+#define QGSEXPRESSIONPROGRAM_H
+
+#define SIP_NO_FILE
+
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <memory>
+
+class QgsExpression;
+class QgsExpressionContext;
+class QgsExpressionNode;
+class QgsFeature;
+
+/// @cond PRIVATE
+
+/**
+ * \ingroup core
+ * Flat, typed instruction stream compiled from a prepared expression node.
+ *
+ * Only arithmetic, comparison and logical operators, abs() and sqrt() on numeric
+ * literals and numeric attributes are compiled. Values are kept unboxed on a small
+ * stack while the program runs, and only the final result is converted to a QVariant.
+ * A program can also run over a whole block of features at once, one instruction
+ * at a time for all features.
+ *
+ * Whenever the program meets a value it was not compiled for (e.g. a string
+ * stored in a numeric field) run() gives up and the caller falls back to
+ * walking the expression tree, so results are always identical to the tree.
+ *
+ * A program is never modified once compiled and may be shared between clones
+ * of the node it was compiled from.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.0
+ */
+class QgsExpressionProgram
+{
+  public:
+
+    /**
+     * Compiles the prepared \a node. Returns nullptr if the node, or one of its
+     * children, cannot be compiled.
+     */
+    static std::shared_ptr< const QgsExpressionProgram > compile( const QgsExpressionNode *node );
+
+    /**
+     * Runs the program for the feature of \a context and stores the result in \a result.
+     * Returns false if the program cannot handle the values found, in which case the
+     * node must be evaluated the usual way.
+     */
+    bool run( QgsExpression *parent, const QgsExpressionContext *context, QVariant &result ) const;
+
+    /**
+     * Runs the program for each feature of \a features and stores the results in \a results,
+     * which is resized to the number of features. \a handled is set to false for the features
+     * the program cannot handle, which must be evaluated the usual way.
+     * Returns false if the program cannot be used at all with \a context.
+     */
+    bool run( QgsExpression *parent, const QgsExpressionContext *context, const QVector<QgsFeature> &features,
+              QVector<QVariant> &results, QVector<bool> &handled ) const;
+
+  private:
+
+    enum OpCode
+    {
+      PushConstant, //!< Pushes constant number arg
+      PushAttribute, //!< Pushes the feature attribute at index arg
+      Negate,
+      Not,
+      Add,
+      Subtract,
+      Multiply,
+      Divide,
+      Modulo,
+      IntDivide,
+      Power,
+      Equal,
+      NotEqual,
+      LessThan,
+      GreaterThan,
+      LessOrEqual,
+      GreaterOrEqual,
+      And,
+      Or,
+      Abs,
+      Sqrt,
+    };
+
+    //! Type of a value on the stack
+    enum ValueType
+    {
+      Null,
+      Integer,
+      Double,
+    };
+
+    struct Value
+    {
+      ValueType type;
+      qlonglong i;
+      double d;
+    };
+
+    struct Instruction
+    {
+      OpCode op;
+      //! Constant or attribute index
+      int arg;
+    };
+
+    //! Maximum stack depth of a program, deeper expressions are not compiled
+    static const int MAX_STACK_DEPTH = 32;
+
+    QgsExpressionProgram() = default;
+
+    bool compileNode( const QgsExpressionNode *node, int depth );
+    bool pushConstant( const QVariant &value );
+
+    bool canRun( QgsExpression *parent, const QgsExpressionContext *context ) const;
+    QVariant toVariant( const Value &value ) const;
+
+    static bool readAttribute( const QVariant &attribute, Value &value );
+    static bool applyUnary( OpCode op, Value &value );
+    static bool applyBinary( OpCode op, Value &left, const Value &right );
+
+    QVector< Instruction > mInstructions;
+    QVector< Value > mConstants;
+    int mStackDepth = 0;
+
+    //! Names of the compiled functions, which contexts may override
+    QStringList mFunctions;
+
+    //! Type an integer result of the root instruction is boxed as
+    QVariant::Type mIntegerResultType = QVariant::LongLong;
+};
+
+/// @endcond
+
+#endif // QGSEXPRESSIONPROGRAM_H
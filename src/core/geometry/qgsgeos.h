@@ -318,6 +318,10 @@ class CORE_EXPORT QgsGeos: public QgsGeometryEngine
     static geos::unique_ptr asGeos( const QgsAbstractGeometry *geom, double precision = 0 );
     static QgsPoint coordSeqPoint( const GEOSCoordSequence *cs, int i, bool hasZ, bool hasM );
 
+    /**
+     * Returns the GEOS context handle of the calling thread. Handles must not be
+     * shared with other threads.
+     */
     static GEOSContextHandle_t getGEOSHandler();
 
 
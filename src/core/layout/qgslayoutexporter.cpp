@@ -220,7 +220,16 @@ void QgsLayoutExporter::renderRegion( QPainter *painter, const QRectF &region )
 
   painter->setRenderHint( QPainter::Antialiasing, mLayout->renderContext().flags() & QgsLayoutRenderContext::FlagAntialiasing );
 
+  // map items are painted one after another, so when painting to an image start rendering
+  // them all in background jobs which run concurrently on the global thread pool
+  QList< QgsLayoutItemMap * > prerenderedMaps;
+  if ( paintDevice->devType() == QInternal::Image )
+    prerenderedMaps = prerenderMaps( region, paintDevice->logicalDpiX() );
+
   mLayout->render( painter, QRectF( 0, 0, paintDevice->width(), paintDevice->height() ), region );
+
+  for ( QgsLayoutItemMap *map : qgis::as_const( prerenderedMaps ) )
+    map->clearExportPrerender();
 }
 
 QImage QgsLayoutExporter::renderRegionToImage( const QRectF &region, QSize imageSize, double dpi ) const
@@ -257,8 +266,10 @@ QImage QgsLayoutExporter::renderRegionToImage( const QRectF &region, QSize image
     image.setDotsPerMeterX( resolution / 25.4 * 1000 );
     image.setDotsPerMeterY( resolution / 25.4 * 1000 );
     image.fill( Qt::transparent );
+
     QPainter imagePainter( &image );
     renderRegion( &imagePainter, region );
+
     if ( !imagePainter.isActive() )
       return QImage();
   }
@@ -266,6 +277,25 @@ QImage QgsLayoutExporter::renderRegionToImage( const QRectF &region, QSize image
   return image;
 }
 
+QList< QgsLayoutItemMap * > QgsLayoutExporter::prerenderMaps( const QRectF &region, double dpi ) const
+{
+  QList< QgsLayoutItemMap * > prerenderedMaps;
+  if ( !( mLayout->renderContext().flags() & QgsLayoutRenderContext::FlagRenderMapsInParallel ) )
+    return prerenderedMaps;
+
+  QList< QgsLayoutItemMap * > maps;
+  mLayout->layoutItems( maps );
+  for ( QgsLayoutItemMap *map : qgis::as_const( maps ) )
+  {
+    if ( !map->isVisible() || !map->sceneBoundingRect().intersects( region ) )
+      continue;
+
+    map->startExportPrerender( dpi );
+    prerenderedMaps << map;
+  }
+  return prerenderedMaps;
+}
+
 ///@cond PRIVATE
 class LayoutContextSettingsRestorer
 {
@@ -470,6 +470,13 @@ class CORE_EXPORT QgsLayoutExporter
 
     QImage createImage( const ImageExportSettings &settings, int page, QRectF &bounds, bool &skipPage ) const;
 
+    /**
+     * Starts background rendering of the map items intersecting a layout \a region,
+     * for an export at the specified \a dpi, if the layout render context
+     * allows rendering maps in parallel. Returns the prerendered maps.
+     */
+    QList< QgsLayoutItemMap * > prerenderMaps( const QRectF &region, double dpi ) const;
+
     /**
      * Saves an image to a file, possibly using format specific options (e.g. LZW compression for tiff)
     */
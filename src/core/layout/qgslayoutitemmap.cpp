@@ -939,6 +939,31 @@ void QgsLayoutItemMap::setFrameStrokeWidth( const QgsLayoutMeasurement &width )
   updateBoundingRect();
 }
 
+void QgsLayoutItemMap::startExportPrerender( double dpi )
+{
+  clearExportPrerender();
+
+  if ( !mLayout || !shouldDrawItem() || containsAdvancedEffects() )
+    return;
+
+  QgsRectangle cExtent = extent();
+  QSizeF size( cExtent.width() * mapUnitsToLayoutUnits(), cExtent.height() * mapUnitsToLayoutUnits() );
+  size *= dpi / 25.4; // output size will be in dots (pixels)
+  if ( qgsDoubleNear( size.width(), 0.0 ) || qgsDoubleNear( size.height(), 0.0 ) )
+    return;
+
+  mExportPrerenderExtent = cExtent;
+  mExportPrerenderDpi = dpi;
+  mExportPrerenderJob.reset( new QgsMapRendererSequentialJob( mapSettings( cExtent, size, dpi, true ) ) );
+  mExportPrerenderJob->start();
+}
+
+void QgsLayoutItemMap::clearExportPrerender()
+{
+  // cancels the job if still active
+  mExportPrerenderJob.reset();
+}
+
 void QgsLayoutItemMap::drawMap( QPainter *painter, const QgsRectangle &extent, QSizeF size, double dpi )
 {
   if ( !painter )
@@ -951,6 +976,19 @@ void QgsLayoutItemMap::drawMap( QPainter *painter, const QgsRectangle &extent, Q
     return;
   }
 
+  if ( mExportPrerenderJob )
+  {
+    std::unique_ptr< QgsMapRendererSequentialJob > job = std::move( mExportPrerenderJob );
+    if ( qgsDoubleNear( dpi, mExportPrerenderDpi ) && extent == mExportPrerenderExtent
+         && job->mapSettings().outputSize() == size.toSize() )
+    {
+      // the map content was already rendered in background, use it
+      job->waitForFinished();
+      painter->drawImage( 0, 0, job->renderedImage() );
+      return;
+    }
+  }
+
   // render
   QgsMapRendererCustomPainterJob job( mapSettings( extent, size, dpi, true ), painter );
   // Render the map in this thread. This is done because of problems
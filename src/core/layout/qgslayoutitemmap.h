@@ -22,6 +22,7 @@
 #include "qgslayoutitemregistry.h"
 #include "qgsmaplayerref.h"
 #include "qgsmaprenderercustompainterjob.h"
+#include "qgsmaprenderersequentialjob.h"
 #include "qgslayoutitemmapgrid.h"
 #include "qgslayoutitemmapoverview.h"
 
@@ -417,6 +418,28 @@ class CORE_EXPORT QgsLayoutItemMap : public QgsLayoutItem
 
     void finalizeRestoreFromXml() override;
 
+    /**
+     * Starts rendering the map content in a background job, for a later export
+     * of the item on a paint device with the specified \a dpi. The next non-preview
+     * paint of the map at this resolution and extent will wait for the job and draw
+     * its result instead of rendering the map synchronously.
+     *
+     * This allows several map items to be rendered concurrently before a raster export.
+     * Maps requiring rasterization (e.g. for advanced effects) are not prerendered.
+     *
+     * \see clearExportPrerender()
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    void startExportPrerender( double dpi ) SIP_SKIP;
+
+    /**
+     * Cancels and discards any background rendering started by startExportPrerender().
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    void clearExportPrerender() SIP_SKIP;
+
   protected:
 
     void draw( QgsLayoutItemRenderContext &context ) override;
@@ -614,6 +637,13 @@ class CORE_EXPORT QgsLayoutItemMap : public QgsLayoutItem
     std::unique_ptr< QgsMapRendererCustomPainterJob > mPainterJob;
     bool mPainterCancelWait = false;
 
+    //! Background job rendering the map content before an export
+    std::unique_ptr< QgsMapRendererSequentialJob > mExportPrerenderJob;
+    //! Map extent of the export prerender job
+    QgsRectangle mExportPrerenderExtent;
+    //! Output dpi of the export prerender job
+    double mExportPrerenderDpi = 0;
+
     void init();
 
     //! Resets the item tooltip to reflect current map id
@@ -45,6 +45,7 @@ class CORE_EXPORT QgsLayoutRenderContext : public QObject
       FlagUseAdvancedEffects = 1 << 4, //!< Enable advanced effects such as blend modes.
       FlagForceVectorOutput = 1 << 5, //!< Force output in vector format where possible, even if items require rasterization to keep their correct appearance.
       FlagHideCoverageLayer = 1 << 6, //!< Hide coverage layer in outputs
+      FlagRenderMapsInParallel = 1 << 7, //!< Render map items concurrently in background jobs before raster exports
     };
     Q_DECLARE_FLAGS( Flags, Flag )
 
@@ -21,8 +21,18 @@
 #include "qgsprocessingutils.h"
 #include "qgsxmlutils.h"
 #include "qgsexception.h"
+#include "qgsmessagelog.h"
+#include "qgsprocessingdeferredfeedback.h"
 #include <QFile>
 #include <QTextStream>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+#include <exception>
+#include <vector>
 
 ///@cond NOT_STABLE
 
@@ -212,6 +222,95 @@ bool QgsProcessingModelAlgorithm::childOutputIsRequired( const QString &childId,
   return false;
 }
 
+/**
+ * Child algorithm, or chain of feature based child algorithms, run by a model.
+ */
+struct QgsProcessingModelChildJob
+{
+  //! Id of the child, or of the last child of the chain
+  QString childId;
+  QStringList chain;
+  QStringList descriptions;
+  QList< QVariantMap > parameters;
+
+  //! Prepared algorithms, only the first one is run
+  std::vector< std::unique_ptr< QgsProcessingAlgorithm > > algorithms;
+
+  //! Settings copied to the context of a child run in a worker thread
+  std::unique_ptr< QgsProcessingContext > settings;
+  //! Temporary layers of the model the child may read from a worker thread
+  QList< QgsMapLayer * > modelLayers;
+  //! Own context of a child run in a worker thread
+  std::unique_ptr< QgsProcessingContext > context;
+  //! Own feedback of a child run in a worker thread
+  std::unique_ptr< QgsProcessingDeferredFeedback > feedback;
+
+  QgsProcessingContext *runContext = nullptr;
+  QgsProcessingFeedback *runFeedback = nullptr;
+
+  QTime time;
+  QVariantMap results;
+  QString error;
+  bool ok = false;
+  QAtomicInt finished;
+};
+
+static void runChildJob( QgsProcessingModelChildJob &job )
+{
+  try
+  {
+    job.results = job.algorithms.front()->runPrepared( job.parameters.at( 0 ), *job.runContext, job.runFeedback );
+    job.ok = true;
+  }
+  catch ( QgsException &e )
+  {
+    job.error = e.what();
+  }
+  catch ( std::exception &e )
+  {
+    job.error = QObject::tr( "Error while running algorithm: %1" ).arg( QString::fromLocal8Bit( e.what() ) );
+  }
+  catch ( ... )
+  {
+    job.error = QObject::tr( "Unknown error while running algorithm" );
+  }
+}
+
+/**
+ * Hands a child job run in a worker thread back to the model thread when it goes out of
+ * scope, so that the model never waits forever on a child which failed in an unexpected way.
+ */
+class QgsProcessingModelChildJobFinisher
+{
+  public:
+
+    QgsProcessingModelChildJobFinisher( QgsProcessingModelChildJob &job, QThread *modelThread, QSemaphore &jobFinished )
+      : mJob( job )
+      , mModelThread( modelThread )
+      , mJobFinished( jobFinished )
+    {}
+
+    ~QgsProcessingModelChildJobFinisher()
+    {
+      if ( mJob.context )
+      {
+        mJob.context->temporaryLayerStore()->removeMapLayers( mJob.modelLayers );
+        mJob.context->pushToThread( mModelThread );
+      }
+      mJob.finished.storeRelease( 1 );
+      mJobFinished.release();
+    }
+
+    QgsProcessingModelChildJobFinisher( const QgsProcessingModelChildJobFinisher &other ) = delete;
+    QgsProcessingModelChildJobFinisher &operator=( const QgsProcessingModelChildJobFinisher &other ) = delete;
+
+  private:
+
+    QgsProcessingModelChildJob &mJob;
+    QThread *mModelThread = nullptr;
+    QSemaphore &mJobFinished;
+};
+
 QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   QSet< QString > toExecute;
@@ -228,25 +327,103 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
   QgsProcessingMultiStepFeedback modelFeedback( toExecute.count(), feedback );
   QgsExpressionContext baseContext = createExpressionContext( parameters, context );
 
+  // chains of feature based children are run in a single pass along with their last child
+  QMap< QString, QStringList > chains;
+  QSet< QString > chainedChildren;
+  for ( const QStringList &chain : featureBasedChains( toExecute ) )
+  {
+    chains.insert( chain.last(), chain );
+    for ( const QString &chainedId : chain )
+      chainedChildren.insert( chainedId );
+  }
+
+  // children from independent branches of the model run at the same time in worker threads
+  const int maximumThreads = context.maximumThreads() > 0 ? context.maximumThreads() : QThread::idealThreadCount();
+
   QVariantMap childResults;
   QVariantMap finalResults;
   QSet< QString > executed;
-  bool executedAlg = true;
-  while ( executedAlg && executed.count() < toExecute.count() )
+  QSet< QString > started;
+  std::vector< std::unique_ptr< QgsProcessingModelChildJob > > running;
+  QSemaphore jobFinished;
+  QThreadPool pool;
+  pool.setMaxThreadCount( std::max( 1, maximumThreads ) );
+
+  auto finishJob = [&]( QgsProcessingModelChildJob & job )
   {
-    executedAlg = false;
+    if ( job.ok )
+    {
+      const QVariantMap ppRes = job.algorithms.front()->postProcess( *job.runContext, job.runFeedback );
+      if ( !ppRes.isEmpty() )
+        job.results = ppRes;
+      if ( job.context )
+        context.takeResultsFrom( *job.context );
+    }
+    else if ( !job.error.isEmpty() )
+    {
+      QgsMessageLog::logMessage( job.error, QObject::tr( "Processing" ), Qgis::Critical );
+      job.runFeedback->reportError( job.error );
+    }
+    if ( job.feedback && feedback )
+      job.feedback->report( &modelFeedback );
+
+    if ( !job.ok )
+    {
+      QString error = QObject::tr( "Error encountered while running %1" ).arg( job.descriptions.join( QStringLiteral( ", " ) ) );
+      if ( feedback )
+        feedback->reportError( error );
+
+      for ( const std::unique_ptr< QgsProcessingModelChildJob > &runningJob : running )
+        runningJob->feedback->cancel();
+      pool.waitForDone();
+      throw QgsProcessingException( error );
+    }
+
+    for ( const QString &chainedId : qgis::as_const( job.chain ) )
+    {
+      // intermediate outputs of a chain are never materialized
+      const QVariantMap chainedResults = chainedId == job.childId ? job.results : QVariantMap();
+      childResults.insert( chainedId, chainedResults );
+
+      // look through child alg's outputs to determine whether any of these should be copied
+      // to the final model outputs
+      QMap<QString, QgsProcessingModelOutput> outputs = mChildAlgorithms[ chainedId ].modelOutputs();
+      QMap<QString, QgsProcessingModelOutput>::const_iterator outputIt = outputs.constBegin();
+      for ( ; outputIt != outputs.constEnd(); ++outputIt )
+      {
+        finalResults.insert( chainedId + ':' + outputIt->name(), chainedResults.value( outputIt->childOutputName() ) );
+      }
+
+      executed.insert( chainedId );
+    }
+    modelFeedback.setCurrentStep( executed.count() );
+    if ( feedback )
+      feedback->pushInfo( QObject::tr( "OK. Execution of %1 took %2 s (%3 outputs)." ).arg( job.descriptions.join( QStringLiteral( ", " ) ) ).arg( job.time.elapsed() / 1000.0 ).arg( job.results.count() ) );
+  };
+
+  while ( executed.count() < toExecute.count() )
+  {
+    if ( feedback && feedback->isCanceled() )
+      break;
+
+    bool startedAlg = false;
     Q_FOREACH ( const QString &childId, toExecute )
     {
       if ( feedback && feedback->isCanceled() )
         break;
 
-      if ( executed.contains( childId ) )
+      if ( started.contains( childId ) )
         continue;
 
+      if ( chainedChildren.contains( childId ) && !chains.contains( childId ) )
+        continue;
+
+      const QStringList chain = chains.value( childId, QStringList() << childId );
+
       bool canExecute = true;
       Q_FOREACH ( const QString &dependency, dependsOnChildAlgorithms( childId ) )
       {
-        if ( !executed.contains( dependency ) )
+        if ( !executed.contains( dependency ) && !chain.contains( dependency ) )
         {
           canExecute = false;
           break;
@@ -256,67 +433,145 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
       if ( !canExecute )
         continue;
 
-      executedAlg = true;
-      if ( feedback )
-        feedback->pushDebugInfo( QObject::tr( "Prepare algorithm: %1" ).arg( childId ) );
+      startedAlg = true;
 
-      const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ childId ];
+      std::unique_ptr< QgsProcessingModelChildJob > job = qgis::make_unique< QgsProcessingModelChildJob >();
+      job->childId = childId;
+      job->chain = chain;
+      bool canRunInThread = maximumThreads > 1;
+      for ( const QString &chainedId : chain )
+      {
+        if ( feedback )
+          feedback->pushDebugInfo( QObject::tr( "Prepare algorithm: %1" ).arg( chainedId ) );
 
-      QgsExpressionContext expContext = baseContext;
-      expContext << QgsExpressionContextUtils::processingAlgorithmScope( child.algorithm(), parameters, context )
-                 << createExpressionContextScopeForChildAlgorithm( childId, context, parameters, childResults );
+        const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ chainedId ];
 
-      QVariantMap childParams = parametersForChildAlgorithm( child, parameters, childResults, expContext );
-      if ( feedback )
-        feedback->setProgressText( QObject::tr( "Running %1 [%2/%3]" ).arg( child.description() ).arg( executed.count() + 1 ).arg( toExecute.count() ) );
+        QgsExpressionContext expContext = baseContext;
+        expContext << QgsExpressionContextUtils::processingAlgorithmScope( child.algorithm(), parameters, context )
+                   << createExpressionContextScopeForChildAlgorithm( chainedId, context, parameters, childResults );
+
+        QVariantMap childParams = parametersForChildAlgorithm( child, parameters, childResults, expContext );
+        if ( feedback )
+          feedback->setProgressText( QObject::tr( "Running %1 [%2/%3]" ).arg( child.description() ).arg( started.count() + job->descriptions.count() + 1 ).arg( toExecute.count() ) );
+
+        QStringList params;
+        for ( auto childParamIt = childParams.constBegin(); childParamIt != childParams.constEnd(); ++childParamIt )
+        {
+          params << QStringLiteral( "%1: %2" ).arg( childParamIt.key(),
+                 child.algorithm()->parameterDefinition( childParamIt.key() )->valueAsPythonString( childParamIt.value(), context ) );
+        }
+
+        if ( feedback )
+        {
+          feedback->pushInfo( QObject::tr( "Input Parameters:" ) );
+          feedback->pushCommandInfo( QStringLiteral( "{ %1 }" ).arg( params.join( QStringLiteral( ", " ) ) ) );
+        }
+
+        if ( child.algorithm()->flags() & QgsProcessingAlgorithm::FlagNoThreading )
+          canRunInThread = false;
 
-      QStringList params;
-      for ( auto childParamIt = childParams.constBegin(); childParamIt != childParams.constEnd(); ++childParamIt )
+        job->descriptions << child.description();
+        job->parameters << childParams;
+      }
+      for ( const QString &chainedId : chain )
+        started.insert( chainedId );
+
+      if ( feedback && chain.count() > 1 )
+        feedback->pushDebugInfo( QObject::tr( "Streaming features through %1" ).arg( chain.join( QStringLiteral( ", " ) ) ) );
+
+      job->time.start();
+      if ( !canRunInThread )
       {
-        params << QStringLiteral( "%1: %2" ).arg( childParamIt.key(),
-               child.algorithm()->parameterDefinition( childParamIt.key() )->valueAsPythonString( childParamIt.value(), context ) );
+        // run right away, in the model's thread and context
+        job->runContext = &context;
+        job->runFeedback = &modelFeedback;
+        job->algorithms = prepareChildAlgorithms( chain, job->parameters, context, &modelFeedback );
+        if ( !job->algorithms.empty() )
+          runChildJob( *job );
+        finishJob( *job );
+        continue;
       }
 
-      if ( feedback )
+      job->feedback = qgis::make_unique< QgsProcessingDeferredFeedback >();
+      job->runFeedback = job->feedback.get();
+      job->algorithms = prepareChildAlgorithms( chain, job->parameters, context, job->runFeedback );
+      if ( job->algorithms.empty() )
       {
-        feedback->pushInfo( QObject::tr( "Input Parameters:" ) );
-        feedback->pushCommandInfo( QStringLiteral( "{ %1 }" ).arg( params.join( QStringLiteral( ", " ) ) ) );
+        finishJob( *job );
+        continue;
       }
 
-      QTime childTime;
-      childTime.start();
+      // the child gets its own context in the worker thread, from which it can still read
+      // the temporary layers created by the children it depends on
+      job->settings = qgis::make_unique< QgsProcessingContext >();
+      job->settings->copyThreadSafeSettings( context );
+      job->settings->setFeedback( job->feedback.get() );
+      job->modelLayers = context.temporaryLayerStore()->mapLayers().values();
 
-      bool ok = false;
-      std::unique_ptr< QgsProcessingAlgorithm > childAlg( child.algorithm()->create( child.configuration() ) );
-      QVariantMap results = childAlg->run( childParams, context, &modelFeedback, &ok );
-      childAlg.reset( nullptr );
-      if ( !ok )
+      QgsProcessingModelChildJob *runningJob = job.get();
+      QThread *modelThread = context.thread();
+      QtConcurrent::run( &pool, [runningJob, modelThread, &jobFinished]
       {
-        QString error = QObject::tr( "Error encountered while running %1" ).arg( child.description() );
-        if ( feedback )
-          feedback->reportError( error );
-        throw QgsProcessingException( error );
-      }
-      childResults.insert( childId, results );
+        QgsProcessingModelChildJobFinisher finisher( *runningJob, modelThread, jobFinished );
+        try
+        {
+          runningJob->context = qgis::make_unique< QgsProcessingContext >();
+          runningJob->context->copyThreadSafeSettings( *runningJob->settings );
+          runningJob->context->temporaryLayerStore()->addMapLayers( runningJob->modelLayers, false );
+          runningJob->runContext = runningJob->context.get();
+        }
+        catch ( ... )
+        {
+          runningJob->error = QObject::tr( "Could not prepare the algorithm context" );
+          return;
+        }
 
-      // look through child alg's outputs to determine whether any of these should be copied
-      // to the final model outputs
-      QMap<QString, QgsProcessingModelOutput> outputs = child.modelOutputs();
-      QMap<QString, QgsProcessingModelOutput>::const_iterator outputIt = outputs.constBegin();
-      for ( ; outputIt != outputs.constEnd(); ++outputIt )
+        runChildJob( *runningJob );
+      } );
+      running.emplace_back( std::move( job ) );
+    }
+
+    if ( running.empty() )
+    {
+      if ( !startedAlg )
+        break;
+      continue;
+    }
+
+    // wait for a running child to finish, keeping the model progress up to date. Each running
+    // job counts for the fraction it completed of the children it runs
+    while ( !jobFinished.tryAcquire( 1, 100 ) )
+    {
+      double completedSteps = executed.count();
+      for ( const std::unique_ptr< QgsProcessingModelChildJob > &runningJob : running )
       {
-        finalResults.insert( childId + ':' + outputIt->name(), results.value( outputIt->childOutputName() ) );
+        if ( feedback && feedback->isCanceled() )
+          runningJob->feedback->cancel();
+        completedSteps += std::min( std::max( runningJob->feedback->progress(), 0.0 ), 100.0 ) / 100.0 * runningJob->chain.count();
       }
-
-      executed.insert( childId );
-      modelFeedback.setCurrentStep( executed.count() );
       if ( feedback )
-        feedback->pushInfo( QObject::tr( "OK. Execution took %1 s (%2 outputs)." ).arg( childTime.elapsed() / 1000.0 ).arg( results.count() ) );
+        feedback->setProgress( 100.0 * completedSteps / toExecute.count() );
     }
 
-    if ( feedback && feedback->isCanceled() )
-      break;
+    for ( auto jobIt = running.begin(); jobIt != running.end(); )
+    {
+      if ( !( *jobIt )->finished.loadAcquire() )
+      {
+        ++jobIt;
+        continue;
+      }
+
+      std::unique_ptr< QgsProcessingModelChildJob > job = std::move( *jobIt );
+      jobIt = running.erase( jobIt );
+      finishJob( *job );
+    }
   }
+
+  // canceled, wait for the children still running
+  for ( const std::unique_ptr< QgsProcessingModelChildJob > &runningJob : running )
+    runningJob->feedback->cancel();
+  pool.waitForDone();
+
   if ( feedback )
     feedback->pushDebugInfo( QObject::tr( "Model processed OK. Executed %1 algorithms total in %2 s." ).arg( executed.count() ).arg( totalTime.elapsed() / 1000.0 ) );
 
@@ -324,6 +579,105 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
   return mResults;
 }
 
+QList< QStringList > QgsProcessingModelAlgorithm::featureBasedChains( const QSet< QString > &toExecute ) const
+{
+  // number of times each child output is used by the children which will run
+  QHash< QString, int > outputUses;
+  for ( const QString &childId : toExecute )
+  {
+    const QMap< QString, QgsProcessingModelChildParameterSources > sources = mChildAlgorithms.value( childId ).parameterSources();
+    for ( const QgsProcessingModelChildParameterSources &paramSources : sources )
+    {
+      for ( const QgsProcessingModelChildParameterSource &source : paramSources )
+      {
+        if ( source.source() == QgsProcessingModelChildParameterSource::ChildOutput )
+          outputUses[ source.outputChildId() ]++;
+      }
+    }
+  }
+
+  auto isFeatureBased = [this]( const QString & childId )
+  {
+    return dynamic_cast< const QgsProcessingFeatureBasedAlgorithm * >( mChildAlgorithms.value( childId ).algorithm() );
+  };
+
+  // a child streams its features into the next one when its only use in the model is as the
+  // "INPUT" of that next child, so that its "OUTPUT" would just be a temporary layer
+  QHash< QString, QString > next;
+  QSet< QString > hasPrevious;
+  for ( const QString &childId : toExecute )
+  {
+    if ( !isFeatureBased( childId ) )
+      continue;
+
+    const QgsProcessingModelChildParameterSources inputSources = mChildAlgorithms.value( childId ).parameterSources().value( QStringLiteral( "INPUT" ) );
+    if ( inputSources.count() != 1 || inputSources.at( 0 ).source() != QgsProcessingModelChildParameterSource::ChildOutput
+         || inputSources.at( 0 ).outputName() != QStringLiteral( "OUTPUT" ) )
+      continue;
+
+    const QString previousId = inputSources.at( 0 ).outputChildId();
+    if ( !toExecute.contains( previousId ) || !isFeatureBased( previousId )
+         || outputUses.value( previousId ) != 1 || !mChildAlgorithms.value( previousId ).modelOutputs().isEmpty() )
+      continue;
+
+    next.insert( previousId, childId );
+    hasPrevious.insert( childId );
+  }
+
+  QList< QStringList > chains;
+  for ( auto nextIt = next.constBegin(); nextIt != next.constEnd(); ++nextIt )
+  {
+    if ( hasPrevious.contains( nextIt.key() ) )
+      continue;
+
+    QStringList chain;
+    for ( QString childId = nextIt.key(); !childId.isEmpty(); childId = next.value( childId ) )
+      chain << childId;
+
+    // a child which must run between two children of the chain prevents it from running in one pass
+    const QSet< QString > chainSet = chain.toSet();
+    bool blocked = false;
+    for ( const QString &dependency : dependsOnChildAlgorithms( chain.last() ) )
+    {
+      if ( !chainSet.contains( dependency ) && dependsOnChildAlgorithms( dependency ).intersects( chainSet ) )
+      {
+        blocked = true;
+        break;
+      }
+    }
+    if ( !blocked )
+      chains << chain;
+  }
+  return chains;
+}
+
+std::vector< std::unique_ptr< QgsProcessingAlgorithm > > QgsProcessingModelAlgorithm::prepareChildAlgorithms( const QStringList &chain, const QList< QVariantMap > &parameters,
+    QgsProcessingContext &context, QgsProcessingFeedback *feedback ) const
+{
+  std::vector< std::unique_ptr< QgsProcessingAlgorithm > > algorithms;
+  for ( int i = 0; i < chain.count(); ++i )
+  {
+    const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ chain.at( i ) ];
+    std::unique_ptr< QgsProcessingAlgorithm > alg( child.algorithm()->create( child.configuration() ) );
+    if ( !alg->prepare( parameters.at( i ), context, feedback ) )
+      return std::vector< std::unique_ptr< QgsProcessingAlgorithm > >();
+    algorithms.emplace_back( std::move( alg ) );
+  }
+
+  if ( chain.count() > 1 )
+  {
+    QgsProcessingFeatureBasedAlgorithm *head = static_cast< QgsProcessingFeatureBasedAlgorithm * >( algorithms.front().get() );
+    for ( int i = 1; i < chain.count(); ++i )
+    {
+      QgsProcessingFeatureBasedAlgorithm::ChainedAlgorithm chained;
+      chained.algorithm = static_cast< QgsProcessingFeatureBasedAlgorithm * >( algorithms.at( static_cast< std::size_t >( i ) ).get() );
+      chained.parameters = parameters.at( i );
+      head->mChainedAlgorithms << chained;
+    }
+  }
+  return algorithms;
+}
+
 QString QgsProcessingModelAlgorithm::sourceFilePath() const
 {
   return mSourceFile;
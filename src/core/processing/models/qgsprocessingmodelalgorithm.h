@@ -24,6 +24,7 @@
 #include "qgsprocessingalgorithm.h"
 #include "qgsprocessingmodelparameter.h"
 #include "qgsprocessingmodelchildparametersource.h"
+#include <vector>
 
 ///@cond NOT_STABLE
 
@@ -387,6 +388,22 @@ class CORE_EXPORT QgsProcessingModelAlgorithm : public QgsProcessingAlgorithm
      */
     bool childOutputIsRequired( const QString &childId, const QString &outputName ) const;
 
+    /**
+     * Returns the chains of feature based child algorithms from \a toExecute which can stream their
+     * features into each other. Within a chain, each child reads the temporary "OUTPUT" of the previous
+     * one and nothing else in the model uses that output, so it never needs to be materialized.
+     */
+    QList< QStringList > featureBasedChains( const QSet< QString > &toExecute ) const;
+
+    /**
+     * Creates and prepares the child algorithms of a \a chain, as returned by featureBasedChains(),
+     * or of a single child. \a parameters are the parameters for each child of the chain.
+     * Only the first of the returned algorithms must be run, the features it creates are passed
+     * through the other ones. Returns an empty list if one of the algorithms could not be prepared.
+     */
+    std::vector< std::unique_ptr< QgsProcessingAlgorithm > > prepareChildAlgorithms( const QStringList &chain, const QList< QVariantMap > &parameters,
+        QgsProcessingContext &context, QgsProcessingFeedback *feedback ) const;
+
     /**
      * Saves this model to a QVariantMap, wrapped in a QVariant.
      * You can use QgsXmlUtils::writeVariant to save it to an XML document.
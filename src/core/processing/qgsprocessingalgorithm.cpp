@@ -26,6 +26,60 @@
 #include "qgsexception.h"
 #include "qgsmessagelog.h"
 #include "qgsprocessingfeedback.h"
+#include "qgsfeaturesink.h"
+#include "qgsprocessingdeferredfeedback.h"
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <vector>
+
+///@cond PRIVATE
+
+//! Number of features read and processed at once by feature based algorithms running in parallel
+static const int PARALLEL_BLOCK_SIZE = 1000;
+
+//! Number of jobs a block of features is split into for each thread, to balance uneven features
+static const int PARALLEL_JOBS_PER_THREAD = 4;
+
+/**
+ * Feature sink which passes the added features to a function, used to stream the output
+ * features of an algorithm through the algorithms chained after it.
+ */
+class QgsProcessingChainSink : public QgsFeatureSink
+{
+  public:
+
+    explicit QgsProcessingChainSink( const std::function< void( QgsFeature & ) > &function )
+      : mFunction( function )
+    {}
+
+    bool addFeatures( QgsFeatureList &features, QgsFeatureSink::Flags ) override
+    {
+      for ( QgsFeature &feature : features )
+        mFunction( feature );
+      return true;
+    }
+
+  private:
+
+    std::function< void( QgsFeature & ) > mFunction;
+};
+
+//! Range of a block of features processed by one worker thread
+struct QgsProcessingFeatureJob
+{
+  std::unique_ptr< QgsProcessingContext > context;
+  std::unique_ptr< QgsProcessingDeferredFeedback > feedback;
+  int begin = 0;
+  int end = 0;
+  QString error;
+};
+
+///@endcond
 
 QgsProcessingAlgorithm::~QgsProcessingAlgorithm()
 {
@@ -702,23 +756,93 @@ QgsCoordinateReferenceSystem QgsProcessingFeatureBasedAlgorithm::sourceCrs() con
   if ( mSource )
     return mSource->sourceCrs();
   else
-    return QgsCoordinateReferenceSystem();
+    return mChainedSourceCrs;
+}
+
+///@cond PRIVATE
+
+/**
+ * Applies the invalid geometry handling of \a context to a \a feature passed to a chained
+ * algorithm, as a source reading a materialized intermediate layer would. Returns false
+ * if the feature must be skipped.
+ */
+static bool checkChainedGeometryValidity( const QgsFeature &feature, const QgsProcessingContext &context )
+{
+  if ( context.invalidGeometryCheck() == QgsFeatureRequest::GeometryNoCheck || !feature.hasGeometry() || feature.geometry().isGeosValid() )
+    return true;
+
+  QgsMessageLog::logMessage( QObject::tr( "Geometry error: One or more input features have invalid geometry." ), QString(), Qgis::Critical );
+  if ( context.invalidGeometryCallback() )
+    context.invalidGeometryCallback()( feature );
+  return false;
 }
 
+///@endcond
+
 QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   mSource.reset( parameterAsSource( parameters, QStringLiteral( "INPUT" ), context ) );
   if ( !mSource )
     return QVariantMap();
 
+  // output features may be passed through chained algorithms, the last of which creates the sink
+  QgsFields fields = outputFields( mSource->fields() );
+  QgsWkbTypes::Type wkbType = outputWkbType( mSource->wkbType() );
+  QgsCoordinateReferenceSystem crs = outputCrs( mSource->sourceCrs() );
+  const QgsProcessingFeatureBasedAlgorithm *sinkAlgorithm = this;
+  const QVariantMap *sinkParameters = &parameters;
+  std::vector< std::unique_ptr< QgsProcessingContext > > chainedContexts;
+  for ( const ChainedAlgorithm &chained : qgis::as_const( mChainedAlgorithms ) )
+  {
+    chained.algorithm->mChainedSourceCrs = crs;
+    fields = chained.algorithm->outputFields( fields );
+    wkbType = chained.algorithm->outputWkbType( wkbType );
+    crs = chained.algorithm->outputCrs( crs );
+    sinkAlgorithm = chained.algorithm;
+    sinkParameters = &chained.parameters;
+
+    std::unique_ptr< QgsProcessingContext > chainedContext( new QgsProcessingContext() );
+    chainedContext->copyThreadSafeSettings( context );
+    chainedContext->expressionContext().appendScopes( chained.algorithm->createExpressionContext( chained.parameters, *chainedContext ).takeScopes() );
+    chainedContexts.emplace_back( std::move( chainedContext ) );
+  }
+
   QString dest;
-  std::unique_ptr< QgsFeatureSink > sink( parameterAsSink( parameters, QStringLiteral( "OUTPUT" ), context, dest,
-                                          outputFields( mSource->fields() ),
-                                          outputWkbType( mSource->wkbType() ),
-                                          outputCrs( mSource->sourceCrs() ) ) );
-  if ( !sink )
+  std::unique_ptr< QgsFeatureSink > outputSink( sinkAlgorithm->parameterAsSink( *sinkParameters, QStringLiteral( "OUTPUT" ), context, dest,
+      fields, wkbType, crs ) );
+  if ( !outputSink )
     return QVariantMap();
 
+  std::unique_ptr< QgsFeatureSink > sink;
+  std::function< void( QgsFeature &, int ) > passFeature;
+  if ( mChainedAlgorithms.isEmpty() )
+  {
+    sink = std::move( outputSink );
+  }
+  else
+  {
+    passFeature = [this, &chainedContexts, &outputSink, &passFeature, feedback]( QgsFeature & feature, int step )
+    {
+      if ( step == mChainedAlgorithms.size() )
+      {
+        outputSink->addFeature( feature, QgsFeatureSink::FastInsert );
+        return;
+      }
+
+      QgsProcessingFeatureBasedAlgorithm *algorithm = mChainedAlgorithms.at( step ).algorithm;
+      QgsProcessingContext &stepContext = *chainedContexts[ static_cast< std::size_t >( step ) ];
+      if ( !( algorithm->sourceFlags() & QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks )
+           && !checkChainedGeometryValidity( feature, stepContext ) )
+        return;
+
+      stepContext.expressionContext().setFeature( feature );
+      const QgsFeatureList transformed = algorithm->processFeature( feature, stepContext, feedback );
+      for ( QgsFeature transformedFeature : transformed )
+        passFeature( transformedFeature, step + 1 );
+    };
+    sink.reset( new QgsProcessingChainSink( [&passFeature]( QgsFeature & feature ) { passFeature( feature, 0 ); } ) );
+  }
+
   // prepare expression context for feature iteration
   QgsExpressionContext prevContext = context.expressionContext();
   QgsExpressionContext algContext = prevContext;
@@ -728,25 +852,36 @@ QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariant
 
   long count = mSource->featureCount();
 
-  QgsFeature f;
+  QVector<QgsFeature> features;
   QgsFeatureIterator it = mSource->getFeatures( QgsFeatureRequest(), sourceFlags() );
 
-  double step = count > 0 ? 100.0 / count : 1;
-  int current = 0;
-  while ( it.nextFeature( f ) )
+  const int maximumThreads = context.maximumThreads() > 0 ? context.maximumThreads() : QThread::idealThreadCount();
+  if ( supportsParallelProcessing() && maximumThreads > 1 )
+  {
+    processFeaturesInParallel( it, sink.get(), count, context, feedback );
+  }
+  else
   {
-    if ( feedback->isCanceled() )
+    double step = count > 0 ? 100.0 / count : 1;
+    int current = 0;
+    while ( !feedback->isCanceled() && it.nextFeatures( features, 100 ) > 0 )
     {
-      break;
-    }
+      for ( const QgsFeature &f : qgis::as_const( features ) )
+      {
+        if ( feedback->isCanceled() )
+        {
+          break;
+        }
 
-    context.expressionContext().setFeature( f );
-    const QgsFeatureList transformed = processFeature( f, context, feedback );
-    for ( QgsFeature transformedFeature : transformed )
-      sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+        context.expressionContext().setFeature( f );
+        const QgsFeatureList transformed = processFeature( f, context, feedback );
+        for ( QgsFeature transformedFeature : transformed )
+          sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
 
-    feedback->setProgress( current * step );
-    current++;
+        feedback->setProgress( current * step );
+        current++;
+      }
+    }
   }
 
   mSource.reset();
@@ -763,3 +898,124 @@ QgsFeatureRequest QgsProcessingFeatureBasedAlgorithm::request() const
 {
   return QgsFeatureRequest();
 }
+
+bool QgsProcessingFeatureBasedAlgorithm::supportsParallelProcessing() const
+{
+  return false;
+}
+
+void QgsProcessingFeatureBasedAlgorithm::processFeaturesInParallel( QgsFeatureIterator &iterator, QgsFeatureSink *sink, long count,
+    QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  // every job gets its own context, so that expression contexts are never shared between threads.
+  // Feedback objects may be implemented in Python, so messages are only reported from this thread.
+  // When the context limits the number of threads, there are no more jobs than threads, so that
+  // no more than that number of jobs ever run at once on the global thread pool
+  const int jobCount = context.maximumThreads() > 0 ? context.maximumThreads() : std::max( 1, QThread::idealThreadCount() ) * PARALLEL_JOBS_PER_THREAD;
+  std::vector< QgsProcessingFeatureJob > jobs( static_cast< std::size_t >( jobCount ) );
+  for ( QgsProcessingFeatureJob &job : jobs )
+  {
+    job.context.reset( new QgsProcessingContext() );
+    job.context->copyThreadSafeSettings( context );
+    job.feedback.reset( new QgsProcessingDeferredFeedback() );
+    job.context->setFeedback( job.feedback.get() );
+  }
+
+  QVector<QgsFeature> features;
+  QVector<QgsFeature> nextFeatures;
+  QVector<QgsFeatureList> results;
+  QVector<QgsFeatureList> previousResults;
+
+  auto processJob = [this, &features, &results, feedback]( QgsProcessingFeatureJob & job )
+  {
+    try
+    {
+      for ( int i = job.begin; i < job.end; ++i )
+      {
+        if ( feedback->isCanceled() )
+          break;
+
+        const QgsFeature &f = features.at( i );
+        job.context->expressionContext().setFeature( f );
+        results[i] = processFeature( f, *job.context, job.feedback.get() );
+      }
+    }
+    // exceptions must not escape the worker threads, they are reported as algorithm errors instead
+    catch ( QgsException &e )
+    {
+      job.error = e.what();
+    }
+    catch ( std::exception &e )
+    {
+      job.error = QObject::tr( "Error while processing features: %1" ).arg( QString::fromLocal8Bit( e.what() ) );
+    }
+    catch ( ... )
+    {
+      job.error = QObject::tr( "Unknown error while processing features" );
+    }
+  };
+
+  auto addResults = [sink]( const QVector<QgsFeatureList> &blockResults )
+  {
+    for ( const QgsFeatureList &transformed : blockResults )
+    {
+      for ( QgsFeature transformedFeature : transformed )
+        sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+    }
+  };
+
+  double step = count > 0 ? 100.0 / count : 1;
+  int current = 0;
+  if ( !feedback->isCanceled() )
+    iterator.nextFeatures( features, PARALLEL_BLOCK_SIZE );
+  while ( !features.isEmpty() )
+  {
+    const int blockSize = features.size();
+    results.clear();
+    results.resize( blockSize );
+
+    const int jobSize = ( blockSize + static_cast< int >( jobs.size() ) - 1 ) / static_cast< int >( jobs.size() );
+    for ( int i = 0; i < static_cast< int >( jobs.size() ); ++i )
+    {
+      jobs[i].begin = std::min( i * jobSize, blockSize );
+      jobs[i].end = std::min( ( i + 1 ) * jobSize, blockSize );
+    }
+    QFuture<void> future = QtConcurrent::map( jobs, processJob );
+
+    // while the block is processed, the results of the previous one are
+    // added to the sink and the next block is read
+    try
+    {
+      addResults( previousResults );
+      previousResults.clear();
+      if ( feedback->isCanceled() || iterator.nextFeatures( nextFeatures, PARALLEL_BLOCK_SIZE ) == 0 )
+        nextFeatures.clear();
+    }
+    catch ( ... )
+    {
+      // the sink or the iterator failed, e.g. on an invalid geometry, but the jobs still
+      // use the features, results and contexts of this function
+      future.waitForFinished();
+      throw;
+    }
+
+    future.waitForFinished();
+
+    QString error;
+    for ( QgsProcessingFeatureJob &job : jobs )
+    {
+      job.feedback->report( feedback );
+      if ( error.isEmpty() )
+        error = job.error;
+    }
+    if ( !error.isEmpty() )
+      throw QgsProcessingException( error );
+
+    current += blockSize;
+    feedback->setProgress( current * step );
+
+    std::swap( previousResults, results );
+    std::swap( features, nextFeatures );
+  }
+  addResults( previousResults );
+}
@@ -899,10 +899,60 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
      */
     virtual QgsFeatureRequest request() const;
 
+    /**
+     * Returns true if processFeature() can safely be called for several features at the
+     * same time, from different threads. The default implementation returns false.
+     *
+     * Algorithms which return true have their features processed on a pool of worker threads,
+     * using no more threads than QgsProcessingContext::maximumThreads(). When only a single
+     * thread is allowed, which by default is the case on machines with a single processor core,
+     * features are processed one after another on the algorithm's thread.
+     * Each thread uses its own copy of the processing context, including its expression context,
+     * and messages pushed to the feedback object are reported on the algorithm's thread once
+     * the features have been processed. Output features are always added to the sink from the
+     * algorithm's thread, in the same order as the input features.
+     *
+     * processFeature() must not modify any state of the algorithm when this returns true.
+     *
+     * \note not available in Python bindings, algorithms implemented in Python are always
+     * processed on a single thread
+     * \since QGIS 3.0
+     */
+    virtual bool supportsParallelProcessing() const SIP_SKIP;
+
   private:
 
+    /**
+     * Processes all features from \a iterator on a pool of worker threads, and adds the
+     * resulting features to \a sink.
+     */
+    void processFeaturesInParallel( QgsFeatureIterator &iterator, QgsFeatureSink *sink, long count,
+                                    QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
+#ifndef SIP_RUN
+
+    //! Prepared algorithm which processes the output features of another algorithm
+    struct ChainedAlgorithm
+    {
+      QgsProcessingFeatureBasedAlgorithm *algorithm;
+      QVariantMap parameters;
+    };
+
+    /**
+     * Algorithms the output features of this algorithm are passed through, in order, before
+     * reaching a sink created by the last of them. Set by models to process chains of feature
+     * based child algorithms in a single pass, without intermediate layers.
+     */
+    QList< ChainedAlgorithm > mChainedAlgorithms;
+
+    //! Source CRS of an algorithm chained after another one
+    QgsCoordinateReferenceSystem mChainedSourceCrs;
+#endif
+
     std::unique_ptr< QgsProcessingFeatureSource > mSource;
 
+    friend class QgsProcessingModelAlgorithm;
+
 };
 
 // clazy:excludeall=qstring-allocations
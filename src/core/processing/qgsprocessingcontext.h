@@ -81,6 +81,7 @@ class CORE_EXPORT QgsProcessingContext
       mTransformErrorCallback = other.mTransformErrorCallback;
       mDefaultEncoding = other.mDefaultEncoding;
       mFeedback = other.mFeedback;
+      mMaximumThreads = other.mMaximumThreads;
     }
 
     /**
@@ -303,6 +304,30 @@ class CORE_EXPORT QgsProcessingContext
      */
     void setDefaultEncoding( const QString &encoding ) { mDefaultEncoding = encoding; }
 
+    /**
+     * Returns the maximum number of threads used to run independent child algorithms
+     * of a model at the same time. A value of -1 uses as many threads as there are
+     * processor cores, and 1 runs all child algorithms one after another.
+     *
+     * Feature based algorithms which support parallel processing also process their
+     * features with no more than this number of threads. Within a model, each child
+     * algorithm running at the same time uses up to this number of threads for its features,
+     * all of them sharing the global thread pool.
+     * \see setMaximumThreads()
+     * \since QGIS 3.0
+     */
+    int maximumThreads() const { return mMaximumThreads; }
+
+    /**
+     * Sets the \a maximum number of threads used to run independent child algorithms
+     * of a model at the same time, and to process the features of algorithms which
+     * support parallel processing. A value of -1 uses as many threads as there are
+     * processor cores, and 1 runs everything on the algorithm's thread.
+     * \see maximumThreads()
+     * \since QGIS 3.0
+     */
+    void setMaximumThreads( int maximum ) { mMaximumThreads = maximum; }
+
     /**
      * Returns the associated feedback object.
      * \see setFeedback()
@@ -380,6 +405,7 @@ class CORE_EXPORT QgsProcessingContext
     std::function< void( const QgsFeature & ) > mInvalidGeometryCallback;
     std::function< void( const QgsFeature & ) > mTransformErrorCallback;
     QString mDefaultEncoding;
+    int mMaximumThreads = -1;
     QMap< QString, LayerDetails > mLayersToLoadOnCompletion;
 
     QPointer< QgsProcessingFeedback > mFeedback;
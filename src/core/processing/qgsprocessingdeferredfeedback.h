@@ -0,0 +1,88 @@
+/***************************************************************************
+                         qgsprocessingdeferredfeedback.h
+                         -------------------------------
+    begin                : October 2017
+    copyright            : (C) 2017 by QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPROCESSINGDEFERREDFEEDBACK_H
+#define QGSPROCESSINGDEFERREDFEEDBACK_H
+
+#define SIP_NO_FILE
+
+#include "qgis.h"
+#include "qgsprocessingfeedback.h"
+
+#include <QList>
+#include <QPair>
+
+/// @cond PRIVATE
+
+/**
+ * \ingroup core
+ * Processing feedback which keeps the messages pushed from a worker thread, so that
+ * they can be reported on the algorithm's thread once the worker is done.
+ * \note not available in Python bindings
+ * \since QGIS 3.0
+ */
+class QgsProcessingDeferredFeedback : public QgsProcessingFeedback
+{
+  public:
+
+    void reportError( const QString &error ) override { mMessages << qMakePair( Error, error ); }
+    void pushInfo( const QString &info ) override { mMessages << qMakePair( Info, info ); }
+    void pushCommandInfo( const QString &info ) override { mMessages << qMakePair( CommandInfo, info ); }
+    void pushDebugInfo( const QString &info ) override { mMessages << qMakePair( DebugInfo, info ); }
+    void pushConsoleInfo( const QString &info ) override { mMessages << qMakePair( ConsoleInfo, info ); }
+
+    //! Reports the kept messages to \a feedback, and forgets them
+    void report( QgsProcessingFeedback *feedback )
+    {
+      for ( const QPair< MessageType, QString > &message : qgis::as_const( mMessages ) )
+      {
+        switch ( message.first )
+        {
+          case Error:
+            feedback->reportError( message.second );
+            break;
+          case Info:
+            feedback->pushInfo( message.second );
+            break;
+          case CommandInfo:
+            feedback->pushCommandInfo( message.second );
+            break;
+          case DebugInfo:
+            feedback->pushDebugInfo( message.second );
+            break;
+          case ConsoleInfo:
+            feedback->pushConsoleInfo( message.second );
+            break;
+        }
+      }
+      mMessages.clear();
+    }
+
+  private:
+
+    enum MessageType
+    {
+      Error,
+      Info,
+      CommandInfo,
+      DebugInfo,
+      ConsoleInfo,
+    };
+
+    QList< QPair< MessageType, QString > > mMessages;
+};
+
+/// @endcond
+
+#endif // QGSPROCESSINGDEFERREDFEEDBACK_H
@@ -67,8 +67,7 @@ QgsMemoryFeatureIterator::QgsMemoryFeatureIterator( QgsMemoryFeatureSource *sour
   else if ( mRequest.filterType() == QgsFeatureRequest::FilterFid )
   {
     mUsingFeatureIdList = true;
-    QgsFeatureMap::const_iterator it = mSource->mFeatures.constFind( mRequest.filterFid() );
-    if ( it != mSource->mFeatures.constEnd() )
+    if ( mSource->mFeatures.indexOf( mRequest.filterFid() ) >= 0 )
       mFeatureIdList.append( mRequest.filterFid() );
   }
   else
@@ -97,29 +96,49 @@ bool QgsMemoryFeatureIterator::fetchFeature( QgsFeature &feature )
     return nextFeatureTraverseAll( feature );
 }
 
+int QgsMemoryFeatureIterator::fetchFeatures( QVector<QgsFeature> &features, int maxFeatures )
+{
+  int count = 0;
+  if ( mUsingFeatureIdList )
+  {
+    while ( count < maxFeatures && !mClosed && nextFeatureUsingList( features[count] ) )
+      ++count;
+  }
+  else
+  {
+    while ( count < maxFeatures && !mClosed && nextFeatureTraverseAll( features[count] ) )
+      ++count;
+  }
+  return count;
+}
+
 
 bool QgsMemoryFeatureIterator::nextFeatureUsingList( QgsFeature &feature )
 {
   bool hasFeature = false;
 
   // option 1: we have a list of features to traverse
+  int index = -1;
   while ( mFeatureIdListIterator != mFeatureIdList.constEnd() )
   {
+    index = mSource->mFeatures.indexOf( *mFeatureIdListIterator );
+    if ( index < 0 )
+    {
+      ++mFeatureIdListIterator;
+      continue;
+    }
+
     if ( !mFilterRect.isNull() && mRequest.flags() & QgsFeatureRequest::ExactIntersect )
     {
       // do exact check in case we're doing intersection
-      if ( mSource->mFeatures.value( *mFeatureIdListIterator ).hasGeometry() && mSelectRectEngine->intersects( mSource->mFeatures.value( *mFeatureIdListIterator ).geometry().constGet() ) )
+      if ( mSource->mFeatures.hasGeometry( index ) && mSelectRectEngine->intersects( mSource->mFeatures.geometry( index ).constGet() ) )
         hasFeature = true;
     }
     else
       hasFeature = true;
 
-    if ( mSubsetExpression )
-    {
-      mSource->mExpressionContext.setFeature( mSource->mFeatures.value( *mFeatureIdListIterator ) );
-      if ( !mSubsetExpression->evaluate( &mSource->mExpressionContext ).toBool() )
-        hasFeature = false;
-    }
+    if ( hasFeature && !testSubsetExpression( index ) )
+      hasFeature = false;
 
     if ( hasFeature )
       break;
@@ -127,10 +146,10 @@ bool QgsMemoryFeatureIterator::nextFeatureUsingList( QgsFeature &feature )
     ++mFeatureIdListIterator;
   }
 
-  // copy feature
+  // build feature
   if ( hasFeature )
   {
-    feature = mSource->mFeatures.value( *mFeatureIdListIterator );
+    feature = mSource->mFeatures.feature( index, !( mRequest.flags() & QgsFeatureRequest::NoGeometry ) );
     ++mFeatureIdListIterator;
   }
   else
@@ -151,48 +170,35 @@ bool QgsMemoryFeatureIterator::nextFeatureTraverseAll( QgsFeature &feature )
   bool hasFeature = false;
 
   // option 2: traversing the whole layer
-  while ( mSelectIterator != mSource->mFeatures.constEnd() )
+  const QgsMemoryFeatureStore &features = mSource->mFeatures;
+  while ( mSelectIndex < features.count() )
   {
     if ( mFilterRect.isNull() )
     {
       // selection rect empty => using all features
       hasFeature = true;
     }
-    else
+    else if ( features.hasGeometry( mSelectIndex ) && features.boundingBox( mSelectIndex ).intersects( mFilterRect ) )
     {
-      if ( mRequest.flags() & QgsFeatureRequest::ExactIntersect )
-      {
-        // using exact test when checking for intersection
-        if ( mSelectIterator->hasGeometry() && mSelectRectEngine->intersects( mSelectIterator->geometry().constGet() ) )
-          hasFeature = true;
-      }
-      else
-      {
-        // check just bounding box against rect when not using intersection
-        if ( mSelectIterator->hasGeometry() && mSelectIterator->geometry().boundingBox().intersects( mFilterRect ) )
-          hasFeature = true;
-      }
+      // the stored bounding box discards most features without parsing the geometry,
+      // the exact test is only done when checking for intersection
+      hasFeature = !( mRequest.flags() & QgsFeatureRequest::ExactIntersect ) || mSelectRectEngine->intersects( features.geometry( mSelectIndex ).constGet() );
     }
 
-    if ( mSubsetExpression )
-    {
-      mSource->mExpressionContext.setFeature( *mSelectIterator );
-      if ( !mSubsetExpression->evaluate( &mSource->mExpressionContext ).toBool() )
-        hasFeature = false;
-    }
+    if ( hasFeature && !testSubsetExpression( mSelectIndex ) )
+      hasFeature = false;
 
     if ( hasFeature )
       break;
 
-    ++mSelectIterator;
+    ++mSelectIndex;
   }
 
-  // copy feature
+  // build feature
   if ( hasFeature )
   {
-    feature = mSelectIterator.value();
-    ++mSelectIterator;
-    feature.setValid( true );
+    feature = features.feature( mSelectIndex, !( mRequest.flags() & QgsFeatureRequest::NoGeometry ) );
+    ++mSelectIndex;
     feature.setFields( mSource->mFields ); // allow name-based attribute lookups
     geometryToDestinationCrs( feature, mTransform );
   }
@@ -202,6 +208,15 @@ bool QgsMemoryFeatureIterator::nextFeatureTraverseAll( QgsFeature &feature )
   return hasFeature;
 }
 
+bool QgsMemoryFeatureIterator::testSubsetExpression( int index )
+{
+  if ( !mSubsetExpression )
+    return true;
+
+  mSource->mExpressionContext.setFeature( mSource->mFeatures.feature( index ) );
+  return mSubsetExpression->evaluate( &mSource->mExpressionContext ).toBool();
+}
+
 bool QgsMemoryFeatureIterator::rewind()
 {
   if ( mClosed )
@@ -210,7 +225,7 @@ bool QgsMemoryFeatureIterator::rewind()
   if ( mUsingFeatureIdList )
     mFeatureIdListIterator = mFeatureIdList.constBegin();
   else
-    mSelectIterator = mSource->mFeatures.constBegin();
+    mSelectIndex = 0;
 
   return true;
 }
@@ -21,13 +21,10 @@
 #include "qgsexpressioncontext.h"
 #include "qgsfields.h"
 #include "qgsgeometry.h"
+#include "qgsmemoryprovider.h"
 
 ///@cond PRIVATE
 
-class QgsMemoryProvider;
-
-typedef QMap<QgsFeatureId, QgsFeature> QgsFeatureMap;
-
 class QgsSpatialIndex;
 
 
@@ -40,13 +37,14 @@ class QgsMemoryFeatureSource : public QgsAbstractFeatureSource
 
   private:
     QgsFields mFields;
-    QgsFeatureMap mFeatures;
+    QgsMemoryFeatureStore mFeatures;
     std::unique_ptr< QgsSpatialIndex > mSpatialIndex;
     QString mSubsetString;
     QgsExpressionContext mExpressionContext;
     QgsCoordinateReferenceSystem mCrs;
 
     friend class QgsMemoryFeatureIterator;
+    friend class QgsMemoryProvider;
 };
 
 
@@ -63,15 +61,18 @@ class QgsMemoryFeatureIterator : public QgsAbstractFeatureIteratorFromSource<Qgs
   protected:
 
     bool fetchFeature( QgsFeature &feature ) override;
+    int fetchFeatures( QVector<QgsFeature> &features, int maxFeatures ) override;
 
   private:
     bool nextFeatureUsingList( QgsFeature &feature );
     bool nextFeatureTraverseAll( QgsFeature &feature );
+    //! Returns true if the feature at position \a index matches the subset string
+    bool testSubsetExpression( int index );
 
     QgsGeometry mSelectRectGeom;
     std::unique_ptr< QgsGeometryEngine > mSelectRectEngine;
     QgsRectangle mFilterRect;
-    QgsFeatureMap::const_iterator mSelectIterator;
+    int mSelectIndex = 0;
     bool mUsingFeatureIdList = false;
     QList<QgsFeatureId> mFeatureIdList;
     QList<QgsFeatureId>::const_iterator mFeatureIdListIterator;
@@ -26,6 +26,8 @@
 #include <QUrl>
 #include <QRegExp>
 
+#include <algorithm>
+
 ///@cond PRIVATE
 
 static const QString TEXT_PROVIDER_KEY = QStringLiteral( "memory" );
@@ -277,11 +279,11 @@ QgsRectangle QgsMemoryProvider::extent() const
     mExtent.setMinimal();
     if ( mSubsetString.isEmpty() )
     {
-      // fast way - iterate through all features
-      Q_FOREACH ( const QgsFeature &feat, mFeatures )
+      // fast way - combine the stored bounding boxes
+      for ( int i = 0; i < mFeatures.count(); ++i )
       {
-        if ( feat.hasGeometry() )
-          mExtent.combineExtentWith( feat.geometry().boundingBox() );
+        if ( mFeatures.hasGeometry( i ) )
+          mExtent.combineExtentWith( mFeatures.boundingBox( i ) );
       }
     }
     else
@@ -387,7 +389,7 @@ bool QgsMemoryProvider::addFeatures( QgsFeatureList &flist, Flags )
       continue;
     }
 
-    mFeatures.insert( mNextFeatureId, *it );
+    mFeatures.append( *it );
 
     if ( it->hasGeometry() )
     {
@@ -407,21 +409,20 @@ bool QgsMemoryProvider::addFeatures( QgsFeatureList &flist, Flags )
 
 bool QgsMemoryProvider::deleteFeatures( const QgsFeatureIds &id )
 {
-  for ( QgsFeatureIds::const_iterator it = id.begin(); it != id.end(); ++it )
+  // update spatial index
+  if ( mSpatialIndex )
   {
-    QgsFeatureMap::iterator fit = mFeatures.find( *it );
-
-    // check whether such feature exists
-    if ( fit == mFeatures.end() )
-      continue;
-
-    // update spatial index
-    if ( mSpatialIndex )
-      mSpatialIndex->deleteFeature( *fit );
-
-    mFeatures.erase( fit );
+    for ( QgsFeatureIds::const_iterator it = id.begin(); it != id.end(); ++it )
+    {
+      int index = mFeatures.indexOf( *it );
+      if ( index >= 0 )
+        mSpatialIndex->deleteFeature( mFeatures.feature( index ) );
+    }
   }
 
+  // removed in a single pass
+  mFeatures.remove( id );
+
   updateExtents();
 
   return true;
@@ -449,14 +450,7 @@ bool QgsMemoryProvider::addAttributes( const QList<QgsField> &attributes )
     }
     // add new field as a last one
     mFields.append( *it );
-
-    for ( QgsFeatureMap::iterator fit = mFeatures.begin(); fit != mFeatures.end(); ++fit )
-    {
-      QgsFeature &f = fit.value();
-      QgsAttributes attr = f.attributes();
-      attr.append( QVariant() );
-      f.setAttributes( attr );
-    }
+    mFeatures.appendAttribute( it->type() );
   }
   return true;
 }
@@ -495,14 +489,7 @@ bool QgsMemoryProvider::deleteAttributes( const QgsAttributeIds &attributes )
   {
     int idx = *it;
     mFields.remove( idx );
-
-    for ( QgsFeatureMap::iterator fit = mFeatures.begin(); fit != mFeatures.end(); ++fit )
-    {
-      QgsFeature &f = fit.value();
-      QgsAttributes attr = f.attributes();
-      attr.remove( idx );
-      f.setAttributes( attr );
-    }
+    mFeatures.removeAttribute( idx );
   }
   return true;
 }
@@ -511,13 +498,13 @@ bool QgsMemoryProvider::changeAttributeValues( const QgsChangedAttributesMap &at
 {
   for ( QgsChangedAttributesMap::const_iterator it = attr_map.begin(); it != attr_map.end(); ++it )
   {
-    QgsFeatureMap::iterator fit = mFeatures.find( it.key() );
-    if ( fit == mFeatures.end() )
+    int index = mFeatures.indexOf( it.key() );
+    if ( index < 0 )
       continue;
 
     const QgsAttributeMap &attrs = it.value();
     for ( QgsAttributeMap::const_iterator it2 = attrs.constBegin(); it2 != attrs.constEnd(); ++it2 )
-      fit->setAttribute( it2.key(), it2.value() );
+      mFeatures.setAttribute( index, it2.key(), it2.value() );
   }
   return true;
 }
@@ -526,19 +513,19 @@ bool QgsMemoryProvider::changeGeometryValues( const QgsGeometryMap &geometry_map
 {
   for ( QgsGeometryMap::const_iterator it = geometry_map.begin(); it != geometry_map.end(); ++it )
   {
-    QgsFeatureMap::iterator fit = mFeatures.find( it.key() );
-    if ( fit == mFeatures.end() )
+    int index = mFeatures.indexOf( it.key() );
+    if ( index < 0 )
       continue;
 
     // update spatial index
     if ( mSpatialIndex )
-      mSpatialIndex->deleteFeature( *fit );
+      mSpatialIndex->deleteFeature( mFeatures.feature( index ) );
 
-    fit->setGeometry( it.value() );
+    mFeatures.setGeometry( index, it.value() );
 
     // update spatial index
     if ( mSpatialIndex )
-      mSpatialIndex->insertFeature( *fit );
+      mSpatialIndex->insertFeature( mFeatures.feature( index ) );
   }
 
   updateExtents();
@@ -574,12 +561,21 @@ bool QgsMemoryProvider::createSpatialIndex()
 {
   if ( !mSpatialIndex )
   {
-    mSpatialIndex = new QgsSpatialIndex();
+    bool hasGeometries = false;
+    for ( int i = 0; i < mFeatures.count() && !hasGeometries; ++i )
+      hasGeometries = mFeatures.hasGeometry( i );
 
-    // add existing features to index
-    for ( QgsFeatureMap::const_iterator it = mFeatures.constBegin(); it != mFeatures.constEnd(); ++it )
+    if ( hasGeometries )
+    {
+      // bulk load the index with all the existing features, regardless of the subset string
+      QgsMemoryFeatureSource *source = new QgsMemoryFeatureSource( this );
+      source->mSubsetString.clear();
+      mSpatialIndex = new QgsSpatialIndex( QgsFeatureIterator( new QgsMemoryFeatureIterator( source, true, QgsFeatureRequest().setSubsetOfAttributes( QgsAttributeList() ) ) ) );
+    }
+    else
     {
-      mSpatialIndex->insertFeature( *it );
+      // bulk loading requires some data
+      mSpatialIndex = new QgsSpatialIndex();
     }
   }
   return true;
@@ -609,4 +605,319 @@ QString QgsMemoryProvider::description() const
 }
 
 
+//
+// QgsMemoryFeatureStore
+//
+
+//! Size of the blocks the geometry WKB is packed in
+static const int WKB_BLOCK_SIZE = 1 << 20;
+
+int QgsMemoryFeatureStore::indexOf( QgsFeatureId fid ) const
+{
+  QVector<QgsFeatureId>::const_iterator it = std::lower_bound( mIds.constBegin(), mIds.constEnd(), fid );
+  if ( it == mIds.constEnd() || *it != fid )
+    return -1;
+
+  return static_cast< int >( it - mIds.constBegin() );
+}
+
+QgsFeature QgsMemoryFeatureStore::feature( int index, bool fetchGeometry ) const
+{
+  QgsFeature feature( mIds.at( index ) );
+  if ( fetchGeometry && hasGeometry( index ) )
+    feature.setGeometry( geometry( index ) );
+
+  QgsAttributes attributes( mColumns.size() );
+  for ( int field = 0; field < mColumns.size(); ++field )
+    attributes[field] = value( mColumns.at( field ), index );
+  feature.setAttributes( attributes );
+
+  feature.setValid( true );
+  return feature;
+}
+
+QgsGeometry QgsMemoryFeatureStore::geometry( int index ) const
+{
+  const GeometryRef &ref = mGeometries.at( index );
+  if ( ref.block < 0 )
+    return QgsGeometry();
+
+  QgsGeometry geometry;
+  geometry.fromWkb( QByteArray::fromRawData( mWkbBlocks.at( ref.block ).constData() + ref.offset, ref.size ) );
+  return geometry;
+}
+
+void QgsMemoryFeatureStore::append( const QgsFeature &feature )
+{
+  Q_ASSERT( mIds.isEmpty() || mIds.last() < feature.id() );
+
+  mIds.append( feature.id() );
+  if ( feature.hasGeometry() )
+  {
+    mGeometries.append( appendWkb( feature.geometry().asWkb() ) );
+    mBoundingBoxes.append( feature.geometry().boundingBox() );
+  }
+  else
+  {
+    mGeometries.append( GeometryRef() );
+    mBoundingBoxes.append( QgsRectangle() );
+  }
+
+  const QgsAttributes attributes = feature.attributes();
+  for ( int field = 0; field < mColumns.size(); ++field )
+    appendValue( mColumns[field], field < attributes.size() ? attributes.at( field ) : QVariant() );
+}
+
+template <typename T>
+static void compactValues( QVector<T> &values, const QVector<bool> &removed )
+{
+  if ( values.isEmpty() )
+    return;
+
+  int kept = 0;
+  for ( int i = 0; i < removed.size(); ++i )
+  {
+    if ( removed.at( i ) )
+      continue;
+
+    if ( kept != i )
+      values[kept] = values.at( i );
+    ++kept;
+  }
+  values.resize( kept );
+}
+
+void QgsMemoryFeatureStore::remove( const QgsFeatureIds &fids )
+{
+  if ( fids.isEmpty() )
+    return;
+
+  QVector<bool> removed( mIds.size(), false );
+  QVector<int> newPositions( mIds.size(), -1 );
+  int kept = 0;
+  for ( int i = 0; i < mIds.size(); ++i )
+  {
+    if ( fids.contains( mIds.at( i ) ) )
+    {
+      removed[i] = true;
+      const GeometryRef &ref = mGeometries.at( i );
+      if ( ref.block >= 0 )
+        mUnusedWkbSize += ref.size;
+    }
+    else
+    {
+      newPositions[i] = kept++;
+    }
+  }
+  if ( kept == mIds.size() )
+    return;
+
+  // compact the arrays, keeping the features order
+  compactValues( mIds, removed );
+  compactValues( mGeometries, removed );
+  compactValues( mBoundingBoxes, removed );
+  for ( Column &column : mColumns )
+  {
+    compactValues( column.states, removed );
+    compactValues( column.integers, removed );
+    compactValues( column.doubles, removed );
+    compactValues( column.codes, removed );
+    compactValues( column.variants, removed );
+
+    if ( !column.overflow.isEmpty() )
+    {
+      QHash<int, QVariant> overflow;
+      for ( auto it = column.overflow.constBegin(); it != column.overflow.constEnd(); ++it )
+      {
+        if ( !removed.at( it.key() ) )
+          overflow.insert( newPositions.at( it.key() ), it.value() );
+      }
+      column.overflow = overflow;
+    }
+  }
+
+  compactWkb();
+}
+
+void QgsMemoryFeatureStore::setGeometry( int index, const QgsGeometry &geometry )
+{
+  GeometryRef &ref = mGeometries[index];
+  if ( ref.block >= 0 )
+    mUnusedWkbSize += ref.size;
+
+  if ( geometry.isNull() )
+  {
+    ref = GeometryRef();
+    mBoundingBoxes[index] = QgsRectangle();
+  }
+  else
+  {
+    ref = appendWkb( geometry.asWkb() );
+    mBoundingBoxes[index] = geometry.boundingBox();
+  }
+
+  compactWkb();
+}
+
+void QgsMemoryFeatureStore::setAttribute( int index, int field, const QVariant &value )
+{
+  if ( field < 0 || field >= mColumns.size() )
+    return;
+
+  setValue( mColumns[field], index, value );
+}
+
+void QgsMemoryFeatureStore::appendAttribute( QVariant::Type type )
+{
+  Column column;
+  column.type = type;
+  for ( int i = 0; i < mIds.size(); ++i )
+    appendValue( column, QVariant() );
+  mColumns.append( column );
+}
+
+void QgsMemoryFeatureStore::removeAttribute( int field )
+{
+  if ( field >= 0 && field < mColumns.size() )
+    mColumns.remove( field );
+}
+
+void QgsMemoryFeatureStore::appendValue( Column &column, const QVariant &value )
+{
+  column.states.append( Invalid );
+  switch ( column.type )
+  {
+    case QVariant::Int:
+    case QVariant::LongLong:
+      column.integers.append( 0 );
+      break;
+    case QVariant::Double:
+      column.doubles.append( 0 );
+      break;
+    case QVariant::String:
+      column.codes.append( -1 );
+      break;
+    default:
+      column.variants.append( QVariant() );
+      break;
+  }
+  setValue( column, column.states.size() - 1, value );
+}
+
+void QgsMemoryFeatureStore::setValue( Column &column, int index, const QVariant &value )
+{
+  if ( column.states.at( index ) == Other )
+    column.overflow.remove( index );
+
+  ValueState state = Value;
+  if ( !value.isValid() )
+    state = Invalid;
+  else if ( value.type() != column.type )
+    state = Other;
+  else if ( value.isNull() )
+    state = Null;
+
+  switch ( column.type )
+  {
+    case QVariant::Int:
+    case QVariant::LongLong:
+      if ( state == Value )
+        column.integers[index] = value.toLongLong();
+      break;
+    case QVariant::Double:
+      if ( state == Value )
+        column.doubles[index] = value.toDouble();
+      break;
+    case QVariant::String:
+      if ( state == Value )
+      {
+        const QString string = value.toString();
+        int code = column.dictionaryCodes.value( string, -1 );
+        if ( code < 0 )
+        {
+          code = column.dictionary.size();
+          column.dictionaryCodes.insert( string, code );
+          column.dictionary.append( string );
+        }
+        column.codes[index] = code;
+      }
+      break;
+    default:
+      // no typed storage, all the values are kept as they are
+      column.variants[index] = value;
+      state = Value;
+      break;
+  }
+
+  if ( state == Other )
+    column.overflow.insert( index, value );
+  column.states[index] = state;
+}
+
+QVariant QgsMemoryFeatureStore::value( const Column &column, int index )
+{
+  switch ( column.states.at( index ) )
+  {
+    case Invalid:
+      return QVariant();
+    case Null:
+      return QVariant( column.type );
+    case Other:
+      return column.overflow.value( index );
+    default:
+      break;
+  }
+
+  switch ( column.type )
+  {
+    case QVariant::Int:
+      return static_cast< int >( column.integers.at( index ) );
+    case QVariant::LongLong:
+      return static_cast< qlonglong >( column.integers.at( index ) );
+    case QVariant::Double:
+      return column.doubles.at( index );
+    case QVariant::String:
+      return column.dictionary.at( column.codes.at( index ) );
+    default:
+      return column.variants.at( index );
+  }
+}
+
+QgsMemoryFeatureStore::GeometryRef QgsMemoryFeatureStore::appendWkb( const QByteArray &wkb )
+{
+  // start a new block when the last one is full, large geometries get their own block
+  if ( mWkbBlocks.isEmpty() || mWkbBlocks.last().size() + wkb.size() > WKB_BLOCK_SIZE )
+  {
+    mWkbBlocks.append( QByteArray() );
+    mWkbBlocks.last().reserve( std::max( WKB_BLOCK_SIZE, wkb.size() ) );
+  }
+
+  GeometryRef ref;
+  ref.block = mWkbBlocks.size() - 1;
+  ref.offset = mWkbBlocks.last().size();
+  ref.size = wkb.size();
+  mWkbBlocks.last().append( wkb );
+  return ref;
+}
+
+void QgsMemoryFeatureStore::compactWkb()
+{
+  qint64 totalSize = 0;
+  for ( const QByteArray &block : qgis::as_const( mWkbBlocks ) )
+    totalSize += block.size();
+
+  // only rewrite the blocks once they are mostly made of replaced or removed geometries
+  if ( mUnusedWkbSize == 0 || mUnusedWkbSize * 2 < totalSize )
+    return;
+
+  const QVector<QByteArray> blocks = mWkbBlocks;
+  mWkbBlocks.clear();
+  mUnusedWkbSize = 0;
+  for ( GeometryRef &ref : mGeometries )
+  {
+    if ( ref.block >= 0 )
+      ref = appendWkb( QByteArray::fromRawData( blocks.at( ref.block ).constData() + ref.offset, ref.size ) );
+  }
+}
+
 ///@endcond
@@ -18,12 +18,136 @@
 #include "qgsvectordataprovider.h"
 #include "qgscoordinatereferencesystem.h"
 #include "qgsfields.h"
+#include "qgsfeature.h"
+#include "qgsrectangle.h"
+
+#include <QVector>
+#include <QHash>
+#include <QByteArray>
 
 ///@cond PRIVATE
-typedef QMap<QgsFeatureId, QgsFeature> QgsFeatureMap;
 
 class QgsSpatialIndex;
 
+/**
+ * Features of the memory provider, kept in columns sorted by feature id.
+ *
+ * Feature ids are only ever appended in increasing order, so that lookups by id
+ * are binary searches and traversals are linear scans. Geometries are stored as
+ * WKB packed in large blocks, with their bounding boxes kept aside to test them
+ * against filter rectangles without parsing the geometries. Attributes are stored
+ * in one typed column per field: integers and doubles as plain numbers, strings
+ * as codes into a dictionary of the distinct values. Features are only built
+ * when they are fetched. All the arrays are implicitly shared: copying the store
+ * for a feature source is cheap and edits detach it column by column.
+ */
+class QgsMemoryFeatureStore
+{
+  public:
+
+    //! Returns the number of features
+    int count() const { return mIds.size(); }
+
+    //! Returns true if there is no feature
+    bool isEmpty() const { return mIds.isEmpty(); }
+
+    //! Returns the position of the feature with id \a fid, or -1 if there is no such feature
+    int indexOf( QgsFeatureId fid ) const;
+
+    //! Returns the id of the feature at position \a index
+    QgsFeatureId id( int index ) const { return mIds.at( index ); }
+
+    /**
+     * Builds the feature at position \a index. The geometry is left empty if
+     * \a fetchGeometry is false.
+     */
+    QgsFeature feature( int index, bool fetchGeometry = true ) const;
+
+    //! Returns true if the feature at position \a index has a geometry
+    bool hasGeometry( int index ) const { return mGeometries.at( index ).block >= 0; }
+
+    //! Builds the geometry of the feature at position \a index
+    QgsGeometry geometry( int index ) const;
+
+    //! Returns the bounding box of the feature geometry at position \a index
+    const QgsRectangle &boundingBox( int index ) const { return mBoundingBoxes.at( index ); }
+
+    //! Appends a feature, its id must be greater than any stored feature id
+    void append( const QgsFeature &feature );
+
+    //! Removes the features with ids \a fids
+    void remove( const QgsFeatureIds &fids );
+
+    //! Sets the geometry of the feature at position \a index
+    void setGeometry( int index, const QgsGeometry &geometry );
+
+    //! Sets the value of the attribute \a field of the feature at position \a index
+    void setAttribute( int index, int field, const QVariant &value );
+
+    //! Appends a column for a field of type \a type, with invalid values for all the features
+    void appendAttribute( QVariant::Type type );
+
+    //! Removes the attribute \a field from all the features
+    void removeAttribute( int field );
+
+  private:
+
+    //! Location of a feature geometry in the WKB blocks
+    struct GeometryRef
+    {
+      //! Block of the WKB, -1 if the feature has no geometry
+      int block = -1;
+      int offset = 0;
+      int size = 0;
+    };
+
+    //! State of a stored attribute value
+    enum ValueState
+    {
+      Value, //!< Value stored in the typed array of the column
+      Invalid, //!< Invalid QVariant
+      Null, //!< Null QVariant of the column type
+      Other, //!< Value of another type, stored as a QVariant in the column overflow
+    };
+
+    //! Attribute values of a field
+    struct Column
+    {
+      QVariant::Type type = QVariant::Invalid;
+      QVector<quint8> states;
+      //! Values of integer fields
+      QVector<qint64> integers;
+      //! Values of double fields
+      QVector<double> doubles;
+      //! Values of string fields, as positions in the dictionary
+      QVector<int> codes;
+      QStringList dictionary;
+      QHash<QString, int> dictionaryCodes;
+      //! Values of the other field types
+      QVector<QVariant> variants;
+      //! Values which don't match the field type, by feature position
+      QHash<int, QVariant> overflow;
+    };
+
+    static void appendValue( Column &column, const QVariant &value );
+    static void setValue( Column &column, int index, const QVariant &value );
+    static QVariant value( const Column &column, int index );
+
+    //! Appends \a wkb to the blocks and returns its location
+    GeometryRef appendWkb( const QByteArray &wkb );
+
+    //! Rewrites the blocks with the WKB of the current geometries only
+    void compactWkb();
+
+    QVector<QgsFeatureId> mIds;
+    QVector<GeometryRef> mGeometries;
+    QVector<QgsRectangle> mBoundingBoxes;
+    QVector<QByteArray> mWkbBlocks;
+    //! Bytes in the blocks no longer used by any geometry
+    qint64 mUnusedWkbSize = 0;
+    QVector<Column> mColumns;
+};
+
 class QgsMemoryFeatureIterator;
 
 class QgsMemoryProvider : public QgsVectorDataProvider
@@ -84,7 +208,7 @@ class QgsMemoryProvider : public QgsVectorDataProvider
     mutable QgsRectangle mExtent;
 
     // features
-    QgsFeatureMap mFeatures;
+    QgsMemoryFeatureStore mFeatures;
     QgsFeatureId mNextFeatureId;
 
     // indexing
@@ -22,7 +22,8 @@
 #include "qgsgeometry.h"
 #include "qgsvectorlayer.h"
 
-
+//! Number of features evaluated at once by expression based aggregates
+static const int EXPRESSION_BLOCK_SIZE = 1000;
 
 QgsAggregateCalculator::QgsAggregateCalculator( const QgsVectorLayer *layer )
   : mLayer( layer )
@@ -644,21 +645,24 @@ QVariant QgsAggregateCalculator::calculateNumericAggregate( QgsFeatureIterator &
   Q_ASSERT( expression || attr >= 0 );
 
   QgsStatisticalSummary s( stat );
-  QgsFeature f;
 
-  while ( fit.nextFeature( f ) )
+  if ( expression )
   {
-    if ( expression )
+    Q_ASSERT( context );
+    // evaluate the expression for blocks of features, so that compiled expressions run on whole columns
+    QVector<QgsFeature> features;
+    while ( fit.nextFeatures( features, EXPRESSION_BLOCK_SIZE ) > 0 )
     {
-      Q_ASSERT( context );
-      context->setFeature( f );
-      QVariant v = expression->evaluate( context );
-      s.addVariant( v );
+      const QVector<QVariant> values = expression->evaluate( features, context );
+      for ( const QVariant &v : values )
+        s.addVariant( v );
     }
-    else
-    {
+  }
+  else
+  {
+    QgsFeature f;
+    while ( fit.nextFeature( f ) )
       s.addVariant( f.attribute( attr ) );
-    }
   }
   s.finalize();
   double val = s.statistic( stat );
@@ -36,6 +36,8 @@
 #include <QSettings>
 #include <QDir>
 
+#include <atomic>
+
 
 const QString QgsExpressionContext::EXPR_FIELDS( QStringLiteral( "_fields_" ) );
 const QString QgsExpressionContext::EXPR_ORIGINAL_VALUE( QStringLiteral( "value" ) );
@@ -52,8 +54,23 @@ const QString QgsExpressionContext::EXPR_CLUSTER_COLOR( QStringLiteral( "cluster
 // QgsExpressionContextScope
 //
 
+///@cond PRIVATE
+
+/**
+ * Returns a new scope version. Versions are unique across all scopes, so that a scope
+ * replaced by another one in a context is never mistaken for the original.
+ */
+static quint64 nextScopeVersion()
+{
+  static std::atomic< quint64 > sVersion( 0 );
+  return ++sVersion;
+}
+
+///@endcond
+
 QgsExpressionContextScope::QgsExpressionContextScope( const QString &name )
   : mName( name )
+  , mVersion( nextScopeVersion() )
 {
 
 }
@@ -61,8 +78,10 @@ QgsExpressionContextScope::QgsExpressionContextScope( const QString &name )
 QgsExpressionContextScope::QgsExpressionContextScope( const QgsExpressionContextScope &other )
   : mName( other.mName )
   , mVariables( other.mVariables )
+  , mVariableIndexes( other.mVariableIndexes )
   , mHasFeature( other.mHasFeature )
   , mFeature( other.mFeature )
+  , mVersion( other.mVersion )
 {
   QHash<QString, QgsScopedExpressionFunction * >::const_iterator it = other.mFunctions.constBegin();
   for ( ; it != other.mFunctions.constEnd(); ++it )
@@ -75,8 +94,10 @@ QgsExpressionContextScope &QgsExpressionContextScope::operator=( const QgsExpres
 {
   mName = other.mName;
   mVariables = other.mVariables;
+  mVariableIndexes = other.mVariableIndexes;
   mHasFeature = other.mHasFeature;
   mFeature = other.mFeature;
+  mVersion = other.mVersion;
 
   qDeleteAll( mFunctions );
   mFunctions.clear();
@@ -96,9 +117,10 @@ QgsExpressionContextScope::~QgsExpressionContextScope()
 
 void QgsExpressionContextScope::setVariable( const QString &name, const QVariant &value, bool isStatic )
 {
-  if ( mVariables.contains( name ) )
+  const int index = mVariableIndexes.value( name, -1 );
+  if ( index >= 0 )
   {
-    StaticVariable existing = mVariables.value( name );
+    StaticVariable existing = mVariables.at( index );
     existing.value = value;
     existing.isStatic = isStatic;
     addVariable( existing );
@@ -111,27 +133,50 @@ void QgsExpressionContextScope::setVariable( const QString &name, const QVariant
 
 void QgsExpressionContextScope::addVariable( const QgsExpressionContextScope::StaticVariable &variable )
 {
-  mVariables.insert( variable.name, variable );
+  QHash<QString, int>::const_iterator it = mVariableIndexes.constFind( variable.name );
+  if ( it != mVariableIndexes.constEnd() )
+  {
+    // replacing the value of an existing variable keeps lookups valid
+    mVariables[ it.value()] = variable;
+    return;
+  }
+
+  mVariableIndexes.insert( variable.name, mVariables.count() );
+  mVariables.append( variable );
+  mVersion = nextScopeVersion();
 }
 
 bool QgsExpressionContextScope::removeVariable( const QString &name )
 {
-  return mVariables.remove( name ) > 0;
+  const int index = mVariableIndexes.value( name, -1 );
+  if ( index < 0 )
+    return false;
+
+  mVariables.remove( index );
+  mVariableIndexes.remove( name );
+  for ( QHash<QString, int>::iterator it = mVariableIndexes.begin(); it != mVariableIndexes.end(); ++it )
+  {
+    if ( it.value() > index )
+      --it.value();
+  }
+  mVersion = nextScopeVersion();
+  return true;
 }
 
 bool QgsExpressionContextScope::hasVariable( const QString &name ) const
 {
-  return mVariables.contains( name );
+  return mVariableIndexes.contains( name );
 }
 
 QVariant QgsExpressionContextScope::variable( const QString &name ) const
 {
-  return hasVariable( name ) ? mVariables.value( name ).value : QVariant();
+  const int index = mVariableIndexes.value( name, -1 );
+  return index >= 0 ? mVariables.at( index ).value : QVariant();
 }
 
 QStringList QgsExpressionContextScope::variableNames() const
 {
-  QStringList names = mVariables.keys();
+  QStringList names = mVariableIndexes.keys();
   return names;
 }
 
@@ -164,7 +209,7 @@ class QgsExpressionContextVariableCompare
 
 QStringList QgsExpressionContextScope::filteredVariableNames() const
 {
-  QStringList allVariables = mVariables.keys();
+  QStringList allVariables = mVariableIndexes.keys();
   QStringList filtered;
   Q_FOREACH ( const QString &variable, allVariables )
   {
@@ -181,17 +226,20 @@ QStringList QgsExpressionContextScope::filteredVariableNames() const
 
 bool QgsExpressionContextScope::isReadOnly( const QString &name ) const
 {
-  return hasVariable( name ) ? mVariables.value( name ).readOnly : false;
+  const int index = mVariableIndexes.value( name, -1 );
+  return index >= 0 ? mVariables.at( index ).readOnly : false;
 }
 
 bool QgsExpressionContextScope::isStatic( const QString &name ) const
 {
-  return hasVariable( name ) ? mVariables.value( name ).isStatic : false;
+  const int index = mVariableIndexes.value( name, -1 );
+  return index >= 0 ? mVariables.at( index ).isStatic : false;
 }
 
 QString QgsExpressionContextScope::description( const QString &name ) const
 {
-  return hasVariable( name ) ? mVariables.value( name ).description : QString();
+  const int index = mVariableIndexes.value( name, -1 );
+  return index >= 0 ? mVariables.at( index ).description : QString();
 }
 
 bool QgsExpressionContextScope::hasFunction( const QString &name ) const
@@ -212,6 +260,7 @@ QStringList QgsExpressionContextScope::functionNames() const
 void QgsExpressionContextScope::addFunction( const QString &name, QgsScopedExpressionFunction *function )
 {
   mFunctions.insert( name, function );
+  mVersion = nextScopeVersion();
 }
 
 
@@ -290,6 +339,40 @@ QVariant QgsExpressionContext::variable( const QString &name ) const
   return scope ? scope->variable( name ) : QVariant();
 }
 
+QVariant QgsExpressionContext::variable( QgsExpressionContextVariableLookup &lookup ) const
+{
+  const int count = mStack.count();
+  bool valid = lookup.mScopeVersions.count() == count;
+  for ( int i = 0; valid && i < count; ++i )
+    valid = lookup.mScopeVersions.at( i ) == mStack.at( i )->mVersion;
+
+  if ( !valid )
+  {
+    // the scopes changed since the last lookup, resolve the variable again from the top of the stack
+    lookup.mScopeVersions.resize( count );
+    lookup.mScopeIndex = -1;
+    lookup.mVariableIndex = -1;
+    lookup.mVarFunctionOverridden = false;
+    for ( int i = count - 1; i >= 0; --i )
+    {
+      const QgsExpressionContextScope *scope = mStack.at( i );
+      lookup.mScopeVersions[i] = scope->mVersion;
+      lookup.mVarFunctionOverridden = lookup.mVarFunctionOverridden || scope->hasFunction( QStringLiteral( "var" ) );
+      if ( lookup.mScopeIndex < 0 )
+      {
+        const int index = scope->mVariableIndexes.value( lookup.mName, -1 );
+        if ( index >= 0 )
+        {
+          lookup.mScopeIndex = i;
+          lookup.mVariableIndex = index;
+        }
+      }
+    }
+  }
+
+  return lookup.mScopeIndex >= 0 ? mStack.at( lookup.mScopeIndex )->mVariables.at( lookup.mVariableIndex ).value : QVariant();
+}
+
 QVariantMap QgsExpressionContext::variablesToMap() const
 {
   QStringList names = variableNames();
@@ -493,6 +576,9 @@ void QgsExpressionContext::setFeature( const QgsFeature &feature )
     mStack.append( new QgsExpressionContextScope() );
 
   mStack.last()->setFeature( feature );
+
+  // function results only hold for the feature they were computed for
+  mFunctionResults.clear();
 }
 
 bool QgsExpressionContext::hasFeature() const
@@ -558,6 +644,103 @@ QVariant QgsExpressionContext::cachedValue( const QString &key ) const
 void QgsExpressionContext::clearCachedValues() const
 {
   mCachedValues.clear();
+  mFunctionResults.clear();
+}
+
+///@cond PRIVATE
+
+/**
+ * Builds the key identifying a call to the function called \a name with the argument \a values.
+ * Geometries are identified by the address of their shared data, which the cached arguments keep alive.
+ * Returns false if one of the values cannot be part of a key.
+ */
+static bool functionResultKey( const QString &name, const QVariantList &values, QString &key )
+{
+  key = name;
+  for ( const QVariant &value : values )
+  {
+    key += QChar( 0 );
+    if ( value.userType() == qMetaTypeId< QgsGeometry >() )
+    {
+      key += QStringLiteral( "geometry:%1" ).arg( reinterpret_cast< quintptr >( value.value< QgsGeometry >().constGet() ) );
+      continue;
+    }
+
+    switch ( value.type() )
+    {
+      case QVariant::Bool:
+      case QVariant::Int:
+      case QVariant::UInt:
+      case QVariant::LongLong:
+      case QVariant::ULongLong:
+      case QVariant::Double:
+      case QVariant::String:
+      case QVariant::Date:
+      case QVariant::Time:
+      case QVariant::DateTime:
+        key += value.isNull() ? QStringLiteral( "%1:null" ).arg( value.type() ) : QStringLiteral( "%1:%2" ).arg( value.type() ).arg( value.toString() );
+        break;
+
+      case QVariant::Invalid:
+        key += QStringLiteral( "null" );
+        break;
+
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+// features set through setFeature() always drop the cached results, this only catches
+// features set directly on a scope, and must stay cheap as it runs for every cached call
+static bool isSameFeature( const QgsFeature &feature1, const QgsFeature &feature2 )
+{
+  return feature1.id() == feature2.id()
+         && feature1.isValid() == feature2.isValid()
+         && feature1.geometry().constGet() == feature2.geometry().constGet();
+}
+
+///@endcond
+
+bool QgsExpressionContext::cachedFunctionResult( const QString &name, const QVariantList &values, QVariant &result ) const
+{
+  if ( mFunctionResults.isEmpty() )
+    return false;
+
+  if ( !isSameFeature( feature(), mFunctionResultsFeature ) )
+  {
+    mFunctionResults.clear();
+    return false;
+  }
+
+  QString key;
+  if ( !functionResultKey( name, values, key ) )
+    return false;
+
+  QHash< QString, QVariantList >::const_iterator it = mFunctionResults.constFind( key );
+  if ( it == mFunctionResults.constEnd() )
+    return false;
+
+  result = it.value().at( 0 );
+  return true;
+}
+
+void QgsExpressionContext::setCachedFunctionResult( const QString &name, const QVariantList &values, const QVariant &result ) const
+{
+  QString key;
+  if ( !functionResultKey( name, values, key ) )
+    return;
+
+  const QgsFeature currentFeature = feature();
+  if ( !isSameFeature( currentFeature, mFunctionResultsFeature ) )
+  {
+    mFunctionResults.clear();
+    mFunctionResultsFeature = currentFeature;
+  }
+
+  // the arguments are kept with the result, so that the geometries identified in the key stay alive
+  mFunctionResults.insert( key, QVariantList() << result << values );
 }
 
 
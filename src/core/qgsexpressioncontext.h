@@ -20,6 +20,7 @@
 #include "qgis.h"
 #include <QVariant>
 #include <QHash>
+#include <QVector>
 #include <QString>
 #include <QStringList>
 #include <QSet>
@@ -351,14 +352,71 @@ class CORE_EXPORT QgsExpressionContextScope
 
   private:
     QString mName;
-    QHash<QString, StaticVariable> mVariables;
+    QVector<StaticVariable> mVariables;
+    //! Index of each variable in mVariables
+    QHash<QString, int> mVariableIndexes;
     QHash<QString, QgsScopedExpressionFunction * > mFunctions;
     bool mHasFeature = false;
     QgsFeature mFeature;
 
+    //! Changes whenever variables or functions are added or removed
+    quint64 mVersion = 0;
+
     bool variableNameSort( const QString &a, const QString &b );
+
+    friend class QgsExpressionContext;
 };
 
+#ifndef SIP_RUN
+
+/**
+ * \ingroup core
+ * \class QgsExpressionContextVariableLookup
+ * \brief Resolved reference to a variable of a QgsExpressionContext.
+ *
+ * The first lookup finds the scope and the position within the scope which hold the
+ * variable. Later lookups reuse them for as long as no scope of the context has
+ * been added, removed, or has gained or lost variables or functions, so that reading
+ * the variable does not hash its name again. Changing the value of a variable does
+ * not invalidate the lookup.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.0
+ */
+class CORE_EXPORT QgsExpressionContextVariableLookup
+{
+  public:
+
+    /**
+     * Constructor for QgsExpressionContextVariableLookup, for the variable with the specified \a name.
+     */
+    explicit QgsExpressionContextVariableLookup( const QString &name )
+      : mName( name )
+    {}
+
+    /**
+     * Returns the name of the variable.
+     */
+    QString name() const { return mName; }
+
+    /**
+     * Returns true if a scope of the context used for the last lookup overrides the var()
+     * function, in which case variables should be read through that function instead.
+     */
+    bool isVarFunctionOverridden() const { return mVarFunctionOverridden; }
+
+  private:
+    QString mName;
+    QVector<quint64> mScopeVersions;
+    int mScopeIndex = -1;
+    int mVariableIndex = -1;
+    bool mVarFunctionOverridden = false;
+
+    friend class QgsExpressionContext;
+};
+
+#endif
+
 /**
  * \ingroup core
  * \class QgsExpressionContext
@@ -417,6 +475,16 @@ class CORE_EXPORT QgsExpressionContext
      */
     QVariant variable( const QString &name ) const;
 
+    /**
+     * Fetches the variable resolved by \a lookup from the context. The lookup is
+     * updated if the scopes of the context changed since it was last used, and can
+     * be reused with other contexts.
+     * \returns variable value if matching variable exists in the context, otherwise an invalid QVariant
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    QVariant variable( QgsExpressionContextVariableLookup &lookup ) const SIP_SKIP;
+
     /**
      * Returns a map of variable name to value representing all the expression variables
      * contained by the context.
@@ -689,6 +757,27 @@ class CORE_EXPORT QgsExpressionContext
      */
     void clearCachedValues() const;
 
+    /**
+     * Retrieves the \a result of a call to the function called \a name with the argument
+     * \a values, stored by setCachedFunctionResult() for the feature currently set in the context.
+     * Returns false if no such call was cached.
+     * \see setCachedFunctionResult()
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    bool cachedFunctionResult( const QString &name, const QVariantList &values, QVariant &result ) const SIP_SKIP;
+
+    /**
+     * Caches the \a result of a call to the function called \a name with the argument \a values,
+     * for the feature currently set in the context. Cached results are dropped as soon as a
+     * feature is set with setFeature(), or another feature is found in the context. Calls with
+     * arguments other than numbers, strings, dates and geometries are not cached.
+     * \see cachedFunctionResult()
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    void setCachedFunctionResult( const QString &name, const QVariantList &values, const QVariant &result ) const SIP_SKIP;
+
     //! Inbuilt variable name for fields storage
     static const QString EXPR_FIELDS;
     //! Inbuilt variable name for value original value variable
@@ -718,6 +807,10 @@ class CORE_EXPORT QgsExpressionContext
     // Cache is mutable because we want to be able to add cached values to const contexts
     mutable QMap< QString, QVariant > mCachedValues;
 
+    //! Cached function results for mFunctionResultsFeature, each followed by the function arguments
+    mutable QHash< QString, QVariantList > mFunctionResults;
+    mutable QgsFeature mFunctionResultsFeature;
+
 };
 
 /**
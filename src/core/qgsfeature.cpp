@@ -65,7 +65,7 @@ bool QgsFeature::operator ==( const QgsFeature &other ) const
   if ( d->fid == other.d->fid
        && d->valid == other.d->valid
        && d->fields == other.d->fields
-       && d->attributes == other.d->attributes
+       && attributes() == other.attributes()
        && d->geometry.equals( other.d->geometry ) )
     return true;
 
@@ -95,6 +95,7 @@ QgsFeatureId QgsFeature::id() const
 void QgsFeature::deleteAttribute( int field )
 {
   d.detach();
+  d->resolveLazyAttributes();
   d->attributes.remove( field );
 }
 
@@ -121,19 +122,45 @@ void QgsFeature::setId( QgsFeatureId id )
 
 QgsAttributes QgsFeature::attributes() const
 {
-  return d->attributes;
+  if ( !d->lazyAttributes )
+    return d->attributes;
+
+  // the shared data is never modified here, copies of the feature may be read from
+  // other threads. The decoded values are kept by the lazy attributes themselves
+  QgsAttributes attributes( d->attributes );
+  d->lazyAttributes->resolve( attributes, d->lazyMask );
+  return attributes;
 }
 
 void QgsFeature::setAttributes( const QgsAttributes &attrs )
 {
-  if ( attrs == d->attributes )
+  if ( !d->lazyAttributes && attrs == d->attributes )
     return;
 
   d.detach();
   d->attributes = attrs;
+  d->lazyAttributes.reset();
+  d->lazyMask.clear();
   d->valid = true;
 }
 
+void QgsFeature::setLazyAttributes( int count, QgsAttributeDecoder *decoder )
+{
+  d.detach();
+  d->attributes.resize( count );
+  QVariant *ptr = d->attributes.data();
+  for ( int i = 0; i < count; ++i, ++ptr )
+    ptr->clear();
+  d->lazyAttributes = std::make_shared< QgsLazyAttributes >( count, decoder );
+  d->lazyMask = QBitArray( count, true );
+  d->valid = true;
+}
+
+int QgsFeature::attributeCount() const
+{
+  return d->attributes.size();
+}
+
 void QgsFeature::setGeometry( const QgsGeometry &geometry )
 {
   d.detach();
@@ -195,6 +222,8 @@ bool QgsFeature::hasGeometry() const
 void QgsFeature::initAttributes( int fieldCount )
 {
   d.detach();
+  d->lazyAttributes.reset();
+  d->lazyMask.clear();
   d->attributes.resize( fieldCount );
   QVariant *ptr = d->attributes.data();
   for ( int i = 0; i < fieldCount; ++i, ++ptr )
@@ -211,6 +240,8 @@ bool QgsFeature::setAttribute( int idx, const QVariant &value )
 
   d.detach();
   d->attributes[idx] = value;
+  if ( d->lazyAttributes )
+    d->lazyMask.clearBit( idx );
   d->valid = true;
   return true;
 }
@@ -229,6 +260,8 @@ bool QgsFeature::setAttribute( const QString &name, const QVariant &value )
 
   d.detach();
   d->attributes[fieldIdx] = value;
+  if ( d->lazyAttributes )
+    d->lazyMask.clearBit( fieldIdx );
   d->valid = true;
   return true;
 }
@@ -241,6 +274,8 @@ bool QgsFeature::deleteAttribute( const QString &name )
 
   d.detach();
   d->attributes[fieldIdx].clear();
+  if ( d->lazyAttributes )
+    d->lazyMask.clearBit( fieldIdx );
   return true;
 }
 
@@ -249,7 +284,7 @@ QVariant QgsFeature::attribute( int fieldIdx ) const
   if ( fieldIdx < 0 || fieldIdx >= d->attributes.count() )
     return QVariant();
 
-  return d->attributes.at( fieldIdx );
+  return d->attribute( fieldIdx );
 }
 
 QVariant QgsFeature::attribute( const QString &name ) const
@@ -258,7 +293,7 @@ QVariant QgsFeature::attribute( const QString &name ) const
   if ( fieldIdx == -1 )
     return QVariant();
 
-  return d->attributes.at( fieldIdx );
+  return d->attribute( fieldIdx );
 }
 
 /***************************************************************************
@@ -30,6 +30,7 @@ email                : sherman at mrcc.com
 #include "qgsattributes.h"
 #include "qgsfields.h"
 
+class QgsAttributeDecoder;
 class QgsFeature;
 class QgsFeaturePrivate;
 class QgsField;
@@ -84,15 +85,14 @@ class CORE_EXPORT QgsFeature
 
     SIP_PYOBJECT __getitem__( int key );
     % MethodCode
-    QgsAttributes attrs = sipCpp->attributes();
-    if ( a0 < 0 || a0 >= attrs.count() )
+    if ( a0 < 0 || a0 >= sipCpp->attributeCount() )
     {
       PyErr_SetString( PyExc_KeyError, QByteArray::number( a0 ) );
       sipIsErr = 1;
     }
     else
     {
-      QVariant *v = new QVariant( attrs.at( a0 ) );
+      QVariant *v = new QVariant( sipCpp->attribute( a0 ) );
       sipRes = sipConvertFromNewType( v, sipType_QVariant, Py_None );
     }
     % End
@@ -155,7 +155,7 @@ class CORE_EXPORT QgsFeature
 
     void __delitem__( int key );
     % MethodCode
-    if ( a0 >= 0 && a0 < sipCpp->attributes().count() )
+    if ( a0 >= 0 && a0 < sipCpp->attributeCount() )
       sipCpp->deleteAttribute( a0 );
     else
     {
@@ -252,6 +252,24 @@ class CORE_EXPORT QgsFeature
      */
     void setAttributes( const QgsAttributes &attrs );
 
+    /**
+     * Sets \a count attributes, whose values are only decoded by \a decoder when they are
+     * first accessed. This lets providers hand over the raw data of a feature, so that
+     * the attributes which are never read are never converted. Ownership of \a decoder
+     * is transferred, it is shared by the copies of the feature.
+     * The feature will be valid after.
+     * \note not available in Python bindings
+     * \see setAttributes()
+     * \since QGIS 3.0
+     */
+    void setLazyAttributes( int count, QgsAttributeDecoder *decoder SIP_TRANSFER ) SIP_SKIP;
+
+    /**
+     * Returns the number of attributes attached to the feature.
+     * \since QGIS 3.0
+     */
+    int attributeCount() const;
+
     /**
      * Set an attribute's value by field index.
      * The feature will be valid if it was successful.
@@ -304,7 +322,7 @@ class CORE_EXPORT QgsFeature
     void deleteAttribute( int field );
 #ifdef SIP_RUN
     % MethodCode
-    if ( a0 >= 0 && a0 < sipCpp->attributes().count() )
+    if ( a0 >= 0 && a0 < sipCpp->attributeCount() )
       sipCpp->deleteAttribute( a0 );
     else
     {
@@ -483,7 +501,7 @@ class CORE_EXPORT QgsFeature
     SIP_PYOBJECT attribute( int fieldIdx ) const;
     % MethodCode
     {
-      if ( a0 < 0 || a0 >= sipCpp->attributes().count() )
+      if ( a0 < 0 || a0 >= sipCpp->attributeCount() )
       {
         PyErr_SetString( PyExc_KeyError, QByteArray::number( a0 ) );
         sipIsErr = 1;
@@ -518,6 +536,33 @@ class CORE_EXPORT QgsFeature
 
 }; // class QgsFeature
 
+#ifndef SIP_RUN
+
+/**
+ * \ingroup core
+ * Decodes the attribute values of a feature from the raw data of a provider.
+ *
+ * Values are decoded when they are first accessed, and then cached by the feature.
+ * decode() is only called once for each attribute, but it may be called from any
+ * thread which holds a copy of the feature.
+ * \see QgsFeature::setLazyAttributes()
+ * \note not available in Python bindings
+ * \since QGIS 3.0
+ */
+class CORE_EXPORT QgsAttributeDecoder
+{
+  public:
+
+    virtual ~QgsAttributeDecoder() = default;
+
+    /**
+     * Returns the value of the attribute at \a index.
+     */
+    virtual QVariant decode( int index ) const = 0;
+};
+
+#endif
+
 //! Writes the feature to stream out. QGIS version compatibility is not guaranteed.
 CORE_EXPORT QDataStream &operator<<( QDataStream &out, const QgsFeature &feature )  SIP_SKIP;
 //! Reads a feature from stream in into feature. QGIS version compatibility is not guaranteed.
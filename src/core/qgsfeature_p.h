@@ -33,10 +33,70 @@ email                : nyall dot dawson at gmail dot com
  * See details in QEP #17
  ****************************************************************************/
 
+#include "qgsfeature.h"
 #include "qgsfields.h"
 
 #include "qgsgeometry.h"
 
+#include <QBitArray>
+#include <QMutex>
+
+#include <memory>
+
+/**
+ * Attribute values decoded on first access, shared by all the copies of a feature.
+ */
+class QgsLazyAttributes
+{
+  public:
+
+    QgsLazyAttributes( int count, QgsAttributeDecoder *decoder )
+      : decoder( decoder )
+      , values( count )
+      , decoded( count )
+    {
+    }
+
+    QVariant value( int index )
+    {
+      QMutexLocker locker( &mutex );
+      return decodedValue( index );
+    }
+
+    //! Copies into \a attributes the values of the attributes set in \a mask
+    void resolve( QgsAttributes &attributes, const QBitArray &mask )
+    {
+      QMutexLocker locker( &mutex );
+      for ( int i = 0; i < attributes.size(); ++i )
+      {
+        if ( mask.testBit( i ) )
+          attributes[i] = decodedValue( i );
+      }
+    }
+
+    std::unique_ptr< QgsAttributeDecoder > decoder;
+    QMutex mutex;
+    QgsAttributes values;
+    QBitArray decoded;
+    int decodedCount = 0;
+
+  private:
+
+    //! Must be called with the mutex locked
+    const QVariant &decodedValue( int index )
+    {
+      if ( !decoded.testBit( index ) )
+      {
+        values[index] = decoder->decode( index );
+        decoded.setBit( index );
+        // the source of the values is not needed anymore once they are all decoded
+        if ( ++decodedCount == values.size() )
+          decoder.reset();
+      }
+      return values.at( index );
+    }
+};
+
 class QgsFeaturePrivate : public QSharedData
 {
   public:
@@ -54,7 +114,28 @@ class QgsFeaturePrivate : public QSharedData
       , geometry( other.geometry )
       , valid( other.valid )
       , fields( other.fields )
+      , lazyAttributes( other.lazyAttributes )
+      , lazyMask( other.lazyMask )
+    {
+    }
+
+    //! Returns the value of an attribute, decoding it if needed
+    QVariant attribute( int index ) const
     {
+      if ( lazyAttributes && lazyMask.testBit( index ) )
+        return lazyAttributes->value( index );
+      return attributes.at( index );
+    }
+
+    //! Decodes the attributes which were not accessed yet, and drops the decoder
+    void resolveLazyAttributes()
+    {
+      if ( !lazyAttributes )
+        return;
+
+      lazyAttributes->resolve( attributes, lazyMask );
+      lazyAttributes.reset();
+      lazyMask.clear();
     }
 
     ~QgsFeaturePrivate()
@@ -76,6 +157,12 @@ class QgsFeaturePrivate : public QSharedData
     //! Optional field map for name-based attribute lookups
     QgsFields fields;
 
+    //! Source of the attributes which were not set since the feature was read
+    std::shared_ptr< QgsLazyAttributes > lazyAttributes;
+
+    //! Attributes whose value comes from lazyAttributes
+    QBitArray lazyMask;
+
 };
 
 /// @endcond
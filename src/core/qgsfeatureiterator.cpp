@@ -19,6 +19,8 @@
 #include "qgsexception.h"
 #include "qgsexpressionsorter.h"
 
+#include <algorithm>
+
 QgsAbstractFeatureIterator::QgsAbstractFeatureIterator( const QgsFeatureRequest &request )
   : mRequest( request )
 {
@@ -71,6 +73,46 @@ bool QgsAbstractFeatureIterator::nextFeature( QgsFeature &f )
   return dataOk;
 }
 
+int QgsAbstractFeatureIterator::nextFeatures( QVector<QgsFeature> &features, int maxFeatures )
+{
+  if ( mRequest.limit() >= 0 )
+    maxFeatures = static_cast< int >( std::min< long >( maxFeatures, mRequest.limit() - mFetchedCount ) );
+
+  if ( maxFeatures <= 0 )
+  {
+    features.clear();
+    return 0;
+  }
+
+  features.resize( maxFeatures );
+
+  int count = 0;
+  if ( !mUseCachedFeatures &&
+       mRequest.filterType() != QgsFeatureRequest::FilterExpression &&
+       mRequest.filterType() != QgsFeatureRequest::FilterFids )
+  {
+    // nothing to check on the fetched features, let the iterator fill the whole block
+    count = fetchFeatures( features, maxFeatures );
+    mFetchedCount += count;
+  }
+  else
+  {
+    while ( count < maxFeatures && nextFeature( features[count] ) )
+      ++count;
+  }
+
+  features.resize( count );
+  return count;
+}
+
+int QgsAbstractFeatureIterator::fetchFeatures( QVector<QgsFeature> &features, int maxFeatures )
+{
+  int count = 0;
+  while ( count < maxFeatures && fetchFeature( features[count] ) )
+    ++count;
+  return count;
+}
+
 bool QgsAbstractFeatureIterator::nextFeatureFilterExpression( QgsFeature &f )
 {
   while ( fetchFeature( f ) )
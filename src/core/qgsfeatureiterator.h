@@ -46,6 +46,16 @@ class CORE_EXPORT QgsAbstractFeatureIterator
     //! fetch next feature, return true on success
     virtual bool nextFeature( QgsFeature &f );
 
+    /**
+     * Fetches up to \a maxFeatures features into \a features, and returns the
+     * number of fetched features. The vector is resized to this number, it may
+     * be reused across calls to avoid reallocations. A return value of 0 means
+     * that the iteration has finished.
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    int nextFeatures( QVector<QgsFeature> &features, int maxFeatures ) SIP_SKIP;
+
     //! reset the iterator to the starting position
     virtual bool rewind() = 0;
     //! end of iterating: free the resources / lock
@@ -94,6 +104,20 @@ class CORE_EXPORT QgsAbstractFeatureIterator
      */
     virtual bool fetchFeature( QgsFeature &f ) = 0;
 
+    /**
+     * Fetches up to \a maxFeatures features into the first elements of
+     * \a features, which holds at least \a maxFeatures elements. Returns the
+     * number of fetched features.
+     *
+     * This is used by nextFeatures() when the request has no filter to check
+     * on the fetched features. The default implementation calls fetchFeature()
+     * for each feature, iterators which retrieve features by blocks may
+     * reimplement it to hand over a whole block at once.
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    virtual int fetchFeatures( QVector<QgsFeature> &features, int maxFeatures ) SIP_SKIP;
+
     /**
      * By default, the iterator will fetch all features and check if the feature
      * matches the expression.
@@ -290,6 +314,20 @@ class CORE_EXPORT QgsFeatureIterator
     QgsFeatureIterator &operator=( const QgsFeatureIterator &other );
 
     bool nextFeature( QgsFeature &f );
+
+    /**
+     * Fetches up to \a maxFeatures features into \a features, and returns the
+     * number of fetched features. The vector is resized to this number, it may
+     * be reused across calls to avoid reallocations. A return value of 0 means
+     * that the iteration has finished.
+     *
+     * This avoids the overhead of a nextFeature() call for each feature when
+     * iterating over many features.
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    int nextFeatures( QVector<QgsFeature> &features, int maxFeatures ) SIP_SKIP;
+
     bool rewind();
     bool close();
 
@@ -359,6 +397,16 @@ inline bool QgsFeatureIterator::nextFeature( QgsFeature &f )
   return mIter ? mIter->nextFeature( f ) : false;
 }
 
+inline int QgsFeatureIterator::nextFeatures( QVector<QgsFeature> &features, int maxFeatures )
+{
+  if ( !mIter )
+  {
+    features.clear();
+    return 0;
+  }
+  return mIter->nextFeatures( features, maxFeatures );
+}
+
 inline bool QgsFeatureIterator::rewind()
 {
   if ( mIter )
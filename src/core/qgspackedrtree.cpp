@@ -0,0 +1,403 @@
+/***************************************************************************
+                         qgspackedrtree.cpp
+                         ------------------
+    begin                : December 2017
+    copyright            : (C) 2017 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgspackedrtree.h"
+
+#include <QDataStream>
+#include <QPair>
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+
+static const quint32 PACKED_RTREE_MAGIC = 0x51505254; // "QPRT"
+static const quint32 PACKED_RTREE_VERSION = 2;
+
+//! Minimum number of entries per thread when building the tree in parallel
+static const int PARALLEL_BUILD_CHUNK = 65536;
+
+///@cond PRIVATE
+
+// position of (x, y) along a Hilbert curve filling a 65536 x 65536 grid
+// see "Fast Hilbert curve generation" by rawrunprotected (public domain)
+static quint32 hilbertIndex( quint32 x, quint32 y )
+{
+  quint32 a = x ^ y;
+  quint32 b = 0xFFFF ^ a;
+  quint32 c = 0xFFFF ^ ( x | y );
+  quint32 d = x & ( y ^ 0xFFFF );
+
+  quint32 A = a | ( b >> 1 );
+  quint32 B = ( a >> 1 ) ^ a;
+  quint32 C = ( ( c >> 1 ) ^ ( b & ( d >> 1 ) ) ) ^ c;
+  quint32 D = ( ( a & ( c >> 1 ) ) ^ ( d >> 1 ) ) ^ d;
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  A = ( ( a & ( a >> 2 ) ) ^ ( b & ( b >> 2 ) ) );
+  B = ( ( a & ( b >> 2 ) ) ^ ( b & ( ( a ^ b ) >> 2 ) ) );
+  C ^= ( ( a & ( c >> 2 ) ) ^ ( b & ( d >> 2 ) ) );
+  D ^= ( ( b & ( c >> 2 ) ) ^ ( ( a ^ b ) & ( d >> 2 ) ) );
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  A = ( ( a & ( a >> 4 ) ) ^ ( b & ( b >> 4 ) ) );
+  B = ( ( a & ( b >> 4 ) ) ^ ( b & ( ( a ^ b ) >> 4 ) ) );
+  C ^= ( ( a & ( c >> 4 ) ) ^ ( b & ( d >> 4 ) ) );
+  D ^= ( ( b & ( c >> 4 ) ) ^ ( ( a ^ b ) & ( d >> 4 ) ) );
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  C ^= ( ( a & ( c >> 8 ) ) ^ ( b & ( d >> 8 ) ) );
+  D ^= ( ( b & ( c >> 8 ) ) ^ ( ( a ^ b ) & ( d >> 8 ) ) );
+
+  a = C ^ ( C >> 1 );
+  b = D ^ ( D >> 1 );
+
+  quint32 i0 = x ^ y;
+  quint32 i1 = b | ( 0xFFFF ^ ( i0 | a ) );
+
+  i0 = ( i0 | ( i0 << 8 ) ) & 0x00FF00FF;
+  i0 = ( i0 | ( i0 << 4 ) ) & 0x0F0F0F0F;
+  i0 = ( i0 | ( i0 << 2 ) ) & 0x33333333;
+  i0 = ( i0 | ( i0 << 1 ) ) & 0x55555555;
+
+  i1 = ( i1 | ( i1 << 8 ) ) & 0x00FF00FF;
+  i1 = ( i1 | ( i1 << 4 ) ) & 0x0F0F0F0F;
+  i1 = ( i1 | ( i1 << 2 ) ) & 0x33333333;
+  i1 = ( i1 | ( i1 << 1 ) ) & 0x55555555;
+
+  return ( i1 << 1 ) | i0;
+}
+
+// end positions of the levels of a tree of itemCount entries, from the leaves up to the root
+static QVector<int> treeLevelBounds( int itemCount, int nodeSize )
+{
+  QVector<int> levelBounds;
+  if ( itemCount <= 0 )
+    return levelBounds;
+
+  qint64 nodeCount = itemCount;
+  qint64 levelCount = itemCount;
+  levelBounds << itemCount;
+  do
+  {
+    levelCount = ( levelCount + nodeSize - 1 ) / nodeSize;
+    nodeCount += levelCount;
+    levelBounds << static_cast< int >( std::min< qint64 >( nodeCount, std::numeric_limits<int>::max() ) );
+  }
+  while ( levelCount != 1 );
+  return levelBounds;
+}
+
+///@endcond
+
+QgsPackedRTree::QgsPackedRTree( int nodeSize )
+  : mNodeSize( std::max( 2, nodeSize ) )
+{
+}
+
+void QgsPackedRTree::add( QgsFeatureId id, const QgsRectangle &bounds )
+{
+  Q_ASSERT( !mFinished );
+
+  mBoxes << bounds.xMinimum() << bounds.yMinimum() << bounds.xMaximum() << bounds.yMaximum();
+  mIndices << id;
+  mItemCount++;
+}
+
+void QgsPackedRTree::finish()
+{
+  if ( mFinished )
+    return;
+
+  mFinished = true;
+  mLevelBounds.clear();
+  if ( mItemCount == 0 )
+    return;
+
+  // number of nodes of each level, up to a single root
+  mLevelBounds = treeLevelBounds( mItemCount, mNodeSize );
+  const int nodeCount = mLevelBounds.last();
+
+  // sort the entries along the Hilbert curve
+  double minX = std::numeric_limits<double>::max();
+  double minY = std::numeric_limits<double>::max();
+  double maxX = -std::numeric_limits<double>::max();
+  double maxY = -std::numeric_limits<double>::max();
+  for ( int i = 0; i < mItemCount; ++i )
+  {
+    minX = std::min( minX, mBoxes.at( 4 * i ) );
+    minY = std::min( minY, mBoxes.at( 4 * i + 1 ) );
+    maxX = std::max( maxX, mBoxes.at( 4 * i + 2 ) );
+    maxY = std::max( maxY, mBoxes.at( 4 * i + 3 ) );
+  }
+
+  // large trees are sorted by chunks on all the cores, then the chunks are merged
+  QVector< QPair< int, int > > chunks;
+  const int chunkSize = std::max( PARALLEL_BUILD_CHUNK, ( mItemCount + QThread::idealThreadCount() - 1 ) / std::max( 1, QThread::idealThreadCount() ) );
+  for ( int start = 0; start < mItemCount; start += chunkSize )
+    chunks << qMakePair( start, std::min( start + chunkSize, mItemCount ) );
+
+  const double width = maxX - minX;
+  const double height = maxY - minY;
+  const double hilbertMax = 0xFFFF;
+  QVector<quint32> hilbertValues( mItemCount );
+  QVector<int> order( mItemCount );
+  std::iota( order.begin(), order.end(), 0 );
+  // each chunk only touches its own part of the arrays
+  quint32 *hilbert = hilbertValues.data();
+  int *orderData = order.data();
+  const double *itemBoxes = mBoxes.constData();
+  auto sortChunk = [ = ]( const QPair< int, int > &chunk )
+  {
+    for ( int i = chunk.first; i < chunk.second; ++i )
+    {
+      const double cx = ( itemBoxes[4 * i] + itemBoxes[4 * i + 2] ) / 2;
+      const double cy = ( itemBoxes[4 * i + 1] + itemBoxes[4 * i + 3] ) / 2;
+      const quint32 x = width > 0 ? static_cast< quint32 >( std::floor( hilbertMax * ( cx - minX ) / width ) ) : 0;
+      const quint32 y = height > 0 ? static_cast< quint32 >( std::floor( hilbertMax * ( cy - minY ) / height ) ) : 0;
+      hilbert[i] = hilbertIndex( x, y );
+    }
+    std::sort( orderData + chunk.first, orderData + chunk.second, [hilbert]( int a, int b ) { return hilbert[a] < hilbert[b]; } );
+  };
+  if ( chunks.size() > 1 )
+    QtConcurrent::blockingMap( chunks, sortChunk );
+  else
+    sortChunk( chunks.at( 0 ) );
+
+  for ( int merged = chunkSize; merged < mItemCount; merged *= 2 )
+  {
+    for ( int start = 0; start + merged < mItemCount; start += 2 * merged )
+    {
+      std::inplace_merge( order.begin() + start, order.begin() + start + merged, order.begin() + std::min( start + 2 * merged, mItemCount ),
+                          [hilbert]( int a, int b ) { return hilbert[a] < hilbert[b]; } );
+    }
+  }
+
+  QVector<double> boxes( 4 * nodeCount );
+  QVector<qint64> indices( nodeCount );
+  for ( int i = 0; i < mItemCount; ++i )
+  {
+    const int item = order.at( i );
+    std::copy( mBoxes.constBegin() + 4 * item, mBoxes.constBegin() + 4 * item + 4, boxes.begin() + 4 * i );
+    indices[i] = mIndices.at( item );
+  }
+
+  // build the parent nodes level by level
+  int pos = 0;
+  int parent = mItemCount;
+  for ( int level = 0; level < mLevelBounds.size() - 1; ++level )
+  {
+    const int end = mLevelBounds.at( level );
+    while ( pos < end )
+    {
+      const int firstChild = pos;
+      double nodeMinX = std::numeric_limits<double>::max();
+      double nodeMinY = std::numeric_limits<double>::max();
+      double nodeMaxX = -std::numeric_limits<double>::max();
+      double nodeMaxY = -std::numeric_limits<double>::max();
+      for ( int j = 0; j < mNodeSize && pos < end; ++j, ++pos )
+      {
+        nodeMinX = std::min( nodeMinX, boxes.at( 4 * pos ) );
+        nodeMinY = std::min( nodeMinY, boxes.at( 4 * pos + 1 ) );
+        nodeMaxX = std::max( nodeMaxX, boxes.at( 4 * pos + 2 ) );
+        nodeMaxY = std::max( nodeMaxY, boxes.at( 4 * pos + 3 ) );
+      }
+      boxes[4 * parent] = nodeMinX;
+      boxes[4 * parent + 1] = nodeMinY;
+      boxes[4 * parent + 2] = nodeMaxX;
+      boxes[4 * parent + 3] = nodeMaxY;
+      indices[parent] = firstChild;
+      parent++;
+    }
+  }
+
+  mBoxes = boxes;
+  mIndices = indices;
+}
+
+QList<QgsFeatureId> QgsPackedRTree::intersects( const QgsRectangle &rect ) const
+{
+  QList<QgsFeatureId> results;
+  if ( !mFinished || mItemCount == 0 )
+    return results;
+
+  const double minX = rect.xMinimum();
+  const double minY = rect.yMinimum();
+  const double maxX = rect.xMaximum();
+  const double maxY = rect.yMaximum();
+
+  // first node of a group of siblings, and its level
+  QVector< QPair< int, int > > stack;
+  int nodeIndex = mIndices.size() - 1;
+  int level = mLevelBounds.size() - 1;
+
+  const double *boxes = mBoxes.constData();
+  for ( ;; )
+  {
+    const int end = std::min( nodeIndex + mNodeSize, mLevelBounds.at( level ) );
+    for ( int pos = nodeIndex; pos < end; ++pos )
+    {
+      const double *box = boxes + 4 * pos;
+      if ( maxX < box[0] || maxY < box[1] || minX > box[2] || minY > box[3] )
+        continue;
+
+      if ( nodeIndex < mItemCount )
+        results << mIndices.at( pos );
+      else
+        stack << qMakePair( static_cast< int >( mIndices.at( pos ) ), level - 1 );
+    }
+
+    if ( stack.isEmpty() )
+      break;
+
+    nodeIndex = stack.last().first;
+    level = stack.last().second;
+    stack.removeLast();
+  }
+
+  return results;
+}
+
+QList<QgsFeatureId> QgsPackedRTree::nearestNeighbor( const QgsPointXY &point, int neighbors ) const
+{
+  QList<QgsFeatureId> results;
+  if ( !mFinished || mItemCount == 0 || neighbors <= 0 )
+    return results;
+
+  // distance, position and level of the nodes still to visit, closest first
+  typedef std::pair< double, std::pair< int, int > > QueueEntry;
+  std::priority_queue< QueueEntry, std::vector< QueueEntry >, std::greater< QueueEntry > > queue;
+  queue.push( QueueEntry( 0, std::make_pair( mIndices.size() - 1, mLevelBounds.size() - 1 ) ) );
+
+  const double *boxes = mBoxes.constData();
+  double lastDistance = 0;
+  while ( !queue.empty() )
+  {
+    const QueueEntry entry = queue.top();
+    // entries at the same distance as the last neighbor are also returned
+    if ( results.size() >= neighbors && entry.first > lastDistance )
+      break;
+    queue.pop();
+
+    const int pos = entry.second.first;
+    const int level = entry.second.second;
+    if ( pos < mItemCount )
+    {
+      results << mIndices.at( pos );
+      lastDistance = entry.first;
+      continue;
+    }
+
+    const int first = static_cast< int >( mIndices.at( pos ) );
+    const int end = std::min( first + mNodeSize, mLevelBounds.at( level - 1 ) );
+    for ( int child = first; child < end; ++child )
+    {
+      const double *box = boxes + 4 * child;
+      const double dx = std::max( std::max( box[0] - point.x(), point.x() - box[2] ), 0.0 );
+      const double dy = std::max( std::max( box[1] - point.y(), point.y() - box[3] ), 0.0 );
+      queue.push( QueueEntry( std::sqrt( dx * dx + dy * dy ), std::make_pair( child, level - 1 ) ) );
+    }
+  }
+
+  return results;
+}
+
+QgsFeatureId QgsPackedRTree::entryId( int index ) const
+{
+  return mIndices.at( index );
+}
+
+QgsRectangle QgsPackedRTree::entryBounds( int index ) const
+{
+  return QgsRectangle( mBoxes.at( 4 * index ), mBoxes.at( 4 * index + 1 ), mBoxes.at( 4 * index + 2 ), mBoxes.at( 4 * index + 3 ) );
+}
+
+void QgsPackedRTree::write( QDataStream &stream ) const
+{
+  const QDataStream::FloatingPointPrecision precision = stream.floatingPointPrecision();
+  stream.setFloatingPointPrecision( QDataStream::DoublePrecision );
+
+  stream << PACKED_RTREE_MAGIC << PACKED_RTREE_VERSION
+         << static_cast< qint32 >( mNodeSize ) << static_cast< qint32 >( mItemCount )
+         << mLevelBounds << mBoxes << mIndices;
+
+  stream.setFloatingPointPrecision( precision );
+}
+
+bool QgsPackedRTree::read( QDataStream &stream )
+{
+  const QDataStream::FloatingPointPrecision precision = stream.floatingPointPrecision();
+  stream.setFloatingPointPrecision( QDataStream::DoublePrecision );
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  qint32 nodeSize = 0;
+  qint32 itemCount = 0;
+  QVector<int> levelBounds;
+  QVector<double> boxes;
+  QVector<qint64> indices;
+  stream >> magic >> version;
+  if ( magic == PACKED_RTREE_MAGIC && version == PACKED_RTREE_VERSION )
+    stream >> nodeSize >> itemCount >> levelBounds >> boxes >> indices;
+
+  stream.setFloatingPointPrecision( precision );
+
+  if ( stream.status() != QDataStream::Ok || magic != PACKED_RTREE_MAGIC || version != PACKED_RTREE_VERSION )
+    return false;
+
+  // consistency checks, so that a truncated or corrupted stream cannot lead to out of bounds accesses
+  if ( nodeSize < 2 || itemCount < 0 || itemCount > indices.size() || boxes.size() != 4 * indices.size() )
+    return false;
+
+  // the layout of the levels only depends on the number of entries and the node size
+  if ( levelBounds != treeLevelBounds( itemCount, nodeSize ) )
+    return false;
+  if ( ( levelBounds.isEmpty() && !indices.isEmpty() ) || ( !levelBounds.isEmpty() && levelBounds.last() != indices.size() ) )
+    return false;
+
+  // and each node must point to the first of its children, as laid out by finish()
+  for ( int level = 1; level < levelBounds.size(); ++level )
+  {
+    const qint64 childrenStart = level == 1 ? 0 : levelBounds.at( level - 2 );
+    const int levelStart = levelBounds.at( level - 1 );
+    for ( int pos = levelStart; pos < levelBounds.at( level ); ++pos )
+    {
+      if ( indices.at( pos ) != childrenStart + static_cast< qint64 >( pos - levelStart ) * nodeSize )
+        return false;
+    }
+  }
+
+  mNodeSize = nodeSize;
+  mItemCount = itemCount;
+  mLevelBounds = levelBounds;
+  mBoxes = boxes;
+  mIndices = indices;
+  mFinished = true;
+  return true;
+}
@@ -0,0 +1,131 @@
+/***************************************************************************
+                         qgspackedrtree.h
+                         ----------------
+    begin                : December 2017
+    copyright            : (C) 2017 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPACKEDRTREE_H
+#define QGSPACKEDRTREE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeature.h"
+#include "qgspointxy.h"
+#include "qgsrectangle.h"
+
+#include <QList>
+#include <QVector>
+
+class QDataStream;
+
+/**
+ * \ingroup core
+ * Immutable R-tree packed along a Hilbert curve.
+ *
+ * Entries are first added with add(), then finish() sorts them by the Hilbert
+ * value of their center and builds the tree bottom up. Nodes are stored in
+ * flat arrays of bounding boxes, which makes the tree compact, fast to build
+ * and cheap to write to disk. Large trees are sorted on all the available cores.
+ *
+ * The tree cannot be modified once finished. As it is never modified, a
+ * finished tree can be queried from several threads at once.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.0
+ */
+class CORE_EXPORT QgsPackedRTree
+{
+  public:
+
+    /**
+     * Constructor for QgsPackedRTree, with at most \a nodeSize children per node.
+     */
+    explicit QgsPackedRTree( int nodeSize = 16 );
+
+    /**
+     * Adds an entry with the given \a id and \a bounds. Must be called before finish().
+     */
+    void add( QgsFeatureId id, const QgsRectangle &bounds );
+
+    /**
+     * Builds the tree from the added entries.
+     */
+    void finish();
+
+    /**
+     * Returns true if the tree was built, and can be queried.
+     */
+    bool isFinished() const { return mFinished; }
+
+    /**
+     * Returns the number of entries in the tree.
+     */
+    int count() const { return mItemCount; }
+
+    /**
+     * Returns the ids of the entries whose bounds intersect \a rect. Ids are
+     * returned in the order of the tree, not sorted.
+     */
+    QList<QgsFeatureId> intersects( const QgsRectangle &rect ) const;
+
+    /**
+     * Returns the ids of the \a neighbors entries whose bounds are the closest
+     * to \a point, closest first. Entries at the same distance as the last
+     * neighbor are also returned.
+     */
+    QList<QgsFeatureId> nearestNeighbor( const QgsPointXY &point, int neighbors ) const;
+
+    /**
+     * Returns the id of the entry at \a index, between 0 and count() - 1.
+     * Entries are in the order of the tree once finished.
+     * \see entryBounds()
+     */
+    QgsFeatureId entryId( int index ) const;
+
+    /**
+     * Returns the bounds of the entry at \a index, between 0 and count() - 1.
+     * \see entryId()
+     */
+    QgsRectangle entryBounds( int index ) const;
+
+    /**
+     * Writes the finished tree to a \a stream.
+     * \see read()
+     */
+    void write( QDataStream &stream ) const;
+
+    /**
+     * Reads a tree written by write() from a \a stream.
+     * \returns false if the stream does not contain a valid tree
+     */
+    bool read( QDataStream &stream );
+
+  private:
+
+    int mNodeSize = 16;
+    int mItemCount = 0;
+    bool mFinished = false;
+
+    //! Bounding boxes of the nodes, leaves first then each level up to the root (4 values per node)
+    QVector<double> mBoxes;
+
+    //! Entry id for leaves, position of the first child for other nodes
+    QVector<qint64> mIndices;
+
+    //! End position of the nodes of each level
+    QVector<int> mLevelBounds;
+};
+
+#endif // QGSPACKEDRTREE_H
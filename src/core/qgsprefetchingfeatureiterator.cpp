@@ -0,0 +1,221 @@
+/***************************************************************************
+                         qgsprefetchingfeatureiterator.cpp
+                         ---------------------------------
+    begin                : December 2017
+    copyright            : (C) 2017 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsprefetchingfeatureiterator.h"
+#include "qgsfeedback.h"
+
+#include <QThread>
+
+#include <functional>
+
+//! Number of features handed over to the consumer at once
+static const int PREFETCH_BATCH_SIZE = 256;
+
+//! Maximum number of batches waiting for the consumer
+static const int PREFETCH_MAX_BATCHES = 8;
+
+///@cond PRIVATE
+class QgsFeaturePrefetchThread : public QThread
+{
+  public:
+    explicit QgsFeaturePrefetchThread( const std::function< void() > &function )
+      : mFunction( function )
+    {}
+
+  protected:
+    void run() override
+    {
+      mFunction();
+    }
+
+  private:
+    std::function< void() > mFunction;
+};
+///@endcond
+
+QgsPrefetchingFeatureIterator::QgsPrefetchingFeatureIterator( QgsAbstractFeatureSource *source, const QgsFeatureRequest &request )
+  : QgsAbstractFeatureIterator( QgsFeatureRequest() )
+  , mSource( source )
+  , mSourceRequest( request )
+  , mFeedback( nullptr )
+  , mStopRequested( false )
+{
+  mSourceRequest.setFlags( mSourceRequest.flags() & ~QgsFeatureRequest::PrefetchFeatures );
+  startPrefetching();
+}
+
+QgsPrefetchingFeatureIterator::~QgsPrefetchingFeatureIterator()
+{
+  close();
+}
+
+bool QgsPrefetchingFeatureIterator::rewind()
+{
+  if ( mClosed )
+    return false;
+
+  stopPrefetching();
+  startPrefetching();
+  return true;
+}
+
+bool QgsPrefetchingFeatureIterator::close()
+{
+  if ( mClosed )
+    return false;
+
+  stopPrefetching();
+  mClosed = true;
+  return true;
+}
+
+void QgsPrefetchingFeatureIterator::setInterruptionChecker( QgsFeedback *interruptionChecker )
+{
+  mFeedback = interruptionChecker;
+}
+
+bool QgsPrefetchingFeatureIterator::isValid() const
+{
+  return mValid && mSourceValid;
+}
+
+bool QgsPrefetchingFeatureIterator::fetchFeature( QgsFeature &f )
+{
+  f.setValid( false );
+
+  if ( mClosed )
+    return false;
+
+  if ( mCurrentIndex >= mCurrentBatch.size() )
+  {
+    QMutexLocker locker( &mMutex );
+    while ( mBatches.isEmpty() && !mSourceFinished )
+      mBatchAvailable.wait( &mMutex );
+
+    if ( mBatches.isEmpty() )
+    {
+      locker.unlock();
+      close();
+      return false;
+    }
+
+    mCurrentBatch = mBatches.dequeue();
+    mCurrentIndex = 0;
+    mSpaceAvailable.wakeOne();
+  }
+
+  f = mCurrentBatch.at( mCurrentIndex++ );
+  return true;
+}
+
+void QgsPrefetchingFeatureIterator::startPrefetching()
+{
+  mStopRequested = false;
+  mSourceReady = false;
+  mSourceFinished = false;
+
+  mThread = new QgsFeaturePrefetchThread( [this] { prefetch(); } );
+  mThread->start();
+
+  // wait for the source iterator, so that isValid() is meaningful
+  QMutexLocker locker( &mMutex );
+  while ( !mSourceReady )
+    mBatchAvailable.wait( &mMutex );
+}
+
+void QgsPrefetchingFeatureIterator::stopPrefetching()
+{
+  if ( !mThread )
+    return;
+
+  {
+    QMutexLocker locker( &mMutex );
+    mStopRequested = true;
+    mSpaceAvailable.wakeAll();
+  }
+
+  mThread->wait();
+  delete mThread;
+  mThread = nullptr;
+
+  mBatches.clear();
+  mCurrentBatch.clear();
+  mCurrentIndex = 0;
+}
+
+void QgsPrefetchingFeatureIterator::prefetch()
+{
+  QgsFeatureIterator it = mSource->getFeatures( mSourceRequest );
+
+  {
+    QMutexLocker locker( &mMutex );
+    mSourceValid = it.isValid();
+    mSourceReady = true;
+    mBatchAvailable.wakeAll();
+  }
+
+  QgsFeedback *feedback = nullptr;
+  QVector<QgsFeature> batch;
+  batch.reserve( PREFETCH_BATCH_SIZE );
+
+  QgsFeature f;
+  while ( !mStopRequested )
+  {
+    if ( feedback != mFeedback )
+    {
+      feedback = mFeedback;
+      it.setInterruptionChecker( feedback );
+    }
+    if ( feedback && feedback->isCanceled() )
+      break;
+
+    if ( !it.nextFeature( f ) )
+      break;
+
+    batch << f;
+    if ( batch.size() == PREFETCH_BATCH_SIZE )
+    {
+      if ( !pushBatch( batch ) )
+        break;
+
+      batch.clear();
+      batch.reserve( PREFETCH_BATCH_SIZE );
+    }
+  }
+  it.close();
+
+  if ( !batch.isEmpty() )
+    pushBatch( batch );
+
+  QMutexLocker locker( &mMutex );
+  mSourceFinished = true;
+  mBatchAvailable.wakeAll();
+}
+
+bool QgsPrefetchingFeatureIterator::pushBatch( const QVector<QgsFeature> &batch )
+{
+  QMutexLocker locker( &mMutex );
+  while ( mBatches.size() >= PREFETCH_MAX_BATCHES && !mStopRequested )
+    mSpaceAvailable.wait( &mMutex );
+
+  if ( mStopRequested )
+    return false;
+
+  mBatches.enqueue( batch );
+  mBatchAvailable.wakeOne();
+  return true;
+}
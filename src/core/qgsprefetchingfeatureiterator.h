@@ -0,0 +1,101 @@
+/***************************************************************************
+                         qgsprefetchingfeatureiterator.h
+                         -------------------------------
+    begin                : December 2017
+    copyright            : (C) 2017 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPREFETCHINGFEATUREITERATOR_H
+#define QGSPREFETCHINGFEATUREITERATOR_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeatureiterator.h"
+
+#include <QMutex>
+#include <QQueue>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <memory>
+
+class QThread;
+
+/**
+ * \ingroup core
+ * Feature iterator which fetches the features of a source on a background
+ * thread, while the consumer processes the features already fetched.
+ *
+ * The source iterator is created and iterated on its own thread. Features are
+ * handed over to the consumer in batches through a bounded queue, so that
+ * the latency of network and disk bound providers is hidden behind the work
+ * done with the previous features.
+ *
+ * This iterator is used when the QgsFeatureRequest::PrefetchFeatures flag is
+ * set on a request.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.0
+ */
+class CORE_EXPORT QgsPrefetchingFeatureIterator : public QgsAbstractFeatureIterator
+{
+  public:
+
+    /**
+     * Constructor for QgsPrefetchingFeatureIterator, fetching the features
+     * matching \a request from \a source. Ownership of \a source is transferred
+     * to the iterator.
+     */
+    QgsPrefetchingFeatureIterator( QgsAbstractFeatureSource *source, const QgsFeatureRequest &request );
+
+    ~QgsPrefetchingFeatureIterator() override;
+
+    bool rewind() override;
+    bool close() override;
+    void setInterruptionChecker( QgsFeedback *interruptionChecker ) override;
+    bool isValid() const override;
+
+  protected:
+    bool fetchFeature( QgsFeature &f ) override;
+
+  private:
+
+    void startPrefetching();
+    void stopPrefetching();
+    void prefetch();
+    bool pushBatch( const QVector<QgsFeature> &batch );
+
+    std::unique_ptr< QgsAbstractFeatureSource > mSource;
+
+    //! Request of the source iterator, filtering, ordering and limit are applied there
+    QgsFeatureRequest mSourceRequest;
+
+    QThread *mThread = nullptr;
+    std::atomic<QgsFeedback *> mFeedback;
+    std::atomic<bool> mStopRequested;
+
+    QMutex mMutex;
+    QWaitCondition mBatchAvailable;
+    QWaitCondition mSpaceAvailable;
+    QQueue< QVector<QgsFeature> > mBatches;
+    bool mSourceReady = false;
+    bool mSourceValid = true;
+    bool mSourceFinished = false;
+
+    QVector<QgsFeature> mCurrentBatch;
+    int mCurrentIndex = 0;
+};
+
+#endif // QGSPREFETCHINGFEATUREITERATOR_H
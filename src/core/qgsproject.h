@@ -93,6 +93,18 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
     Q_PROPERTY( QList<QgsVectorLayer *> avoidIntersectionsLayers READ avoidIntersectionsLayers WRITE setAvoidIntersectionsLayers NOTIFY avoidIntersectionsLayersChanged )
 
   public:
+
+    /**
+     * Flags which control project read behavior.
+     * \since QGIS 3.0
+     */
+    enum ReadFlag
+    {
+      FlagTrustLayerMetadata = 1 << 0, //!< Trust layer metadata (extent, primary key unicity), whatever the project's trust setting is
+      FlagDontLoadLayouts = 1 << 1, //!< Don't load print layouts. Improves project read time if layouts are not required.
+    };
+    Q_DECLARE_FLAGS( ReadFlags, ReadFlag )
+
     //! Returns the QgsProject singleton instance
     static QgsProject *instance();
 
@@ -211,15 +223,17 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
     /**
      * Reads given project file from the given file.
      * \param filename name of project file to read
+     * \param flags optional flags which control the read behavior of projects (since QGIS 3.0)
      * \returns true if project file has been read successfully
      */
-    bool read( const QString &filename );
+    bool read( const QString &filename, QgsProject::ReadFlags flags = QgsProject::ReadFlags() );
 
     /**
      * Reads the project from its currently associated file (see fileName() ).
+     * \param flags optional flags which control the read behavior of projects (since QGIS 3.0)
      * \returns true if project file has been read successfully
      */
-    bool read();
+    bool read( QgsProject::ReadFlags flags = QgsProject::ReadFlags() );
 
     /**
      * Reads the layer described in the associated DOM node.
@@ -1143,13 +1157,13 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
     void loadEmbeddedNodes( QgsLayerTreeGroup *group ) SIP_SKIP;
 
     //! Read .qgs file
-    bool readProjectFile( const QString &filename );
+    bool readProjectFile( const QString &filename, QgsProject::ReadFlags flags );
 
     //! Write .qgs file
     bool writeProjectFile( const QString &filename );
 
     //! Unzip .qgz file then read embedded .qgs file
-    bool unzip( const QString &filename );
+    bool unzip( const QString &filename, QgsProject::ReadFlags flags );
 
     //! Zip project
     bool zip( const QString &filename );
@@ -1203,9 +1217,14 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
     bool mDirty = false;                 // project has been modified since it has been read or saved
     bool mTrustLayerMetadata = false;
 
+    //! Flags of the project read in progress, reset once the project is read
+    QgsProject::ReadFlags mReadFlags = QgsProject::ReadFlags();
+
     QgsCoordinateTransformContext mTransformContext;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS( QgsProject::ReadFlags )
+
 /**
  * Return the version string found in the given DOM document
    \returns the version string or an empty string if none found
@@ -22,10 +22,14 @@
 #include "qgslogger.h"
 #include "qgsfeaturesource.h"
 #include "qgsfeedback.h"
+#include "qgspackedrtree.h"
 
 #include "SpatialIndex.h"
 #include <QMutex>
 #include <QMutexLocker>
+#include <QtConcurrentMap>
+
+#include <numeric>
 
 using namespace SpatialIndex;
 
@@ -90,67 +94,41 @@ class QgsSpatialIndexCopyVisitor : public SpatialIndex::IVisitor
 
 /**
  * \ingroup core
- * \class QgsFeatureIteratorDataStream
- * \brief Utility class for bulk loading of R-trees. Not a part of public API.
+ * \class QgsPackedRTreeDataStream
+ * \brief Utility class for bulk loading an R-tree with the entries of a packed tree. Not a part of public API.
  * \note not available in Python bindings
 */
-class QgsFeatureIteratorDataStream : public IDataStream
+class QgsPackedRTreeDataStream : public IDataStream
 {
   public:
-    //! constructor - needs to load all data to a vector for later access when bulk loading
-    explicit QgsFeatureIteratorDataStream( const QgsFeatureIterator &fi, QgsFeedback *feedback = nullptr )
-      : mFi( fi )
-      , mFeedback( feedback )
-    {
-      readNextEntry();
-    }
-
-    ~QgsFeatureIteratorDataStream() override
+    explicit QgsPackedRTreeDataStream( const QgsPackedRTree &tree )
+      : mTree( tree )
     {
-      delete mNextData;
     }
 
     //! returns a pointer to the next entry in the stream or 0 at the end of the stream.
     IData *getNext() override
     {
-      if ( mFeedback && mFeedback->isCanceled() )
+      if ( mIndex >= mTree.count() )
         return nullptr;
 
-      RTree::Data *ret = mNextData;
-      mNextData = nullptr;
-      readNextEntry();
-      return ret;
+      const QgsRectangle rect = mTree.entryBounds( mIndex );
+      const QgsFeatureId id = mTree.entryId( mIndex++ );
+      return new RTree::Data( 0, nullptr, QgsSpatialIndex::rectToRegion( rect ), FID_TO_NUMBER( id ) );
     }
 
     //! returns true if there are more items in the stream.
-    bool hasNext() override { return nullptr != mNextData; }
+    bool hasNext() override { return mIndex < mTree.count(); }
 
     //! returns the total number of entries available in the stream.
-    uint32_t size() override { Q_ASSERT( false && "not available" ); return 0; }
+    uint32_t size() override { return static_cast< uint32_t >( mTree.count() ); }
 
     //! sets the stream pointer to the first entry, if possible.
-    void rewind() override { Q_ASSERT( false && "not available" ); }
-
-  protected:
-    void readNextEntry()
-    {
-      QgsFeature f;
-      SpatialIndex::Region r;
-      QgsFeatureId id;
-      while ( mFi.nextFeature( f ) )
-      {
-        if ( QgsSpatialIndex::featureInfo( f, r, id ) )
-        {
-          mNextData = new RTree::Data( 0, nullptr, r, id );
-          return;
-        }
-      }
-    }
+    void rewind() override { mIndex = 0; }
 
   private:
-    QgsFeatureIterator mFi;
-    RTree::Data *mNextData = nullptr;
-    QgsFeedback *mFeedback = nullptr;
+    const QgsPackedRTree &mTree;
+    int mIndex = 0;
 };
 
 
@@ -177,9 +155,21 @@ class QgsSpatialIndexData : public QSharedData
      * that of the spatial index construction.
      */
     explicit QgsSpatialIndexData( const QgsFeatureIterator &fi, QgsFeedback *feedback = nullptr )
+      : mPackedTree( qgis::make_unique< QgsPackedRTree >() )
     {
-      QgsFeatureIteratorDataStream fids( fi, feedback );
-      initTree( &fids );
+      QgsFeatureIterator it( fi );
+      QgsFeature f;
+      QgsRectangle rect;
+      QgsFeatureId id;
+      while ( it.nextFeature( f ) )
+      {
+        if ( feedback && feedback->isCanceled() )
+          break;
+
+        if ( QgsSpatialIndex::featureInfo( f, rect, id ) )
+          mPackedTree->add( id, rect );
+      }
+      mPackedTree->finish();
     }
 
     QgsSpatialIndexData( const QgsSpatialIndexData &other )
@@ -187,6 +177,13 @@ class QgsSpatialIndexData : public QSharedData
     {
       QMutexLocker locker( &other.mMutex );
 
+      if ( other.mPackedTree )
+      {
+        // the packed tree is immutable, the copy can be used as is
+        mPackedTree = qgis::make_unique< QgsPackedRTree >( *other.mPackedTree );
+        return;
+      }
+
       initTree();
 
       // copy R-tree data one by one (is there a faster way??)
@@ -203,6 +200,27 @@ class QgsSpatialIndexData : public QSharedData
       delete mStorage;
     }
 
+    /**
+     * Converts a bulk loaded index to an R-tree, which can be modified.
+     * The mutex must be locked.
+     */
+    void ensureRTree()
+    {
+      if ( !mPackedTree )
+        return;
+
+      if ( mPackedTree->count() > 0 )
+      {
+        QgsPackedRTreeDataStream stream( *mPackedTree );
+        initTree( &stream );
+      }
+      else
+      {
+        initTree();
+      }
+      mPackedTree.reset();
+    }
+
     QgsSpatialIndexData &operator=( const QgsSpatialIndexData &rh ) = delete;
 
     void initTree( IDataStream *inputStream = nullptr )
@@ -234,6 +252,9 @@ class QgsSpatialIndexData : public QSharedData
     //! R-tree containing spatial index
     SpatialIndex::ISpatialIndex *mRTree = nullptr;
 
+    //! Bulk loaded index, used instead of the R-tree until the index is modified
+    std::unique_ptr< QgsPackedRTree > mPackedTree;
+
     mutable QMutex mMutex;
 
 };
@@ -318,6 +339,7 @@ bool QgsSpatialIndex::insertFeature( QgsFeatureId id, const QgsRectangle &rect )
   // TODO: handle possible exceptions correctly
   try
   {
+    d->ensureRTree();
     d->mRTree->insertData( 0, nullptr, r, FID_TO_NUMBER( id ) );
     return true;
   }
@@ -347,6 +369,7 @@ bool QgsSpatialIndex::deleteFeature( const QgsFeature &f )
     return false;
 
   QMutexLocker locker( &d->mMutex );
+  d->ensureRTree();
   // TODO: handle exceptions
   return d->mRTree->deleteData( r, FID_TO_NUMBER( id ) );
 }
@@ -359,11 +382,41 @@ QList<QgsFeatureId> QgsSpatialIndex::intersects( const QgsRectangle &rect ) cons
   SpatialIndex::Region r = rectToRegion( rect );
 
   QMutexLocker locker( &d->mMutex );
+  if ( d->mPackedTree )
+    return d->mPackedTree->intersects( rect );
+
   d->mRTree->intersectsWithQuery( r, visitor );
 
   return list;
 }
 
+QVector< QList<QgsFeatureId> > QgsSpatialIndex::intersects( const QVector<QgsRectangle> &rectangles ) const
+{
+  QVector< QList<QgsFeatureId> > results( rectangles.size() );
+
+  QMutexLocker locker( &d->mMutex );
+  if ( d->mPackedTree )
+  {
+    // the packed tree is never modified, so it can be queried from several threads
+    const QgsPackedRTree *tree = d->mPackedTree.get();
+    QList<QgsFeatureId> *resultsData = results.data();
+    QVector<int> queries( rectangles.size() );
+    std::iota( queries.begin(), queries.end(), 0 );
+    QtConcurrent::blockingMap( queries, [tree, resultsData, &rectangles]( int i )
+    {
+      resultsData[i] = tree->intersects( rectangles.at( i ) );
+    } );
+    return results;
+  }
+
+  for ( int i = 0; i < rectangles.size(); ++i )
+  {
+    QgisVisitor visitor( results[i] );
+    d->mRTree->intersectsWithQuery( rectToRegion( rectangles.at( i ) ), visitor );
+  }
+  return results;
+}
+
 QList<QgsFeatureId> QgsSpatialIndex::nearestNeighbor( const QgsPointXY &point, int neighbors ) const
 {
   QList<QgsFeatureId> list;
@@ -373,6 +426,9 @@ QList<QgsFeatureId> QgsSpatialIndex::nearestNeighbor( const QgsPointXY &point, i
   Point p( pt, 2 );
 
   QMutexLocker locker( &d->mMutex );
+  if ( d->mPackedTree )
+    return d->mPackedTree->nearestNeighbor( point, neighbors );
+
   d->mRTree->nearestNeighborQuery( neighbors, p, visitor );
 
   return list;
@@ -42,6 +42,7 @@ class QgsPointXY;
 #include "qgis_sip.h"
 #include <QList>
 #include <QSharedDataPointer>
+#include <QVector>
 
 #include "qgsfeature.h"
 
@@ -77,6 +78,9 @@ class CORE_EXPORT QgsSpatialIndex
      * Constructor - creates R-tree and bulk loads it with features from the iterator.
      * This is much faster approach than creating an empty index and then inserting features one by one.
      *
+     * Bulk loaded indexes are packed in flat arrays, which use much less memory and are faster
+     * to query. They are converted to a regular R-tree the first time a feature is inserted or deleted.
+     *
      * The optional \a feedback object can be used to allow cancelation of bulk feature loading. Ownership
      * of \a feedback is not transferred, and callers must take care that the lifetime of feedback exceeds
      * that of the spatial index construction.
@@ -138,6 +142,17 @@ class CORE_EXPORT QgsSpatialIndex
      */
     QList<QgsFeatureId> intersects( const QgsRectangle &rectangle ) const;
 
+    /**
+     * Returns the lists of features with a bounding box which intersects each of the specified
+     * \a rectangles, in the same order as the rectangles.
+     *
+     * The queries of bulk loaded indexes are run in parallel.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.0
+     */
+    QVector< QList<QgsFeatureId> > intersects( const QVector<QgsRectangle> &rectangles ) const SIP_SKIP;
+
     /**
      * Returns nearest neighbors to a \a point. The number of neighbours returned is specified
      * by the \a neighbours argument.
@@ -177,7 +192,8 @@ class CORE_EXPORT QgsSpatialIndex
      */
     static bool featureInfo( const QgsFeature &f, QgsRectangle &rect, QgsFeatureId &id );
 
-    friend class QgsFeatureIteratorDataStream; // for access to featureInfo()
+    friend class QgsSpatialIndexData; // for access to featureInfo()
+    friend class QgsPackedRTreeDataStream; // for access to rectToRegion()
 
   private:
 
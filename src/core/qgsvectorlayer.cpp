@@ -59,6 +59,7 @@
 #include "qgsogcutils.h"
 #include "qgspainting.h"
 #include "qgspointxy.h"
+#include "qgsprefetchingfeatureiterator.h"
 #include "qgsproject.h"
 #include "qgsproviderregistry.h"
 #include "qgsrectangle.h"
@@ -919,6 +920,9 @@ QgsFeatureIterator QgsVectorLayer::getFeatures( const QgsFeatureRequest &request
   if ( !mValid || !mDataProvider )
     return QgsFeatureIterator();
 
+  if ( request.flags() & QgsFeatureRequest::PrefetchFeatures )
+    return QgsFeatureIterator( new QgsPrefetchingFeatureIterator( new QgsVectorLayerFeatureSource( this ), request ) );
+
   return QgsFeatureIterator( new QgsVectorLayerFeatureIterator( new QgsVectorLayerFeatureSource( this ), true, request ) );
 }
 
@@ -13,11 +13,45 @@
  *                                                                         *
  ***************************************************************************/
 #include "qgsvectorlayerfeaturecounter.h"
+#include "qgsprefetchingfeatureiterator.h"
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+
+//! Number of features counted at once by each thread
+static const int COUNT_BATCH_SIZE = 1000;
+
+///@cond PRIVATE
+struct QgsFeatureCountJob
+{
+  QgsFeatureRenderer *renderer = nullptr;
+  QgsRenderContext context;
+  const QVector<QgsFeature> *features = nullptr;
+  int begin = 0;
+  int end = 0;
+  QHash<QString, long> counts;
+};
+
+static void countFeatures( QgsFeatureCountJob &job )
+{
+  for ( int i = job.begin; i < job.end; ++i )
+  {
+    const QgsFeature &f = job.features->at( i );
+    job.context.expressionContext().setFeature( f );
+    const QSet<QString> featureKeyList = job.renderer->legendKeysForFeature( f, job.context );
+    for ( const QString &key : featureKeyList )
+    {
+      job.counts[key] += 1;
+    }
+  }
+}
+///@endcond
 
 QgsVectorLayerFeatureCounter::QgsVectorLayerFeatureCounter( QgsVectorLayer *layer, const QgsExpressionContext &context )
   : QgsTask( tr( "Counting features in %1" ).arg( layer->name() ), QgsTask::CanCancel )
   , mSource( new QgsVectorLayerFeatureSource( layer ) )
-  , mRenderer( layer->renderer()->clone() )
   , mExpressionContext( context )
   , mFeatureCount( layer->featureCount() )
 {
@@ -25,11 +59,16 @@ QgsVectorLayerFeatureCounter::QgsVectorLayerFeatureCounter( QgsVectorLayer *laye
   {
     mExpressionContext = layer->createExpressionContext();
   }
+
+  // renderers are not thread safe, each counting thread uses its own clone
+  const int threadCount = mFeatureCount > COUNT_BATCH_SIZE ? std::max( 1, QThread::idealThreadCount() ) : 1;
+  for ( int i = 0; i < threadCount; ++i )
+    mRenderers.emplace_back( layer->renderer()->clone() );
 }
 
 bool QgsVectorLayerFeatureCounter::run()
 {
-  QgsLegendSymbolList symbolList = mRenderer->legendSymbolItems();
+  QgsLegendSymbolList symbolList = mRenderers.front()->legendSymbolItems();
   QgsLegendSymbolList::const_iterator symbolIt = symbolList.constBegin();
 
   for ( ; symbolIt != symbolList.constEnd(); ++symbolIt )
@@ -47,28 +86,47 @@ bool QgsVectorLayerFeatureCounter::run()
     renderContext.setRendererScale( 0 );
     renderContext.setExpressionContext( mExpressionContext );
 
+    const QgsFields fields = mSource->fields();
     QgsFeatureRequest request;
-    if ( !mRenderer->filterNeedsGeometry() )
+    if ( !mRenderers.front()->filterNeedsGeometry() )
       request.setFlags( QgsFeatureRequest::NoGeometry );
-    request.setSubsetOfAttributes( mRenderer->usedAttributes( renderContext ), mSource->fields() );
-    QgsFeatureIterator fit = mSource->getFeatures( request );
+    request.setSubsetOfAttributes( mRenderers.front()->usedAttributes( renderContext ), fields );
+
+    // the next features are read in the background while the current ones are counted
+    QgsFeatureIterator fit( new QgsPrefetchingFeatureIterator( mSource.release(), request ) );
 
     // TODO: replace QgsInterruptionChecker with QgsFeedback
     // fit.setInterruptionChecker( mFeedback );
 
-    mRenderer->startRender( renderContext, mSource->fields() );
+    QVector<QgsFeatureCountJob> jobs( static_cast< int >( mRenderers.size() ) );
+    for ( int i = 0; i < jobs.size(); ++i )
+    {
+      QgsFeatureCountJob &job = jobs[i];
+      job.renderer = mRenderers.at( i ).get();
+      job.context = renderContext;
+      job.renderer->startRender( job.context, fields );
+    }
 
+    // each thread counts a part of every batch of features
+    QVector<QgsFeature> features;
     double progress = 0;
-    QgsFeature f;
-    while ( fit.nextFeature( f ) )
+    bool canceled = false;
+    int count = 0;
+    while ( ( count = fit.nextFeatures( features, jobs.size() * COUNT_BATCH_SIZE ) ) > 0 )
     {
-      renderContext.expressionContext().setFeature( f );
-      QSet<QString> featureKeyList = mRenderer->legendKeysForFeature( f, renderContext );
-      Q_FOREACH ( const QString &key, featureKeyList )
+      const int jobSize = ( count + jobs.size() - 1 ) / jobs.size();
+      for ( int i = 0; i < jobs.size(); ++i )
       {
-        mSymbolFeatureCountMap[key] += 1;
+        jobs[i].features = &features;
+        jobs[i].begin = std::min( i * jobSize, count );
+        jobs[i].end = std::min( ( i + 1 ) * jobSize, count );
       }
-      ++featuresCounted;
+      if ( count > COUNT_BATCH_SIZE )
+        QtConcurrent::blockingMap( jobs, countFeatures );
+      else
+        countFeatures( jobs[0] );
+
+      featuresCounted += count;
 
       double p = ( static_cast< double >( featuresCounted ) / mFeatureCount ) * 100;
       if ( p - progress > 1 )
@@ -79,11 +137,20 @@ bool QgsVectorLayerFeatureCounter::run()
 
       if ( isCanceled() )
       {
-        mRenderer->stopRender( renderContext );
-        return false;
+        canceled = true;
+        break;
       }
     }
-    mRenderer->stopRender( renderContext );
+
+    for ( QgsFeatureCountJob &job : jobs )
+    {
+      job.renderer->stopRender( job.context );
+      for ( auto it = job.counts.constBegin(); it != job.counts.constEnd(); ++it )
+        mSymbolFeatureCountMap[it.key()] += it.value();
+    }
+
+    if ( canceled )
+      return false;
   }
 
   setProgress( 100 );
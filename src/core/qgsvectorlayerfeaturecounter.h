@@ -20,6 +20,9 @@
 #include "qgsrenderer.h"
 #include "qgstaskmanager.h"
 
+#include <memory>
+#include <vector>
+
 /**
  * \ingroup core
  *
@@ -66,7 +69,9 @@ class CORE_EXPORT QgsVectorLayerFeatureCounter : public QgsTask
 
   private:
     std::unique_ptr<QgsVectorLayerFeatureSource> mSource;
-    std::unique_ptr<QgsFeatureRenderer> mRenderer;
+
+    //! One renderer for each counting thread
+    std::vector< std::unique_ptr<QgsFeatureRenderer> > mRenderers;
     QgsExpressionContext mExpressionContext;
     QHash<QString, long> mSymbolFeatureCountMap;
     int mFeatureCount;
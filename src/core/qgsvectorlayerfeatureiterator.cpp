@@ -27,6 +27,11 @@
 #include "qgsmessagelog.h"
 #include "qgsexception.h"
 
+#include <algorithm>
+
+//! Number of provider features read ahead to resolve their joins with a single request
+static const int JOIN_BATCH_SIZE = 1000;
+
 QgsVectorLayerFeatureSource::QgsVectorLayerFeatureSource( const QgsVectorLayer *layer )
 {
   QMutexLocker locker( &layer->mFeatureSourceConstructorMutex );
@@ -327,18 +332,8 @@ bool QgsVectorLayerFeatureIterator::fetchFeature( QgsFeature &f )
     mProviderIterator.setInterruptionChecker( mInterruptionChecker );
   }
 
-  while ( mProviderIterator.nextFeature( f ) )
+  while ( nextProviderFeature( f ) )
   {
-    if ( mFetchConsidered.contains( f.id() ) )
-      continue;
-
-    // TODO[MD]: just one resize of attributes
-    f.setFields( mSource->mFields );
-
-    // update attributes
-    if ( mSource->mHasEditBuffer )
-      updateChangedAttributes( f );
-
     if ( mHasVirtualAttributes )
       addVirtualAttributes( f );
 
@@ -370,6 +365,45 @@ bool QgsVectorLayerFeatureIterator::fetchFeature( QgsFeature &f )
 }
 
 
+int QgsVectorLayerFeatureIterator::fetchFeatures( QVector<QgsFeature> &features, int maxFeatures )
+{
+  if ( mClosed )
+    return 0;
+
+  if ( mSource->mHasEditBuffer || mHasVirtualAttributes || mRequest.filterType() == QgsFeatureRequest::FilterFid )
+    return QgsAbstractFeatureIterator::fetchFeatures( features, maxFeatures );
+
+  if ( mProviderIterator.isClosed() )
+  {
+    mProviderIterator = mSource->mProviderFeatureSource->getFeatures( mProviderRequest );
+    mProviderIterator.setInterruptionChecker( mInterruptionChecker );
+  }
+
+  int count = 0;
+  while ( count < maxFeatures )
+  {
+    if ( mProviderIterator.nextFeatures( mProviderBlock, maxFeatures - count ) == 0 )
+    {
+      // no more provider features
+      close();
+      break;
+    }
+
+    for ( QgsFeature &f : mProviderBlock )
+    {
+      f.setFields( mSource->mFields );
+      if ( !postProcessFeature( f ) )
+      {
+        // aborted on an invalid geometry
+        if ( mClosed )
+          return count;
+        continue;
+      }
+      features[count++] = f;
+    }
+  }
+  return count;
+}
 
 bool QgsVectorLayerFeatureIterator::rewind()
 {
@@ -383,6 +417,8 @@ bool QgsVectorLayerFeatureIterator::rewind()
   else
   {
     mProviderIterator.rewind();
+    mFeatureBatch.clear();
+    mJoinBatchCache.clear();
     rewindEditBuffer();
   }
 
@@ -395,6 +431,8 @@ bool QgsVectorLayerFeatureIterator::close()
     return false;
 
   mProviderIterator.close();
+  mFeatureBatch.clear();
+  mJoinBatchCache.clear();
 
   iteratorClosed();
 
@@ -413,6 +451,93 @@ bool QgsVectorLayerFeatureIterator::isValid() const
   return mProviderIterator.isValid();
 }
 
+bool QgsVectorLayerFeatureIterator::nextProviderFeature( QgsFeature &f )
+{
+  if ( mBatchJoins )
+  {
+    if ( mFeatureBatch.isEmpty() )
+      fetchNextBatch();
+
+    if ( mFeatureBatch.isEmpty() )
+      return false;
+
+    f = mFeatureBatch.dequeue();
+    return true;
+  }
+
+  while ( mProviderIterator.nextFeature( f ) )
+  {
+    if ( mFetchConsidered.contains( f.id() ) )
+      continue;
+
+    // TODO[MD]: just one resize of attributes
+    f.setFields( mSource->mFields );
+
+    // update attributes
+    if ( mSource->mHasEditBuffer )
+      updateChangedAttributes( f );
+
+    return true;
+  }
+  return false;
+}
+
+void QgsVectorLayerFeatureIterator::fetchNextBatch()
+{
+  mJoinBatchCache.clear();
+
+  // don't read ahead past the features the request can still return
+  long batchSize = JOIN_BATCH_SIZE;
+  if ( mRequest.limit() >= 0 )
+    batchSize = std::max< long >( 1, std::min< long >( batchSize, mRequest.limit() - mFetchedCount ) );
+
+  QgsFeature f;
+  while ( mFeatureBatch.size() < batchSize && mProviderIterator.nextFeature( f ) )
+  {
+    if ( mFetchConsidered.contains( f.id() ) )
+      continue;
+
+    f.setFields( mSource->mFields );
+
+    if ( mSource->mHasEditBuffer )
+      updateChangedAttributes( f );
+
+    mFeatureBatch.enqueue( f );
+  }
+
+  if ( mFeatureBatch.isEmpty() )
+    return;
+
+  for ( const FetchJoinInfo &info : qgis::as_const( mOrderedJoinInfoList ) )
+  {
+    // joins driven by virtual fields are resolved feature by feature
+    if ( !info.joinInfo->cachedAttributes.isEmpty() || !mSource->mFields.exists( info.targetField ) )
+      continue;
+    const QgsFields::FieldOrigin origin = mSource->mFields.fieldOrigin( info.targetField );
+    if ( origin == QgsFields::OriginJoin || origin == QgsFields::OriginExpression )
+      continue;
+
+    QSet<QString> keys;
+    QList<QVariant> joinValues;
+    for ( const QgsFeature &feature : qgis::as_const( mFeatureBatch ) )
+    {
+      const QVariant value = feature.attribute( info.targetField );
+      if ( value.isNull() )
+        continue;
+
+      const QString key = value.toString();
+      if ( keys.contains( key ) )
+        continue;
+
+      keys.insert( key );
+      joinValues << value;
+    }
+
+    if ( !joinValues.isEmpty() )
+      mJoinBatchCache.insert( info.joinInfo, info.fetchJoinedAttributes( joinValues ) );
+  }
+}
+
 bool QgsVectorLayerFeatureIterator::fetchNextAddedFeature( QgsFeature &f )
 {
   while ( mFetchAddedFeaturesIt-- != mSource->mAddedFeatures.constBegin() )
@@ -680,6 +805,18 @@ void QgsVectorLayerFeatureIterator::prepareFields()
   {
     createOrderedJoinList();
   }
+
+  // joins without memory cache are resolved for batches of provider features,
+  // instead of running one request on the joined layer per feature
+  mBatchJoins = false;
+  for ( const FetchJoinInfo &info : qgis::as_const( mOrderedJoinInfoList ) )
+  {
+    if ( info.joinInfo->cachedAttributes.isEmpty() )
+    {
+      mBatchJoins = true;
+      break;
+    }
+  }
 }
 
 void QgsVectorLayerFeatureIterator::createOrderedJoinList()
@@ -820,10 +957,27 @@ void QgsVectorLayerFeatureIterator::addJoinedAttributes( QgsFeature &f )
       continue;
 
     const QHash< QString, QgsAttributes> &memoryCache = joinIt->joinInfo->cachedAttributes;
-    if ( memoryCache.isEmpty() )
-      joinIt->addJoinedAttributesDirect( f, targetFieldValue );
-    else
+    if ( !memoryCache.isEmpty() )
+    {
       joinIt->addJoinedAttributesCached( f, targetFieldValue );
+      continue;
+    }
+
+    // joined attributes already fetched with the feature batch
+    auto batchIt = mJoinBatchCache.constFind( joinIt->joinInfo );
+    if ( batchIt != mJoinBatchCache.constEnd() )
+    {
+      auto valueIt = batchIt->constFind( targetFieldValue.toString() );
+      if ( valueIt != batchIt->constEnd() )
+      {
+        int index = joinIt->indexOffset;
+        for ( const QVariant &value : valueIt.value() )
+          f.setAttribute( index++, value );
+        continue;
+      }
+    }
+
+    joinIt->addJoinedAttributesDirect( f, targetFieldValue );
   }
 }
 
@@ -995,6 +1149,67 @@ void QgsVectorLayerFeatureIterator::FetchJoinInfo::addJoinedAttributesDirect( Qg
 
 
 
+QHash<QString, QgsAttributes> QgsVectorLayerFeatureIterator::FetchJoinInfo::fetchJoinedAttributes( const QList<QVariant> &joinValues ) const
+{
+  QHash<QString, QgsAttributes> joinedAttributes;
+
+  QStringList quotedValues;
+  quotedValues.reserve( joinValues.size() );
+  for ( const QVariant &value : joinValues )
+  {
+    quotedValues << QgsExpression::quotedValue( value );
+
+    // values without matching feature keep empty (null) attributes
+    joinedAttributes.insert( value.toString(), QgsAttributes() );
+  }
+
+  QVector<int> subsetIndices;
+  if ( joinInfo->hasSubset() )
+  {
+    const QStringList subsetNames = QgsVectorLayerJoinInfo::joinFieldNamesSubset( *joinInfo );
+    subsetIndices = QgsVectorLayerJoinBuffer::joinSubsetIndices( joinLayer, subsetNames );
+  }
+
+  // the join field is needed to dispatch the fetched attributes
+  QgsAttributeList fetchAttributes = attributes;
+  if ( !fetchAttributes.contains( joinField ) )
+    fetchAttributes << joinField;
+
+  // select (no geometry), the IN list is compiled to SQL by most providers
+  QgsFeatureRequest request;
+  request.setFlags( QgsFeatureRequest::NoGeometry );
+  request.setSubsetOfAttributes( fetchAttributes );
+  request.setFilterExpression( QStringLiteral( "%1 IN (%2)" ).arg( QgsExpression::quotedColumnRef( joinInfo->joinFieldName() ),
+                               quotedValues.join( QStringLiteral( "," ) ) ) );
+  QgsFeatureIterator fi = joinLayer->getFeatures( request );
+
+  QgsFeature fet;
+  while ( fi.nextFeature( fet ) )
+  {
+    const QgsAttributes attr = fet.attributes();
+    QgsAttributes &joined = joinedAttributes[ attr.value( joinField ).toString()];
+
+    // keep the first matching feature only, as for direct joins
+    if ( !joined.isEmpty() )
+      continue;
+
+    if ( joinInfo->hasSubset() )
+    {
+      joined.resize( subsetIndices.count() );
+      for ( int i = 0; i < subsetIndices.count(); ++i )
+        joined[i] = attr.at( subsetIndices.at( i ) );
+    }
+    else
+    {
+      // use all fields except for the one used for join (has same value as exiting field in target layer)
+      joined = attr;
+      joined.remove( joinField );
+    }
+  }
+
+  return joinedAttributes;
+}
+
 bool QgsVectorLayerFeatureIterator::nextFeatureFid( QgsFeature &f )
 {
   QgsFeatureId featureId = mRequest.filterFid();
@@ -22,6 +22,7 @@
 #include "qgscoordinatereferencesystem.h"
 #include "qgsfeaturesource.h"
 
+#include <QQueue>
 #include <QSet>
 #include <memory>
 
@@ -136,6 +137,16 @@ class CORE_EXPORT QgsVectorLayerFeatureIterator : public QgsAbstractFeatureItera
 
       void addJoinedAttributesCached( QgsFeature &f, const QVariant &joinValue ) const;
       void addJoinedAttributesDirect( QgsFeature &f, const QVariant &joinValue ) const;
+
+      /**
+       * Fetches the joined attributes for all the \a joinValues with a single request
+       * on the joined layer. Attributes are returned by join value (as a string), in
+       * the same form as the join memory cache. Values without a matching joined
+       * feature are mapped to empty attributes.
+       * \note not available in Python bindings
+       * \since QGIS 3.0
+       */
+      QHash<QString, QgsAttributes> fetchJoinedAttributes( const QList<QVariant> &joinValues ) const SIP_SKIP;
     };
 
 
@@ -145,6 +156,14 @@ class CORE_EXPORT QgsVectorLayerFeatureIterator : public QgsAbstractFeatureItera
     //! fetch next feature, return true on success
     bool fetchFeature( QgsFeature &feature ) override;
 
+    /**
+     * Hands over whole blocks of provider features when they do not need any per
+     * feature handling from the layer, i.e. without edit buffer, joins or virtual
+     * fields and with no fid filter.
+     * \note not available in Python bindings
+     */
+    int fetchFeatures( QVector<QgsFeature> &features, int maxFeatures ) override SIP_SKIP;
+
     /**
      * Overrides default method as we only need to filter features in the edit buffer
      * while for others filtering is left to the provider implementation.
@@ -255,6 +274,18 @@ class CORE_EXPORT QgsVectorLayerFeatureIterator : public QgsAbstractFeatureItera
     //! Join list sorted by dependency
     QList< FetchJoinInfo > mOrderedJoinInfoList;
 
+    //! Block of provider features read by fetchFeatures()
+    QVector< QgsFeature > mProviderBlock;
+
+    //! True if some joins are resolved for batches of provider features instead of feature by feature
+    bool mBatchJoins = false;
+
+    //! Provider features read ahead, waiting to be returned
+    QQueue< QgsFeature > mFeatureBatch;
+
+    //! Joined attributes fetched for the current batch of features, by join and join value
+    QHash< const QgsVectorLayerJoinInfo *, QHash< QString, QgsAttributes > > mJoinBatchCache;
+
     /**
      * Will always return true. We assume that ordering has been done on provider level already.
      *
@@ -266,6 +297,18 @@ class CORE_EXPORT QgsVectorLayerFeatureIterator : public QgsAbstractFeatureItera
 
     void createOrderedJoinList();
 
+    /**
+     * Fetches the next feature from the provider, with the uncommitted attribute
+     * updates applied. When joins are resolved by batch, features are read ahead.
+     */
+    bool nextProviderFeature( QgsFeature &f );
+
+    /**
+     * Reads ahead the next batch of provider features and fetches with one request
+     * per join the joined attributes for all their distinct join values.
+     */
+    void fetchNextBatch();
+
     /**
      * Performs any post-processing (such as transformation) and feature based validity checking, e.g. checking for geometry validity.
      */
@@ -38,6 +38,9 @@
 
 #include <QPicture>
 
+//! Number of features fetched at once from the iterator
+static const int FEATURE_BATCH_SIZE = 100;
+
 
 QgsVectorLayerRenderer::QgsVectorLayerRenderer( QgsVectorLayer *layer, QgsRenderContext &context )
   : QgsMapLayerRenderer( layer->id() )
@@ -260,63 +263,66 @@ void QgsVectorLayerRenderer::drawRenderer( QgsFeatureIterator &fit )
   QgsExpressionContextScope *symbolScope = QgsExpressionContextUtils::updateSymbolScope( nullptr, new QgsExpressionContextScope() );
   mContext.expressionContext().appendScope( symbolScope );
 
-  QgsFeature fet;
-  while ( fit.nextFeature( fet ) )
+  QVector<QgsFeature> features;
+  while ( !mContext.renderingStopped() && fit.nextFeatures( features, FEATURE_BATCH_SIZE ) > 0 )
   {
-    try
+    for ( QgsFeature &fet : features )
     {
-      if ( mContext.renderingStopped() )
+      try
       {
-        QgsDebugMsg( QString( "Drawing of vector layer %1 canceled." ).arg( layerId() ) );
-        break;
-      }
+        if ( mContext.renderingStopped() )
+        {
+          QgsDebugMsg( QString( "Drawing of vector layer %1 canceled." ).arg( layerId() ) );
+          break;
+        }
 
-      if ( !fet.hasGeometry() || fet.geometry().isEmpty() )
-        continue; // skip features without geometry
+        if ( !fet.hasGeometry() || fet.geometry().isEmpty() )
+          continue; // skip features without geometry
 
-      mContext.expressionContext().setFeature( fet );
+        mContext.expressionContext().setFeature( fet );
 
-      bool sel = mContext.showSelection() && mSelectedFeatureIds.contains( fet.id() );
-      bool drawMarker = ( mDrawVertexMarkers && mContext.drawEditingInformation() && ( !mVertexMarkerOnlyForSelection || sel ) );
+        bool sel = mContext.showSelection() && mSelectedFeatureIds.contains( fet.id() );
+        bool drawMarker = ( mDrawVertexMarkers && mContext.drawEditingInformation() && ( !mVertexMarkerOnlyForSelection || sel ) );
 
-      // render feature
-      bool rendered = mRenderer->renderFeature( fet, mContext, -1, sel, drawMarker );
+        // render feature
+        bool rendered = mRenderer->renderFeature( fet, mContext, -1, sel, drawMarker );
 
-      // labeling - register feature
-      if ( rendered )
-      {
-        // new labeling engine
-        if ( mContext.labelingEngine() && ( mLabelProvider || mDiagramProvider ) )
+        // labeling - register feature
+        if ( rendered )
         {
-          QgsGeometry obstacleGeometry;
-          QgsSymbolList symbols = mRenderer->originalSymbolsForFeature( fet, mContext );
-
-          if ( !symbols.isEmpty() && fet.geometry().type() == QgsWkbTypes::PointGeometry )
+          // new labeling engine
+          if ( mContext.labelingEngine() && ( mLabelProvider || mDiagramProvider ) )
           {
-            obstacleGeometry = QgsVectorLayerLabelProvider::getPointObstacleGeometry( fet, mContext, symbols );
-          }
-
-          if ( !symbols.isEmpty() )
-          {
-            QgsExpressionContextUtils::updateSymbolScope( symbols.at( 0 ), symbolScope );
-          }
-
-          if ( mLabelProvider )
-          {
-            mLabelProvider->registerFeature( fet, mContext, obstacleGeometry );
-          }
-          if ( mDiagramProvider )
-          {
-            mDiagramProvider->registerFeature( fet, mContext, obstacleGeometry );
+            QgsGeometry obstacleGeometry;
+            QgsSymbolList symbols = mRenderer->originalSymbolsForFeature( fet, mContext );
+
+            if ( !symbols.isEmpty() && fet.geometry().type() == QgsWkbTypes::PointGeometry )
+            {
+              obstacleGeometry = QgsVectorLayerLabelProvider::getPointObstacleGeometry( fet, mContext, symbols );
+            }
+
+            if ( !symbols.isEmpty() )
+            {
+              QgsExpressionContextUtils::updateSymbolScope( symbols.at( 0 ), symbolScope );
+            }
+
+            if ( mLabelProvider )
+            {
+              mLabelProvider->registerFeature( fet, mContext, obstacleGeometry );
+            }
+            if ( mDiagramProvider )
+            {
+              mDiagramProvider->registerFeature( fet, mContext, obstacleGeometry );
+            }
           }
         }
       }
-    }
-    catch ( const QgsCsException &cse )
-    {
-      Q_UNUSED( cse );
-      QgsDebugMsg( QString( "Failed to transform a point while drawing a feature with ID '%1'. Ignoring this feature. %2" )
-                   .arg( fet.id() ).arg( cse.what() ) );
+      catch ( const QgsCsException &cse )
+      {
+        Q_UNUSED( cse );
+        QgsDebugMsg( QString( "Failed to transform a point while drawing a feature with ID '%1'. Ignoring this feature. %2" )
+                     .arg( fet.id() ).arg( cse.what() ) );
+      }
     }
   }
 
@@ -29,6 +29,14 @@
 #include <QRegExp>
 #include <QUrl>
 
+#include <algorithm>
+#include <cstring>
+
+//! Interval between the lines whose position is remembered, to quickly return to a previous record
+static const int LINE_OFFSET_INTERVAL = 256;
+
+//! Number of bytes read from the file at once
+static const int READ_BLOCK_SIZE = 1 << 16;
 
 QgsDelimitedTextFile::QgsDelimitedTextFile( const QString &url )
   : mFileName( QString() )
@@ -60,6 +68,13 @@ void QgsDelimitedTextFile::close()
     delete mFile;
     mFile = nullptr;
   }
+  mReadBytes = false;
+  mBuffer.clear();
+  mBufferOffset = 0;
+  mBufferPos = 0;
+  mDataStart = 0;
+  mCodec = nullptr;
+  mLineOffsets.clear();
   if ( mWatcher )
   {
     delete mWatcher;
@@ -86,11 +101,12 @@ bool QgsDelimitedTextFile::open()
     }
     if ( mFile )
     {
-      mStream = new QTextStream( mFile );
-      if ( ! mEncoding.isEmpty() )
+      QTextCodec *codec = mEncoding.isEmpty() ? nullptr : QTextCodec::codecForName( mEncoding.toLatin1() );
+      if ( ! openBytes( codec ) )
       {
-        QTextCodec *codec = QTextCodec::codecForName( mEncoding.toLatin1() );
-        mStream->setCodec( codec );
+        mStream = new QTextStream( mFile );
+        if ( codec )
+          mStream->setCodec( codec );
       }
       if ( mUseWatcher )
       {
@@ -103,6 +119,74 @@ bool QgsDelimitedTextFile::open()
   return nullptr != mFile;
 }
 
+bool QgsDelimitedTextFile::openBytes( QTextCodec *codec )
+{
+  // Same default as QTextStream
+  if ( ! codec )
+    codec = QTextCodec::codecForLocale();
+
+  // Lines are located by searching for newline bytes, which is only possible
+  // with encodings where ASCII characters are single bytes
+  if ( codec->name().startsWith( "UTF-16" ) || codec->name().startsWith( "UTF-32" ) )
+    return false;
+
+  mCodec = codec;
+  mReadBytes = true;
+  seekBytes( 0 );
+  readBlock();
+
+  // Byte order marks of UTF-16, as detected by QTextStream
+  const unsigned char *data = reinterpret_cast< const unsigned char * >( mBuffer.constData() );
+  if ( mBuffer.size() >= 2 && ( ( data[0] == 0xFF && data[1] == 0xFE ) || ( data[0] == 0xFE && data[1] == 0xFF ) ) )
+  {
+    mReadBytes = false;
+    mCodec = nullptr;
+    mBuffer.clear();
+    mFile->seek( 0 );
+    return false;
+  }
+
+  if ( mBuffer.size() >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF )
+  {
+    mCodec = QTextCodec::codecForName( "UTF-8" );
+    mDataStart = 3;
+    mBufferPos = 3;
+  }
+  return true;
+}
+
+bool QgsDelimitedTextFile::readBlock()
+{
+  // Drop the lines already read, the file is read sequentially
+  if ( mBufferPos > 0 )
+  {
+    mBuffer.remove( 0, mBufferPos );
+    mBufferOffset += mBufferPos;
+    mBufferPos = 0;
+  }
+
+  const int size = mBuffer.size();
+  mBuffer.resize( size + READ_BLOCK_SIZE );
+  const qint64 read = mFile->read( mBuffer.data() + size, READ_BLOCK_SIZE );
+  mBuffer.resize( size + static_cast< int >( std::max< qint64 >( read, 0 ) ) );
+  return read > 0;
+}
+
+void QgsDelimitedTextFile::seekBytes( qint64 offset )
+{
+  // Still in the bytes already read
+  if ( offset >= mBufferOffset && offset <= mBufferOffset + mBuffer.size() )
+  {
+    mBufferPos = static_cast< int >( offset - mBufferOffset );
+    return;
+  }
+
+  mFile->seek( offset );
+  mBuffer.clear();
+  mBufferOffset = offset;
+  mBufferPos = 0;
+}
+
 void QgsDelimitedTextFile::updateFile()
 {
   close();
@@ -537,16 +621,14 @@ QgsDelimitedTextFile::Status  QgsDelimitedTextFile::reset()
   if ( ! isValid() || ! open() ) return InvalidDefinition;
 
   // Reset the file pointer
-  mStream->seek( 0 );
-  mLineNumber = 0;
+  seekToLine( 0 );
   mRecordNumber = -1;
   mRecordLineNumber = -1;
 
   // Skip header lines
   for ( int i = mSkipLines; i-- > 0; )
   {
-    if ( mStream->readLine().isNull() ) return RecordEOF;
-    mLineNumber++;
+    if ( ! readLine( nullptr ) ) return RecordEOF;
   }
   // Read the column names
   Status result = RecordOk;
@@ -562,17 +644,14 @@ QgsDelimitedTextFile::Status  QgsDelimitedTextFile::reset()
 
 QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bool skipBlank )
 {
-  if ( ! mStream )
+  if ( ! mFile )
   {
     Status status = reset();
     if ( status != RecordOk ) return status;
   }
 
-  while ( ! mStream->atEnd() )
+  while ( readLine( &buffer ) )
   {
-    buffer = mStream->readLine();
-    if ( buffer.isNull() ) break;
-    mLineNumber++;
     if ( skipBlank && buffer.isEmpty() ) continue;
     return RecordOk;
   }
@@ -581,19 +660,89 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
   return RecordEOF;
 }
 
+bool QgsDelimitedTextFile::readLine( QString *buffer )
+{
+  if ( ! mReadBytes )
+  {
+    if ( ! mStream || mStream->atEnd() ) return false;
+    QString line = mStream->readLine();
+    if ( line.isNull() ) return false;
+    if ( buffer ) *buffer = line;
+    mLineNumber++;
+    return true;
+  }
+
+  // Find the end of the line, reading further blocks of the file until it is found.
+  // memchr is vectorized by the C library, much faster than decoding the text first
+  int searched = mBufferPos;
+  const char *end = nullptr;
+  while ( ! ( end = static_cast< const char * >( std::memchr( mBuffer.constData() + searched, '\n', static_cast< size_t >( mBuffer.size() - searched ) ) ) ) )
+  {
+    // the bytes before the line are dropped when reading the next block
+    searched = mBuffer.size() - mBufferPos;
+    if ( ! readBlock() ) break;
+  }
+  if ( mBufferPos >= mBuffer.size() ) return false;
+
+  // Remember where the next line starts
+  if ( mLineNumber % LINE_OFFSET_INTERVAL == 0 && mLineNumber / LINE_OFFSET_INTERVAL == mLineOffsets.size() )
+    mLineOffsets.append( mBufferOffset + mBufferPos );
+
+  const char *start = mBuffer.constData() + mBufferPos;
+  int length = end ? static_cast< int >( end - start ) : mBuffer.size() - mBufferPos;
+  mBufferPos += end ? length + 1 : length;
+  mLineNumber++;
+
+  if ( buffer )
+  {
+    if ( length > 0 && start[length - 1] == '\r' ) length--;
+    *buffer = mCodec->toUnicode( start, length );
+    // an empty line is not the end of the file
+    if ( buffer->isNull() ) *buffer = QLatin1String( "" );
+  }
+  return true;
+}
+
+void QgsDelimitedTextFile::seekToLine( long lineNumber )
+{
+  if ( mReadBytes )
+  {
+    const int index = static_cast< int >( std::min< long >( lineNumber / LINE_OFFSET_INTERVAL, mLineOffsets.size() - 1 ) );
+    if ( index < 0 )
+    {
+      seekBytes( mDataStart );
+      mLineNumber = 0;
+    }
+    else
+    {
+      seekBytes( mLineOffsets.at( index ) );
+      mLineNumber = static_cast< long >( index ) * LINE_OFFSET_INTERVAL;
+    }
+  }
+  else
+  {
+    mStream->seek( 0 );
+    mLineNumber = 0;
+  }
+}
+
 bool QgsDelimitedTextFile::setNextLineNumber( long nextLineNumber )
 {
-  if ( ! mStream ) return false;
+  if ( ! mFile ) return false;
   if ( mLineNumber > nextLineNumber - 1 )
   {
     mRecordNumber = -1;
-    mStream->seek( 0 );
-    mLineNumber = 0;
+    seekToLine( nextLineNumber - 1 );
+  }
+  else if ( mReadBytes && ( nextLineNumber - 1 ) / LINE_OFFSET_INTERVAL < mLineOffsets.size() &&
+            ( ( nextLineNumber - 1 ) / LINE_OFFSET_INTERVAL ) * LINE_OFFSET_INTERVAL > mLineNumber )
+  {
+    // Jump over the lines already visited
+    seekToLine( nextLineNumber - 1 );
   }
-  QString buffer;
   while ( mLineNumber < nextLineNumber - 1 )
   {
-    if ( nextLine( buffer, false ) != RecordOk ) return false;
+    if ( ! readLine( nullptr ) ) return false;
   }
   return true;
 
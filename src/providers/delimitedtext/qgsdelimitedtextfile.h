@@ -22,12 +22,15 @@
 #include <QRegExp>
 #include <QUrl>
 #include <QObject>
+#include <QVector>
+#include <QByteArray>
 
 class QgsFeature;
 class QgsField;
 class QFile;
 class QFileSystemWatcher;
 class QTextStream;
+class QTextCodec;
 
 
 /**
@@ -385,6 +388,36 @@ class QgsDelimitedTextFile : public QObject
      */
     Status nextLine( QString &buffer, bool skipBlank = false );
 
+    /**
+     * Read the next line of the file into buffer, or skip it if buffer is null.
+     * Returns false at the end of the file.
+     */
+    bool readLine( QString *buffer );
+
+    /**
+     * Move to the closest known line at or before lineNumber.
+     */
+    void seekToLine( long lineNumber );
+
+    /**
+     * Start reading the lines directly from the bytes of the file.
+     * Without \a codec the locale codec is used, as for a QTextStream.
+     * Returns false if the encoding is not ASCII compatible, in which case
+     * the file is read through a QTextStream.
+     */
+    bool openBytes( QTextCodec *codec );
+
+    /**
+     * Append the next block of the file to the bytes read, dropping the
+     * lines already read. Returns false at the end of the file.
+     */
+    bool readBlock();
+
+    /**
+     * Move to the byte \a offset of the file.
+     */
+    void seekBytes( qint64 offset );
+
     /**
      * Set the next line to read from the file.
      */
@@ -403,6 +436,18 @@ class QgsDelimitedTextFile : public QObject
     QString mEncoding;
     QFile *mFile = nullptr;
     QTextStream *mStream = nullptr;
+    // True if the lines are read from the bytes of the file rather than mStream
+    bool mReadBytes = false;
+    // Bytes read from the file, starting at file position mBufferOffset
+    QByteArray mBuffer;
+    qint64 mBufferOffset = 0;
+    // Start of the next line in mBuffer
+    int mBufferPos = 0;
+    // File position of the first line, after any byte order mark
+    qint64 mDataStart = 0;
+    QTextCodec *mCodec = nullptr;
+    // File position of every LINE_OFFSET_INTERVAL lines visited
+    QVector<qint64> mLineOffsets;
     bool mUseWatcher = false;
     QFileSystemWatcher *mWatcher = nullptr;
 
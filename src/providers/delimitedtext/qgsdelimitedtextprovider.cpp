@@ -499,10 +499,8 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
           mNumberFeatures++;
           if ( buildSpatialIndex && std::isfinite( pt.x() ) && std::isfinite( pt.y() ) )
           {
-            QgsFeature f;
-            f.setId( mFile->recordId() );
-            f.setGeometry( QgsGeometry::fromPointXY( pt ) );
-            mSpatialIndex->insertFeature( f );
+            // no need to build a geometry for the bounds of a point
+            mSpatialIndex->insertFeature( mFile->recordId(), QgsRectangle( pt.x(), pt.y(), pt.x(), pt.y() ) );
           }
         }
         else
@@ -19,6 +19,7 @@
 #include "qgssqliteexpressioncompiler.h"
 
 #include "qgsogrutils.h"
+#include "qgspackedrtree.h"
 #include "qgsapplication.h"
 #include "qgsgeometry.h"
 #include "qgslogger.h"
@@ -30,6 +31,44 @@
 #include <QTextCodec>
 #include <QFile>
 
+#include <algorithm>
+
+///@cond PRIVATE
+
+/**
+ * Decodes the attributes of an OGR feature when they are first accessed.
+ * The OGR feature is kept alive by the decoder.
+ */
+class QgsOgrAttributeDecoder : public QgsAttributeDecoder
+{
+  public:
+    QgsOgrAttributeDecoder( gdal::ogr_feature_unique_ptr feature, const QgsFields &fieldsWithoutFid, bool firstFieldIsFid, QTextCodec *encoding )
+      : mFeature( std::move( feature ) )
+      , mFieldsWithoutFid( fieldsWithoutFid )
+      , mFirstFieldIsFid( firstFieldIsFid )
+      , mEncoding( encoding )
+    {
+    }
+
+    QVariant decode( int index ) const override
+    {
+      if ( mFirstFieldIsFid && index == 0 )
+        return static_cast<qint64>( OGR_F_GetFID( mFeature.get() ) );
+
+      bool ok = false;
+      QVariant value = QgsOgrUtils::getOgrFeatureAttribute( mFeature.get(), mFieldsWithoutFid, mFirstFieldIsFid ? index - 1 : index, mEncoding, &ok );
+      return ok ? value : QVariant();
+    }
+
+  private:
+    gdal::ogr_feature_unique_ptr mFeature;
+    QgsFields mFieldsWithoutFid;
+    bool mFirstFieldIsFid = false;
+    QTextCodec *mEncoding = nullptr;
+};
+
+///@endcond
+
 // using from provider:
 // - setRelevantFields(), mRelevantFieldsForNextFeature
 // - ogrLayer
@@ -177,6 +216,18 @@ QgsOgrFeatureIterator::QgsOgrFeatureIterator( QgsOgrFeatureSource *source, bool
     OGR_L_SetAttributeFilter( ogrLayer, nullptr );
   }
 
+  // without a native spatial index, fetching the candidates of the sidecar index
+  // by id is much faster than letting OGR scan the whole layer
+  if ( mSource->mSidecarIndex && !mFilterRect.isNull() && !mSubsetStringSet && !mOrigFidAdded &&
+       mCompileStatus == NoCompilation &&
+       mRequest.filterType() != QgsFeatureRequest::FilterFid && mRequest.filterType() != QgsFeatureRequest::FilterFids )
+  {
+    mUseSidecarIndex = true;
+    mSidecarFids = mSource->mSidecarIndex->intersects( mFilterRect );
+    // read the file in order
+    std::sort( mSidecarFids.begin(), mSidecarFids.end() );
+    OGR_L_SetSpatialFilter( ogrLayer, nullptr );
+  }
 
   //start with first feature
   rewind();
@@ -258,6 +309,25 @@ bool QgsOgrFeatureIterator::fetchFeature( QgsFeature &feature )
     close();
     return false;
   }
+  else if ( mUseSidecarIndex )
+  {
+    while ( mSidecarFidsPos < mSidecarFids.size() )
+    {
+      gdal::ogr_feature_unique_ptr fet( OGR_L_GetFeature( ogrLayer, FID_TO_NUMBER( mSidecarFids.at( mSidecarFidsPos++ ) ) ) );
+      if ( !fet || !readFeature( std::move( fet ), feature ) )
+        continue;
+
+      // the index only stores bounding boxes
+      if ( !feature.hasGeometry() || feature.geometry().isEmpty() || !feature.geometry().boundingBox().intersects( mFilterRect ) )
+        continue;
+
+      feature.setValid( true );
+      geometryToDestinationCrs( feature, mTransform );
+      return true;
+    }
+    close();
+    return false;
+  }
 
   gdal::ogr_feature_unique_ptr fet;
 
@@ -280,6 +350,37 @@ bool QgsOgrFeatureIterator::fetchFeature( QgsFeature &feature )
   return false;
 }
 
+int QgsOgrFeatureIterator::fetchFeatures( QVector<QgsFeature> &features, int maxFeatures )
+{
+  if ( mClosed || !ogrLayer )
+    return 0;
+
+  // features read by id are fetched one at a time
+  if ( mRequest.filterType() == QgsFeatureRequest::FilterFid || mRequest.filterType() == QgsFeatureRequest::FilterFids || mUseSidecarIndex )
+    return QgsAbstractFeatureIterator::fetchFeatures( features, maxFeatures );
+
+  // read the whole block from the layer cursor in a single loop
+  int count = 0;
+  gdal::ogr_feature_unique_ptr fet;
+  while ( count < maxFeatures && ( fet.reset( OGR_L_GetNextFeature( ogrLayer ) ), fet ) )
+  {
+    QgsFeature &feature = features[count];
+    if ( !readFeature( std::move( fet ), feature ) )
+      continue;
+
+    if ( !mFilterRect.isNull() && ( !feature.hasGeometry() || feature.geometry().isEmpty() ) )
+      continue;
+
+    feature.setValid( true );
+    geometryToDestinationCrs( feature, mTransform );
+    ++count;
+  }
+
+  if ( count < maxFeatures )
+    close();
+
+  return count;
+}
 
 bool QgsOgrFeatureIterator::rewind()
 {
@@ -289,6 +390,7 @@ bool QgsOgrFeatureIterator::rewind()
   OGR_L_ResetReading( ogrLayer );
 
   mFilterFidsIt = mFilterFids.constBegin();
+  mSidecarFidsPos = 0;
 
   return true;
 }
@@ -410,11 +512,11 @@ bool QgsOgrFeatureIterator::readFeature( gdal::ogr_feature_unique_ptr fet, QgsFe
   }
   else
   {
-    // all attributes
-    for ( int idx = 0; idx < mSource->mFields.count(); ++idx )
-    {
-      getFeatureAttribute( fet.get(), feature, idx );
-    }
+    // all attributes, only converted when they are accessed. The geometry was
+    // already converted, the decoder must not keep a second copy of it
+    for ( int i = 0; i < OGR_F_GetGeomFieldCount( fet.get() ); ++i )
+      OGR_F_SetGeomFieldDirectly( fet.get(), i, nullptr );
+    feature.setLazyAttributes( mSource->mFields.count(), new QgsOgrAttributeDecoder( std::move( fet ), mSource->mFieldsWithoutFid, mSource->mFirstFieldIsFid, mSource->mEncoding ) );
   }
 
   return true;
@@ -433,6 +535,7 @@ QgsOgrFeatureSource::QgsOgrFeatureSource( const QgsOgrProvider *p )
   , mDriverName( p->mGDALDriverName )
   , mCrs( p->crs() )
   , mWkbType( p->wkbType() )
+  , mSidecarIndex( p->mSidecarIndex )
 {
   for ( int i = ( p->mFirstFieldIsFid ) ? 1 : 0; i < mFields.size(); i++ )
     mFieldsWithoutFid.append( mFields.at( i ) );
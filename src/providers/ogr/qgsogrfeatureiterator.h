@@ -21,7 +21,10 @@
 
 #include <ogr_api.h>
 
+#include <memory>
+
 class QgsOgrFeatureIterator;
+class QgsPackedRTree;
 class QgsOgrProvider;
 
 class QgsOgrFeatureSource : public QgsAbstractFeatureSource
@@ -45,6 +48,7 @@ class QgsOgrFeatureSource : public QgsAbstractFeatureSource
     QString mDriverName;
     QgsCoordinateReferenceSystem mCrs;
     QgsWkbTypes::Type mWkbType = QgsWkbTypes::Unknown;
+    std::shared_ptr< const QgsPackedRTree > mSidecarIndex;
 
     friend class QgsOgrFeatureIterator;
     friend class QgsOgrExpressionCompiler;
@@ -62,6 +66,7 @@ class QgsOgrFeatureIterator : public QgsAbstractFeatureIteratorFromSource<QgsOgr
 
   protected:
     bool fetchFeature( QgsFeature &feature ) override;
+    int fetchFeatures( QVector<QgsFeature> &features, int maxFeatures ) override;
     bool nextFeatureFilterExpression( QgsFeature &f ) override;
 
   private:
@@ -87,6 +92,11 @@ class QgsOgrFeatureIterator : public QgsAbstractFeatureIteratorFromSource<QgsOgr
     QgsRectangle mFilterRect;
     QgsCoordinateTransform mTransform;
 
+    //! True if the candidates of the spatial filter are taken from the sidecar index
+    bool mUseSidecarIndex = false;
+    QList<QgsFeatureId> mSidecarFids;
+    int mSidecarFidsPos = 0;
+
     bool fetchFeatureWithId( QgsFeatureId id, QgsFeature &feature ) const;
 };
 
@@ -37,6 +37,7 @@ email                : sherman at mrcc.com
 #include "qgsgeopackagedataitems.h"
 #include "qgswkbtypes.h"
 #include "qgsnetworkaccessmanager.h"
+#include "qgspackedrtree.h"
 
 #ifdef HAVE_GUI
 #include "qgssourceselectprovider.h"
@@ -56,11 +57,14 @@ email                : sherman at mrcc.com
 #include <limits>
 
 #include <QtDebug>
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QFile>
 #include <QDir>
 #include <QFileInfo>
 #include <QMap>
 #include <QMessageBox>
+#include <QSaveFile>
 #include <QString>
 #include <QTextCodec>
 
@@ -1444,6 +1448,9 @@ bool QgsOgrProvider::addFeatures( QgsFeatureList &flist, Flags flags )
   if ( !doInitialActionsForEdition() )
     return false;
 
+  // the sidecar index does not reflect edits
+  mSidecarIndex.reset();
+
   setRelevantFields( true, attributeIndexes() );
 
   const bool inTransaction = startTransaction();
@@ -1926,6 +1933,9 @@ bool QgsOgrProvider::changeGeometryValues( const QgsGeometryMap &geometry_map )
   if ( !doInitialActionsForEdition() )
     return false;
 
+  // the sidecar index does not reflect edits
+  mSidecarIndex.reset();
+
   setRelevantFields( true, attributeIndexes() );
 
   const bool inTransaction = startTransaction();
@@ -2001,6 +2011,9 @@ bool QgsOgrProvider::createSpatialIndex()
 {
   if ( !mOgrOrigLayer )
     return false;
+
+  if ( supportsSidecarIndex() )
+    return createSidecarIndex();
   if ( !doInitialActionsForEdition() )
     return false;
 
@@ -2028,6 +2041,95 @@ bool QgsOgrProvider::createSpatialIndex()
   return false;
 }
 
+bool QgsOgrProvider::supportsSidecarIndex() const
+{
+  // formats with their own spatial index creation
+  if ( mGDALDriverName == QLatin1String( "ESRI Shapefile" ) ||
+       mGDALDriverName == QLatin1String( "GPKG" ) ||
+       mGDALDriverName == QLatin1String( "SQLite" ) )
+    return false;
+
+  // features are looked up by id, which is only possible on the original layer
+  if ( !mOgrLayer || !mSubsetString.isEmpty() || !QFileInfo( mFilePath ).isFile() )
+    return false;
+
+  return mOgrLayer->TestCapability( "RandomRead" ) && !mOgrLayer->TestCapability( "FastSpatialFilter" );
+}
+
+QString QgsOgrProvider::sidecarIndexPath() const
+{
+  const QString identifier = QStringLiteral( "%1|%2|%3|%4" ).arg( QFileInfo( mFilePath ).canonicalFilePath(), mLayerName )
+                             .arg( mLayerIndex ).arg( static_cast< int >( mOgrGeometryTypeFilter ) );
+  const QByteArray hash = QCryptographicHash::hash( identifier.toUtf8(), QCryptographicHash::Sha1 ).toHex();
+  QString directory = QgsSettings().value( QStringLiteral( "cache/spatialIndexDirectory" ) ).toString();
+  if ( directory.isEmpty() )
+    directory = QgsApplication::qgisSettingsDirPath() + QStringLiteral( "cache/spatialindex" );
+  return QDir( directory ).filePath( QStringLiteral( "%1.qgsidx" ).arg( QString::fromLatin1( hash ) ) );
+}
+
+QByteArray QgsOgrProvider::sidecarIndexKey() const
+{
+  const QFileInfo fi( mFilePath );
+  return QStringLiteral( "%1|%2" ).arg( fi.size() ).arg( fi.lastModified().toMSecsSinceEpoch() ).toUtf8();
+}
+
+void QgsOgrProvider::loadSidecarIndex()
+{
+  mSidecarIndex.reset();
+  if ( !supportsSidecarIndex() )
+    return;
+
+  QFile file( sidecarIndexPath() );
+  if ( !file.open( QIODevice::ReadOnly ) )
+    return;
+
+  QDataStream stream( &file );
+  QByteArray key;
+  stream >> key;
+  if ( key != sidecarIndexKey() )
+  {
+    // the data source was modified since the index was built
+    QgsDebugMsg( QString( "Discarding outdated spatial index %1" ).arg( file.fileName() ) );
+    return;
+  }
+
+  std::shared_ptr< QgsPackedRTree > index = std::make_shared< QgsPackedRTree >();
+  if ( index->read( stream ) )
+    mSidecarIndex = index;
+}
+
+bool QgsOgrProvider::createSidecarIndex()
+{
+  std::shared_ptr< QgsPackedRTree > index = std::make_shared< QgsPackedRTree >();
+
+  QgsFeature f;
+  QgsFeatureIterator it = getFeatures( QgsFeatureRequest().setSubsetOfAttributes( QgsAttributeList() ) );
+  while ( it.nextFeature( f ) )
+  {
+    if ( f.hasGeometry() )
+      index->add( f.id(), f.geometry().boundingBox() );
+  }
+  index->finish();
+  mSidecarIndex = index;
+
+  // the index is kept in the user profile cache, as data directories are often read only
+  const QString path = sidecarIndexPath();
+  QDir().mkpath( QFileInfo( path ).absolutePath() );
+  QSaveFile file( path );
+  if ( file.open( QIODevice::WriteOnly ) )
+  {
+    QDataStream stream( &file );
+    stream << sidecarIndexKey();
+    index->write( stream );
+    if ( file.commit() )
+      return true;
+  }
+
+  // the index is still used until the layer is closed
+  QgsMessageLog::logMessage( tr( "Cannot write spatial index file %1" ).arg( path ), tr( "OGR" ) );
+  return false;
+}
+
 QString createIndexName( QString tableName, QString field )
 {
   QRegularExpression safeExp( QStringLiteral( "[^a-zA-Z0-9]" ) );
@@ -2079,6 +2181,9 @@ bool QgsOgrProvider::deleteFeatures( const QgsFeatureIds &id )
   if ( !doInitialActionsForEdition() )
     return false;
 
+  // the sidecar index does not reflect edits
+  mSidecarIndex.reset();
+
   const bool inTransaction = startTransaction();
 
   bool returnvalue = true;
@@ -2332,6 +2437,10 @@ void QgsOgrProvider::computeCapabilities()
       ability |= CreateSpatialIndex;
       ability |= CreateAttributeIndex;
     }
+    else if ( supportsSidecarIndex() )
+    {
+      ability |= CreateSpatialIndex;
+    }
 
     /* Curve geometries are available in some drivers starting with GDAL 2.0 */
     if ( mOgrLayer->TestCapability( "CurveGeometries" ) )
@@ -4069,6 +4178,9 @@ void QgsOgrProvider::open( OpenMode mode )
     }
   }
 
+  if ( mValid )
+    loadSidecarIndex();
+
   // For debug/testing purposes
   if ( !mValid )
     setProperty( "_debug_open_mode", "invalid" );
@@ -33,6 +33,7 @@ class QgsOgrFeatureIterator;
 #include <gdal.h>
 
 class QgsOgrLayer;
+class QgsPackedRTree;
 
 /**
  * Releases a QgsOgrLayer
@@ -282,6 +283,30 @@ class QgsOgrProvider : public QgsVectorDataProvider
     //! Calls OGR_L_SyncToDisk and recreates the spatial index if present
     bool syncToDisc();
 
+    /**
+     * Returns true if the layer has no native spatial index, but supports fast
+     * access to features by id, so that a sidecar spatial index can be used.
+     */
+    bool supportsSidecarIndex() const;
+
+    /**
+     * Path of the sidecar spatial index file, in the directory of the "cache/spatialIndexDirectory"
+     * setting or by default in the user profile cache
+     */
+    QString sidecarIndexPath() const;
+
+    //! Identifies the version of the data source file the sidecar index was built from
+    QByteArray sidecarIndexKey() const;
+
+    //! Loads the sidecar spatial index if it exists and is up to date
+    void loadSidecarIndex();
+
+    //! Builds the sidecar spatial index and writes it to the cache
+    bool createSidecarIndex();
+
+    //! Sidecar spatial index, shared with the feature sources
+    std::shared_ptr< const QgsPackedRTree > mSidecarIndex;
+
     friend class QgsOgrFeatureSource;
 
     //! Whether the file is opened in write mode
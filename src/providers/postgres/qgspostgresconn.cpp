@@ -29,6 +29,7 @@
 #include "qgssettings.h"
 
 #include <QApplication>
+#include <QDateTime>
 #include <QThread>
 
 #include <climits>
@@ -207,6 +208,7 @@ QgsPostgresConn::QgsPostgresConn( const QString &conninfo, bool readOnly, bool s
   , mUseWkbHex( false )
   , mReadOnly( readOnly )
   , mSwapEndian( false )
+  , mIntegerDatetimes( false )
   , mNextCursorId( 0 )
   , mShared( shared )
   , mTransaction( transaction )
@@ -296,6 +298,9 @@ QgsPostgresConn::QgsPostgresConn( const QString &conninfo, bool readOnly, bool s
 
   deduceEndian();
 
+  const char *integerDatetimes = ::PQparameterStatus( mConn, "integer_datetimes" );
+  mIntegerDatetimes = integerDatetimes && qstrcmp( integerDatetimes, "on" ) == 0;
+
   /* Check to see if we have working PostGIS support */
   if ( !postgisVersion().isNull() )
   {
@@ -1325,6 +1330,128 @@ qint64 QgsPostgresConn::getBinaryInt( QgsPostgresResult &queryResult, int row, i
   return oid;
 }
 
+bool QgsPostgresConn::supportsBinaryValue( const QgsField &fld ) const
+{
+  const QString &type = fld.typeName();
+  if ( type == QLatin1String( "int2" ) || type == QLatin1String( "int4" ) || type == QLatin1String( "int8" ) ||
+       type == QLatin1String( "float4" ) || type == QLatin1String( "float8" ) ||
+       type == QLatin1String( "bool" ) || type == QLatin1String( "date" ) )
+    return true;
+
+  // time and timestamp are only decoded in their integer representation,
+  // servers built with floating point datetimes fall back to text
+  if ( type == QLatin1String( "time" ) || type == QLatin1String( "timestamp" ) )
+    return mIntegerDatetimes;
+
+  return false;
+}
+
+QVariant QgsPostgresConn::getBinaryValue( QgsPostgresResult &queryResult, int row, int col, const QgsField &fld )
+{
+  if ( queryResult.PQgetisnull( row, col ) )
+    return QVariant( fld.type() );
+
+  const char *p = ::PQgetvalue( queryResult.result(), row, col );
+  const int s = ::PQgetlength( queryResult.result(), row, col );
+  const QString &type = fld.typeName();
+
+  // binary cursors return values in network byte order
+  auto readUInt64 = [this]( const char *data ) -> quint64
+  {
+    quint32 hi = *( quint32 * ) data;
+    quint32 lo = *( quint32 * )( data + sizeof( quint32 ) );
+    if ( mSwapEndian )
+    {
+      hi = ntohl( hi );
+      lo = ntohl( lo );
+    }
+    return ( static_cast< quint64 >( hi ) << 32 ) | lo;
+  };
+
+  if ( type == QLatin1String( "bool" ) )
+  {
+    return s == 1 ? QVariant( *p != 0 ) : QVariant( QVariant::Bool );
+  }
+  else if ( type == QLatin1String( "float4" ) )
+  {
+    if ( s != 4 )
+      return QVariant( QVariant::Double );
+
+    quint32 bits = *( quint32 * ) p;
+    if ( mSwapEndian )
+      bits = ntohl( bits );
+    float value;
+    memcpy( &value, &bits, sizeof( value ) );
+
+    // widening the float would expose its binary error (0.1 becoming 0.10000000149011612),
+    // return the double of the shortest decimal text of the value as the text cursor does
+    for ( int precision = 1; precision < 9; ++precision )
+    {
+      const QString text = QString::number( static_cast< double >( value ), 'g', precision );
+      if ( text.toFloat() == value )
+        return text.toDouble();
+    }
+    return QString::number( static_cast< double >( value ), 'g', 9 ).toDouble();
+  }
+  else if ( type == QLatin1String( "float8" ) )
+  {
+    if ( s != 8 )
+      return QVariant( QVariant::Double );
+
+    const quint64 bits = readUInt64( p );
+    double value;
+    memcpy( &value, &bits, sizeof( value ) );
+    return value;
+  }
+  else if ( type == QLatin1String( "date" ) )
+  {
+    if ( s != 4 )
+      return QVariant( QVariant::Date );
+
+    // days since 2000-01-01
+    quint32 days = *( quint32 * ) p;
+    if ( mSwapEndian )
+      days = ntohl( days );
+    return QDate( 2000, 1, 1 ).addDays( static_cast< qint32 >( days ) );
+  }
+  else if ( type == QLatin1String( "time" ) )
+  {
+    if ( s != 8 )
+      return QVariant( QVariant::Time );
+
+    // microseconds since midnight
+    const qint64 usecs = static_cast< qint64 >( readUInt64( p ) );
+    return QTime( 0, 0 ).addMSecs( static_cast< int >( usecs / 1000 ) );
+  }
+  else if ( type == QLatin1String( "timestamp" ) )
+  {
+    if ( s != 8 )
+      return QVariant( QVariant::DateTime );
+
+    // microseconds since 2000-01-01 00:00:00
+    // split in days and time of day, as adding the milliseconds to a local
+    // date time would shift values across daylight saving time changes
+    const qint64 usecs = static_cast< qint64 >( readUInt64( p ) );
+    qint64 msecs = usecs / 1000;
+    if ( usecs < 0 && usecs % 1000 != 0 )
+      --msecs;
+    const qint64 msecsPerDay = 86400000;
+    qint64 days = msecs / msecsPerDay;
+    qint64 msecsOfDay = msecs % msecsPerDay;
+    if ( msecsOfDay < 0 )
+    {
+      msecsOfDay += msecsPerDay;
+      --days;
+    }
+    return QDateTime( QDate( 2000, 1, 1 ).addDays( days ), QTime( 0, 0 ).addMSecs( static_cast< int >( msecsOfDay ) ) );
+  }
+
+  // int2, int4 and int8
+  return fld.type() == QVariant::LongLong
+         ? QVariant( getBinaryInt( queryResult, row, col ) )
+         : QVariant( static_cast< int >( getBinaryInt( queryResult, row, col ) ) );
+}
+
 QString QgsPostgresConn::fieldExpression( const QgsField &fld, QString expr )
 {
   const QString &type = fld.typeName();
@@ -310,6 +310,20 @@ class QgsPostgresConn : public QObject
 
     qint64 getBinaryInt( QgsPostgresResult &queryResult, int row, int col );
 
+    /**
+     * Returns true if the values of the field \a fld can be fetched from a
+     * binary cursor in their native binary format and decoded with
+     * getBinaryValue(), instead of being cast as text.
+     */
+    bool supportsBinaryValue( const QgsField &fld ) const;
+
+    /**
+     * Decodes the value at \a row and \a col of a binary cursor result
+     * for the field \a fld.
+     * \see supportsBinaryValue()
+     */
+    QVariant getBinaryValue( QgsPostgresResult &queryResult, int row, int col, const QgsField &fld );
+
     QString fieldExpression( const QgsField &fld, QString expr = "%1" );
 
     QString connInfo() const { return mConnInfo; }
@@ -416,6 +430,9 @@ class QgsPostgresConn : public QObject
     bool mSwapEndian;
     void deduceEndian();
 
+    //! Whether date/time values are transferred as 64 bit integers (integer_datetimes server setting)
+    bool mIntegerDatetimes;
+
     int mNextCursorId;
 
     bool mShared; //! < whether the connection is shared by more providers (must not be if going to be used in worker threads)
@@ -149,7 +149,7 @@ QgsPostgresFeatureIterator::QgsPostgresFeatureIterator( QgsPostgresFeatureSource
 
     mOrderByCompiled = true;
 
-    // THIS CODE IS BROKEN - since every retrieved column is cast as text during declareCursor, this method of sorting will always be
+    // THIS CODE IS BROKEN - since most retrieved columns are cast as text during declareCursor, this method of sorting will always be
     // performed using a text sort.
     // TODO - fix ordering by so that instead of
     //     SELECT my_int_col::text FROM some_table ORDER BY my_int_col
@@ -255,7 +255,45 @@ bool QgsPostgresFeatureIterator::fetchFeature( QgsFeature &feature )
   if ( mClosed )
     return false;
 
-  if ( mFeatureQueue.empty() && !mLastFetch )
+  if ( mFeatureQueue.empty() && !fetchNextBlock() )
+    return false;
+
+  feature = mFeatureQueue.dequeue();
+  mFetched++;
+
+  feature.setValid( true );
+  feature.setFields( mSource->mFields ); // allow name-based attribute lookups
+  geometryToDestinationCrs( feature, mTransform );
+
+  return true;
+}
+
+int QgsPostgresFeatureIterator::fetchFeatures( QVector<QgsFeature> &features, int maxFeatures )
+{
+  int count = 0;
+  while ( count < maxFeatures && !mClosed )
+  {
+    if ( mFeatureQueue.empty() && !fetchNextBlock() )
+      break;
+
+    // hand over the fetched block at once
+    while ( count < maxFeatures && !mFeatureQueue.empty() )
+    {
+      QgsFeature &feature = features[count++];
+      feature = mFeatureQueue.dequeue();
+      mFetched++;
+
+      feature.setValid( true );
+      feature.setFields( mSource->mFields ); // allow name-based attribute lookups
+      geometryToDestinationCrs( feature, mTransform );
+    }
+  }
+  return count;
+}
+
+bool QgsPostgresFeatureIterator::fetchNextBlock()
+{
+  if ( !mLastFetch )
   {
     QElapsedTimer timer;
     timer.start();
@@ -316,13 +354,6 @@ bool QgsPostgresFeatureIterator::fetchFeature( QgsFeature &feature )
     return false;
   }
 
-  feature = mFeatureQueue.dequeue();
-  mFetched++;
-
-  feature.setValid( true );
-  feature.setFields( mSource->mFields ); // allow name-based attribute lookups
-  geometryToDestinationCrs( feature, mTransform );
-
   return true;
 }
 
@@ -630,13 +661,26 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
       return false;
   }
 
+  mBinaryAttributes.fill( false, mSource->mFields.count() );
+
   bool subsetOfAttributes = mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes;
   Q_FOREACH ( int idx, subsetOfAttributes ? mRequest.subsetOfAttributes() : mSource->mFields.allAttributesList() )
   {
     if ( mSource->mPrimaryKeyAttrs.contains( idx ) )
       continue;
 
-    query += delim + mConn->fieldExpression( mSource->mFields.at( idx ) );
+    // numeric and date/time values are decoded from the binary cursor,
+    // which avoids formatting them as text on the server and parsing them back
+    const QgsField fld = mSource->mFields.at( idx );
+    if ( mConn->supportsBinaryValue( fld ) )
+    {
+      mBinaryAttributes[idx] = true;
+      query += delim + QgsPostgresConn::quotedIdentifier( fld.name() );
+    }
+    else
+    {
+      query += delim + mConn->fieldExpression( fld );
+    }
   }
 
   query += " FROM " + mSource->mQuery;
@@ -813,7 +857,9 @@ void QgsPostgresFeatureIterator::getFeatureAttribute( int idx, QgsPostgresResult
     return;
 
   const QgsField fld = mSource->mFields.at( idx );
-  QVariant v = QgsPostgresProvider::convertValue( fld.type(), fld.subType(), queryResult.PQgetvalue( row, col ) );
+  QVariant v = mBinaryAttributes.at( idx )
+               ? mConn->getBinaryValue( queryResult, row, col, fld )
+               : QgsPostgresProvider::convertValue( fld.type(), fld.subType(), queryResult.PQgetvalue( row, col ) );
   feature.setAttribute( idx, v );
 
   col++;
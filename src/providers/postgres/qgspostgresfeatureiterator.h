@@ -80,6 +80,7 @@ class QgsPostgresFeatureIterator : public QgsAbstractFeatureIteratorFromSource<Q
 
   protected:
     bool fetchFeature( QgsFeature &feature ) override;
+    int fetchFeatures( QVector<QgsFeature> &features, int maxFeatures ) override;
     bool nextFeatureFilterExpression( QgsFeature &f ) override;
     bool prepareSimplification( const QgsSimplifyMethod &simplifyMethod ) override;
 
@@ -89,6 +90,12 @@ class QgsPostgresFeatureIterator : public QgsAbstractFeatureIteratorFromSource<Q
 
 
     QString whereClauseRect();
+
+    /**
+     * Fetches the next block of features from the cursor into the feature queue.
+     * Closes the iterator and returns false once all features were fetched.
+     */
+    bool fetchNextBlock();
     bool getFeature( QgsPostgresResult &queryResult, int row, QgsFeature &feature );
     void getFeatureAttribute( int idx, QgsPostgresResult &queryResult, int row, int &col, QgsFeature &feature );
     bool declareCursor( const QString &whereClause, long limit = -1, bool closeOnFail = true, const QString &orderBy = QString() );
@@ -110,6 +117,9 @@ class QgsPostgresFeatureIterator : public QgsAbstractFeatureIteratorFromSource<Q
     //! Set to true, if geometry is in the requested columns
     bool mFetchGeometry;
 
+    //! Whether each field is fetched in its binary format rather than cast as text
+    QVector<bool> mBinaryAttributes;
+
     bool mIsTransactionConnection = false;
 
     bool providerCanSimplify( QgsSimplifyMethod::MethodType methodType ) const override;
@@ -17,6 +17,7 @@
 
 #include "qgscapabilitiescache.h"
 #include "qgslogger.h"
+#include "qgsservermetrics.h"
 #include <QCoreApplication>
 
 QgsCapabilitiesCache::QgsCapabilitiesCache()
@@ -30,10 +31,12 @@ const QDomDocument *QgsCapabilitiesCache::searchCapabilitiesDocument( const QStr
 
   if ( mCachedCapabilities.contains( configFilePath ) && mCachedCapabilities[ configFilePath ].contains( key ) )
   {
+    QgsServerMetrics::instance()->addCount( QgsServerMetrics::CapabilitiesCacheHits );
     return &mCachedCapabilities[ configFilePath ][ key ];
   }
   else
   {
+    QgsServerMetrics::instance()->addCount( QgsServerMetrics::CapabilitiesCacheMisses );
     return nullptr;
   }
 }
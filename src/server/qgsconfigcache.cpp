@@ -20,6 +20,8 @@
 #include "qgsmslayercache.h"
 #include "qgsaccesscontrol.h"
 #include "qgsproject.h"
+#include "qgsserversettings.h"
+#include "qgsservermetrics.h"
 
 #include <QFile>
 
@@ -38,17 +40,34 @@ QgsConfigCache::QgsConfigCache()
   QObject::connect( &mFileSystemWatcher, &QFileSystemWatcher::fileChanged, this, &QgsConfigCache::removeChangedEntry );
 }
 
-const QgsProject *QgsConfigCache::project( const QString &path )
+const QgsProject *QgsConfigCache::project( const QString &path, const QgsServerSettings *settings )
 {
   if ( ! mProjectCache[ path ] )
   {
+    QgsServerMetrics::instance()->addCount( QgsServerMetrics::ConfigCacheMisses );
+
+    // avoid costly provider round trips (extent, primary key checks) and
+    // unneeded layouts when the server configuration allows it
+    QgsProject::ReadFlags readFlags = QgsProject::ReadFlags();
+    if ( settings )
+    {
+      if ( settings->trustLayerMetadata() )
+        readFlags |= QgsProject::FlagTrustLayerMetadata;
+      if ( settings->getPrintDisabled() )
+        readFlags |= QgsProject::FlagDontLoadLayouts;
+    }
+
     std::unique_ptr<QgsProject> prj( new QgsProject() );
-    if ( prj->read( path ) )
+    if ( prj->read( path, readFlags ) )
     {
       mProjectCache.insert( path, prj.release() );
       mFileSystemWatcher.addPath( path );
     }
   }
+  else
+  {
+    QgsServerMetrics::instance()->addCount( QgsServerMetrics::ConfigCacheHits );
+  }
 
   return mProjectCache[ path ];
 }
@@ -31,6 +31,7 @@
 #include "qgsproject.h"
 
 class QgsAccessControl;
+class QgsServerSettings;
 
 class SERVER_EXPORT QgsConfigCache : public QObject
 {
@@ -44,10 +45,11 @@ class SERVER_EXPORT QgsConfigCache : public QObject
      * If the project is not cached yet, then the project is read thank to the
      *  path. If the project is not available, then a nullptr is returned.
      * \param path the filename of the QGIS project
+     * \param settings the server settings used to define the project's read flags
      * \returns the project or nullptr if an error happened
      * \since QGIS 3.0
      */
-    const QgsProject *project( const QString &path );
+    const QgsProject *project( const QString &path, const QgsServerSettings *settings = nullptr );
 
   private:
     QgsConfigCache() SIP_FORCE;
@@ -33,6 +33,7 @@
 #include "qgsmapserviceexception.h"
 #include "qgsnetworkaccessmanager.h"
 #include "qgsserverlogger.h"
+#include "qgsservermetrics.h"
 #include "qgsserverrequest.h"
 #include "qgsbufferserverresponse.h"
 #include "qgsbufferserverrequest.h"
@@ -65,6 +66,16 @@ QgsServerSettings QgsServer::sSettings;
 
 QgsServiceRegistry *QgsServer::sServiceRegistry = nullptr;
 
+namespace
+{
+  //! Returns true if the request asks for the server metrics
+  bool isMetricsRequest( const QgsServerRequest &request )
+  {
+    return request.url().path().endsWith( QLatin1String( "/metrics" ) )
+           || request.parameter( QStringLiteral( "SERVICE" ) ).compare( QLatin1String( "METRICS" ), Qt::CaseInsensitive ) == 0;
+  }
+}
+
 QgsServer::QgsServer()
 {
   // QgsApplication must exist
@@ -211,6 +222,9 @@ bool QgsServer::init()
   QgsServerLogger::instance()->setLogLevel( sSettings.logLevel() );
   QgsServerLogger::instance()->setLogFile( sSettings.logFile() );
 
+  // init and configure metrics
+  QgsServerMetrics::instance()->setEnabled( sSettings.metricsEnabled() );
+
   // init and configure cache
   QgsMSLayerCache::instance();
   QgsMSLayerCache::instance()->setMaxCacheLayers( sSettings.maxCacheLayers() );
@@ -287,6 +301,7 @@ void QgsServer::putenv( const QString &var, const QString &val )
   setenv( var.toStdString().c_str(), val.toStdString().c_str(), 1 );
 #endif
   sSettings.load( var );
+  QgsServerMetrics::instance()->setEnabled( sSettings.metricsEnabled() );
 }
 
 /**
@@ -306,6 +321,11 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
     time.start();
   }
 
+  QgsServerMetrics *metrics = QgsServerMetrics::instance();
+  metrics->startRequest();
+  metrics->addCount( QgsServerMetrics::Requests );
+  QgsServerStageTimer requestTimer( QgsServerMetrics::TotalRequest );
+
   // Pass the filters to the requestHandler, this is needed for the following reasons:
   // Allow server request to call sendResponse plugin hook if enabled
   QgsFilterResponseDecorator responseDecorator( sServerInterface->filters(), response );
@@ -315,6 +335,7 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
 
   try
   {
+    QgsServerStageTimer parseTimer( QgsServerMetrics::ParametersParsing );
     // TODO: split parse input into plain parse and processing from specific services
     requestHandler.parseInput();
   }
@@ -331,7 +352,13 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
   responseDecorator.start();
 
   // Plugins may have set exceptions
-  if ( !requestHandler.exceptionRaised() )
+  if ( !requestHandler.exceptionRaised() && metrics->isEnabled() && isMetricsRequest( request ) )
+  {
+    // built-in metrics output, handled without any project
+    responseDecorator.setHeader( QStringLiteral( "Content-Type" ), QStringLiteral( "text/plain; version=0.0.4" ) );
+    responseDecorator.write( metrics->toPrometheus() );
+  }
+  else if ( !requestHandler.exceptionRaised() )
   {
     try
     {
@@ -344,7 +371,8 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
         QString configFilePath = configPath( *sConfigFilePath, parameterMap );
 
         // load the project if needed and not empty
-        project = mConfigCache->project( configFilePath );
+        QgsServerStageTimer projectTimer( QgsServerMetrics::ProjectLoad );
+        project = mConfigCache->project( configFilePath, &sSettings );
         if ( ! project )
         {
           throw QgsServerException( QStringLiteral( "Project file error" ) );
@@ -408,9 +436,15 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
   // to a deleted request handler from Python bindings
   sServerInterface->clearRequestHandler();
 
+  requestTimer.stop();
+
   if ( logLevel == Qgis::Info )
   {
-    QgsMessageLog::logMessage( "Request finished in " + QString::number( time.elapsed() ) + " ms", QStringLiteral( "Server" ), Qgis::Info );
+    QString message = "Request finished in " + QString::number( time.elapsed() ) + " ms";
+    const QString stages = metrics->requestSummary();
+    if ( !stages.isEmpty() )
+      message += " (" + stages + ")";
+    QgsMessageLog::logMessage( message, QStringLiteral( "Server" ), Qgis::Info );
   }
 }
 
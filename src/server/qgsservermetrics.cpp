@@ -0,0 +1,190 @@
+/***************************************************************************
+                              qgsservermetrics.cpp
+                              --------------------
+  begin                : December 2017
+  copyright            : (C) 2017 by the QGIS project
+  email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsservermetrics.h"
+
+#include <QStringList>
+
+QgsServerMetrics *QgsServerMetrics::instance()
+{
+  static QgsServerMetrics *sInstance = nullptr;
+
+  if ( !sInstance )
+    sInstance = new QgsServerMetrics();
+
+  return sInstance;
+}
+
+QgsServerMetrics::QgsServerMetrics()
+{
+  reset();
+}
+
+void QgsServerMetrics::addCount( QgsServerMetrics::Counter counter, qint64 value )
+{
+  if ( !mEnabled )
+    return;
+
+  mCounters[counter].fetch_add( value, std::memory_order_relaxed );
+}
+
+qint64 QgsServerMetrics::count( QgsServerMetrics::Counter counter ) const
+{
+  return mCounters[counter].load( std::memory_order_relaxed );
+}
+
+void QgsServerMetrics::addStageTime( QgsServerMetrics::Stage stage, qint64 elapsed )
+{
+  if ( !mEnabled )
+    return;
+
+  mStageTimes[stage].fetch_add( elapsed, std::memory_order_relaxed );
+  mStageCounts[stage].fetch_add( 1, std::memory_order_relaxed );
+  mRequestStageTimes[stage].fetch_add( elapsed, std::memory_order_relaxed );
+}
+
+qint64 QgsServerMetrics::stageTime( QgsServerMetrics::Stage stage ) const
+{
+  return mStageTimes[stage].load( std::memory_order_relaxed );
+}
+
+void QgsServerMetrics::startRequest()
+{
+  for ( int i = 0; i < StageCount; ++i )
+    mRequestStageTimes[i].store( 0, std::memory_order_relaxed );
+}
+
+QString QgsServerMetrics::requestSummary() const
+{
+  QStringList stages;
+  for ( int i = 0; i < StageCount; ++i )
+  {
+    const Stage stage = static_cast< Stage >( i );
+    if ( stage == TotalRequest )
+      continue;
+
+    const qint64 elapsed = mRequestStageTimes[i].load( std::memory_order_relaxed );
+    if ( elapsed > 0 )
+      stages << QStringLiteral( "%1: %2 ms" ).arg( stageName( stage ) ).arg( elapsed / 1000.0, 0, 'f', 3 );
+  }
+  return stages.join( QStringLiteral( ", " ) );
+}
+
+QByteArray QgsServerMetrics::toPrometheus() const
+{
+  struct CounterDefinition
+  {
+    Counter counter;
+    const char *name;
+    const char *help;
+  };
+
+  static const CounterDefinition sCounters[] =
+  {
+    { Requests, "qgis_server_requests_total", "Number of handled requests" },
+    { ConfigCacheHits, "qgis_server_config_cache_hits_total", "Projects found in the configuration cache" },
+    { ConfigCacheMisses, "qgis_server_config_cache_misses_total", "Projects read because not yet cached" },
+    { CapabilitiesCacheHits, "qgis_server_capabilities_cache_hits_total", "Capabilities documents found in the cache" },
+    { CapabilitiesCacheMisses, "qgis_server_capabilities_cache_misses_total", "Capabilities documents not found in the cache" },
+    { RenderedPixels, "qgis_server_rendered_pixels_total", "Number of pixels of rendered images" },
+    { FeaturesFetched, "qgis_server_features_fetched_total", "Number of features returned by feature queries" },
+  };
+
+  QByteArray out;
+  for ( const CounterDefinition &def : sCounters )
+  {
+    out += QByteArray( "# HELP " ) + def.name + ' ' + def.help + '\n';
+    out += QByteArray( "# TYPE " ) + def.name + " counter\n";
+    out += QByteArray( def.name ) + ' ' + QByteArray::number( count( def.counter ) ) + '\n';
+  }
+
+  out += "# HELP qgis_server_stage_seconds_total Time spent in request stages\n";
+  out += "# TYPE qgis_server_stage_seconds_total counter\n";
+  for ( int i = 0; i < StageCount; ++i )
+  {
+    const Stage stage = static_cast< Stage >( i );
+    out += "qgis_server_stage_seconds_total{stage=\"" + stageName( stage ).toLatin1() + "\"} "
+           + QByteArray::number( stageTime( stage ) / 1000000.0, 'f', 6 ) + '\n';
+  }
+
+  out += "# HELP qgis_server_stage_runs_total Number of measured request stages\n";
+  out += "# TYPE qgis_server_stage_runs_total counter\n";
+  for ( int i = 0; i < StageCount; ++i )
+  {
+    const Stage stage = static_cast< Stage >( i );
+    out += "qgis_server_stage_runs_total{stage=\"" + stageName( stage ).toLatin1() + "\"} "
+           + QByteArray::number( mStageCounts[i].load( std::memory_order_relaxed ) ) + '\n';
+  }
+
+  return out;
+}
+
+void QgsServerMetrics::reset()
+{
+  for ( int i = 0; i < CounterCount; ++i )
+    mCounters[i].store( 0, std::memory_order_relaxed );
+
+  for ( int i = 0; i < StageCount; ++i )
+  {
+    mStageTimes[i].store( 0, std::memory_order_relaxed );
+    mStageCounts[i].store( 0, std::memory_order_relaxed );
+    mRequestStageTimes[i].store( 0, std::memory_order_relaxed );
+  }
+}
+
+QString QgsServerMetrics::stageName( QgsServerMetrics::Stage stage )
+{
+  switch ( stage )
+  {
+    case ProjectLoad:
+      return QStringLiteral( "project_load" );
+    case ParametersParsing:
+      return QStringLiteral( "parameters_parsing" );
+    case LayersSetup:
+      return QStringLiteral( "layers_setup" );
+    case Rendering:
+      return QStringLiteral( "rendering" );
+    case Encoding:
+      return QStringLiteral( "encoding" );
+    case TotalRequest:
+      return QStringLiteral( "total" );
+    case StageCount:
+      break;
+  }
+  return QString();
+}
+
+QgsServerStageTimer::QgsServerStageTimer( QgsServerMetrics::Stage stage )
+  : mStage( stage )
+{
+  if ( QgsServerMetrics::instance()->isEnabled() )
+    mTimer.start();
+}
+
+QgsServerStageTimer::~QgsServerStageTimer()
+{
+  stop();
+}
+
+void QgsServerStageTimer::stop()
+{
+  if ( mTimer.isValid() )
+  {
+    QgsServerMetrics::instance()->addStageTime( mStage, mTimer.nsecsElapsed() / 1000 );
+    mTimer.invalidate();
+  }
+}
@@ -0,0 +1,171 @@
+/***************************************************************************
+                              qgsservermetrics.h
+                              ------------------
+  begin                : December 2017
+  copyright            : (C) 2017 by the QGIS project
+  email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSSERVERMETRICS_H
+#define QGSSERVERMETRICS_H
+
+#define SIP_NO_FILE
+
+#include "qgis_server.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+
+#include <atomic>
+
+/**
+ * \ingroup server
+ * Collects server wide counters and per stage timings of requests.
+ *
+ * Values are stored in atomic integers, so that updating a metric is cheap
+ * enough to be left enabled in production. Metrics may be exported in the
+ * Prometheus text exposition format with toPrometheus().
+ * \since QGIS 3.0
+ */
+class SERVER_EXPORT QgsServerMetrics
+{
+  public:
+
+    //! Server counters
+    enum Counter
+    {
+      Requests = 0, //!< Number of handled requests
+      ConfigCacheHits, //!< Projects found in the configuration cache
+      ConfigCacheMisses, //!< Projects read because not yet cached
+      CapabilitiesCacheHits, //!< Capabilities documents found in the cache
+      CapabilitiesCacheMisses, //!< Capabilities documents not found in the cache
+      RenderedPixels, //!< Number of pixels of rendered images
+      FeaturesFetched, //!< Number of features returned by feature queries
+      CounterCount //!< Number of counters, must be last
+    };
+
+    //! Request stages for which timing is measured
+    enum Stage
+    {
+      ProjectLoad = 0, //!< Project lookup and loading
+      ParametersParsing, //!< Request parameters parsing
+      LayersSetup, //!< Layers styling, filtering and map settings configuration
+      Rendering, //!< Map rendering, labeling included
+      Encoding, //!< Response encoding (image or document)
+      TotalRequest, //!< Complete request handling
+      StageCount //!< Number of stages, must be last
+    };
+
+    /**
+     * Returns the singleton instance.
+     */
+    static QgsServerMetrics *instance();
+
+    /**
+     * Returns true if the metrics are collected.
+     */
+    bool isEnabled() const { return mEnabled; }
+
+    /**
+     * Activates or deactivates metrics collection.
+     */
+    void setEnabled( bool enabled ) { mEnabled = enabled; }
+
+    /**
+     * Adds \a value to the \a counter.
+     */
+    void addCount( Counter counter, qint64 value = 1 );
+
+    /**
+     * Returns the current value of the \a counter.
+     */
+    qint64 count( Counter counter ) const;
+
+    /**
+     * Adds an \a elapsed time in microseconds to the \a stage. The time is
+     * also accounted to the request currently handled.
+     */
+    void addStageTime( Stage stage, qint64 elapsed );
+
+    /**
+     * Returns the cumulated time in microseconds spent in the \a stage.
+     */
+    qint64 stageTime( Stage stage ) const;
+
+    /**
+     * Resets the per stage timings of the request currently handled.
+     */
+    void startRequest();
+
+    /**
+     * Returns a human readable summary of the per stage timings of the
+     * request currently handled.
+     */
+    QString requestSummary() const;
+
+    /**
+     * Returns all metrics in the Prometheus text exposition format.
+     */
+    QByteArray toPrometheus() const;
+
+    /**
+     * Resets all the metrics.
+     */
+    void reset();
+
+  private:
+    QgsServerMetrics();
+
+    static QString stageName( Stage stage );
+
+    bool mEnabled = false;
+    std::atomic<qint64> mCounters[CounterCount];
+    std::atomic<qint64> mStageTimes[StageCount];
+    std::atomic<qint64> mStageCounts[StageCount];
+    std::atomic<qint64> mRequestStageTimes[StageCount];
+};
+
+/**
+ * \ingroup server
+ * Measures the time spent in a request stage during its lifetime and adds it
+ * to the server metrics on destruction.
+ * \since QGIS 3.0
+ */
+class SERVER_EXPORT QgsServerStageTimer
+{
+  public:
+
+    /**
+     * Constructor for QgsServerStageTimer, starting the measurement of \a stage.
+     */
+    explicit QgsServerStageTimer( QgsServerMetrics::Stage stage );
+
+    ~QgsServerStageTimer();
+
+    /**
+     * Stops the measurement and adds the elapsed time to the server metrics.
+     * Nothing is added on destruction once stopped.
+     */
+    void stop();
+
+    //! QgsServerStageTimer cannot be copied
+    QgsServerStageTimer( const QgsServerStageTimer &rh ) = delete;
+    //! QgsServerStageTimer cannot be copied
+    QgsServerStageTimer &operator=( const QgsServerStageTimer &rh ) = delete;
+
+  private:
+    QgsServerMetrics::Stage mStage;
+    QElapsedTimer mTimer;
+};
+
+#endif // QGSSERVERMETRICS_H
@@ -130,6 +130,39 @@ void QgsServerSettings::initSettings()
                                QVariant()
                              };
   mSettings[ sCacheSize.envVar ] = sCacheSize;
+
+  // trust layer metadata
+  const Setting sTrustLayerMetadata = { QgsServerSettingsEnv::QGIS_SERVER_TRUST_LAYER_METADATA,
+                                        QgsServerSettingsEnv::DEFAULT_VALUE,
+                                        "Trust layer metadata (extent, primary key unicity) when reading projects",
+                                        "",
+                                        QVariant::Bool,
+                                        QVariant( false ),
+                                        QVariant()
+                                      };
+  mSettings[ sTrustLayerMetadata.envVar ] = sTrustLayerMetadata;
+
+  // don't load layouts
+  const Setting sDontLoadLayouts = { QgsServerSettingsEnv::QGIS_SERVER_DISABLE_GETPRINT,
+                                     QgsServerSettingsEnv::DEFAULT_VALUE,
+                                     "Disable WMS GetPrint request and don't load layouts when reading projects",
+                                     "",
+                                     QVariant::Bool,
+                                     QVariant( false ),
+                                     QVariant()
+                                   };
+  mSettings[ sDontLoadLayouts.envVar ] = sDontLoadLayouts;
+
+  // metrics
+  const Setting sMetrics = { QgsServerSettingsEnv::QGIS_SERVER_METRICS,
+                             QgsServerSettingsEnv::DEFAULT_VALUE,
+                             "Activate/Deactivate request metrics and the METRICS service",
+                             "/qgis/server_metrics",
+                             QVariant::Bool,
+                             QVariant( false ),
+                             QVariant()
+                           };
+  mSettings[ sMetrics.envVar ] = sMetrics;
 }
 
 void QgsServerSettings::load()
@@ -305,3 +338,18 @@ QString QgsServerSettings::cacheDirectory() const
 {
   return value( QgsServerSettingsEnv::QGIS_SERVER_CACHE_DIRECTORY ).toString();
 }
+
+bool QgsServerSettings::trustLayerMetadata() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_TRUST_LAYER_METADATA ).toBool();
+}
+
+bool QgsServerSettings::getPrintDisabled() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_DISABLE_GETPRINT ).toBool();
+}
+
+bool QgsServerSettings::metricsEnabled() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_METRICS ).toBool();
+}
@@ -56,7 +56,10 @@ class SERVER_EXPORT QgsServerSettingsEnv : public QObject
       QGIS_PROJECT_FILE,
       MAX_CACHE_LAYERS,
       QGIS_SERVER_CACHE_DIRECTORY,
-      QGIS_SERVER_CACHE_SIZE
+      QGIS_SERVER_CACHE_SIZE,
+      QGIS_SERVER_TRUST_LAYER_METADATA,
+      QGIS_SERVER_DISABLE_GETPRINT,
+      QGIS_SERVER_METRICS
     };
     Q_ENUM( EnvVar )
 };
@@ -157,6 +160,35 @@ class SERVER_EXPORT QgsServerSettings
       */
     QString cacheDirectory() const;
 
+    /**
+     * Returns true if the reading flag trust layer metadata is activated.
+     * The default value is false, this value can be changed by setting the
+     * environment variable QGIS_SERVER_TRUST_LAYER_METADATA.
+     * \returns true if the trust layer metadata flag is activated.
+     * \since QGIS 3.0
+     */
+    bool trustLayerMetadata() const;
+
+    /**
+     * Returns true if WMS GetPrint request is disabled and the project's
+     * reading flag QgsProject::FlagDontLoadLayouts is activated.
+     * The default value is false, this value can be changed by setting the
+     * environment variable QGIS_SERVER_DISABLE_GETPRINT.
+     * \returns true if the dont load layouts flag is activated.
+     * \since QGIS 3.0
+     */
+    bool getPrintDisabled() const;
+
+    /**
+     * Returns true if request metrics (counters and per stage timings) are
+     * collected and may be retrieved with the METRICS service.
+     * The default value is false, this value can be changed by setting the
+     * environment variable QGIS_SERVER_METRICS.
+     * \returns true if metrics are activated.
+     * \since QGIS 3.0
+     */
+    bool metricsEnabled() const;
+
   private:
     void initSettings();
     QVariant value( QgsServerSettingsEnv::EnvVar envVar ) const;
@@ -0,0 +1,416 @@
+/***************************************************************************
+                              qgsmvtencoder.cpp
+
+  Mapbox Vector Tile encoder
+  --------------------------
+  begin                : December 2017
+  copyright            : (C) 2017 by the QGIS project
+  email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgsmvtencoder.h"
+#include "qgsclipper.h"
+#include "qgslinestring.h"
+
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace QgsWms
+{
+
+  namespace
+  {
+    // protocol buffers wire types
+    const int WIRE_VARINT = 0;
+    const int WIRE_64BIT = 1;
+    const int WIRE_LENGTH_DELIMITED = 2;
+
+    // vector tile geometry commands
+    const quint32 CMD_MOVE_TO = 1;
+    const quint32 CMD_LINE_TO = 2;
+    const quint32 CMD_CLOSE_PATH = 7;
+
+    // vector tile geometry types
+    const quint32 GEOM_POINT = 1;
+    const quint32 GEOM_LINESTRING = 2;
+    const quint32 GEOM_POLYGON = 3;
+
+    void writeVarint( QByteArray &out, quint64 value )
+    {
+      while ( value >= 0x80 )
+      {
+        out.append( static_cast<char>( ( value & 0x7f ) | 0x80 ) );
+        value >>= 7;
+      }
+      out.append( static_cast<char>( value ) );
+    }
+
+    void writeTag( QByteArray &out, int field, int wireType )
+    {
+      writeVarint( out, static_cast<quint64>( ( field << 3 ) | wireType ) );
+    }
+
+    void writeVarintField( QByteArray &out, int field, quint64 value )
+    {
+      writeTag( out, field, WIRE_VARINT );
+      writeVarint( out, value );
+    }
+
+    void writeBytesField( QByteArray &out, int field, const QByteArray &data )
+    {
+      writeTag( out, field, WIRE_LENGTH_DELIMITED );
+      writeVarint( out, static_cast<quint64>( data.size() ) );
+      out.append( data );
+    }
+
+    void writePackedField( QByteArray &out, int field, const QVector<quint32> &values )
+    {
+      QByteArray packed;
+      packed.reserve( values.size() * 2 );
+      for ( quint32 value : values )
+        writeVarint( packed, value );
+      writeBytesField( out, field, packed );
+    }
+
+    void writeDoubleField( QByteArray &out, int field, double value )
+    {
+      quint64 bits;
+      std::memcpy( &bits, &value, sizeof( bits ) );
+      uchar data[8];
+      qToLittleEndian<quint64>( bits, data );
+      writeTag( out, field, WIRE_64BIT );
+      out.append( reinterpret_cast<const char *>( data ), 8 );
+    }
+
+    quint32 zigZag( int value )
+    {
+      return static_cast<quint32>( ( value << 1 ) ^ ( value >> 31 ) );
+    }
+
+    quint32 command( quint32 id, int count )
+    {
+      return ( id & 0x7 ) | ( static_cast<quint32>( count ) << 3 );
+    }
+
+    QPolygonF toPolygonF( const QgsPolylineXY &points )
+    {
+      QPolygonF polygon;
+      polygon.reserve( points.size() );
+      for ( const QgsPointXY &point : points )
+        polygon << QPointF( point.x(), point.y() );
+      return polygon;
+    }
+  }
+
+  QgsMvtEncoder::QgsMvtEncoder( const QgsRectangle &extent, int resolution, int buffer )
+    : mExtent( extent )
+    , mResolution( resolution )
+  {
+    mScaleX = mExtent.width() > 0 ? mResolution / mExtent.width() : 1.0;
+    mScaleY = mExtent.height() > 0 ? mResolution / mExtent.height() : 1.0;
+
+    mClipExtent = mExtent;
+    mClipExtent.setXMinimum( mExtent.xMinimum() - buffer / mScaleX );
+    mClipExtent.setXMaximum( mExtent.xMaximum() + buffer / mScaleX );
+    mClipExtent.setYMinimum( mExtent.yMinimum() - buffer / mScaleY );
+    mClipExtent.setYMaximum( mExtent.yMaximum() + buffer / mScaleY );
+  }
+
+  void QgsMvtEncoder::setSimplifyTolerance( double tolerance )
+  {
+    if ( tolerance > 0 )
+      mSimplifier.reset( new QgsMapToPixelSimplifier( QgsMapToPixelSimplifier::SimplifyGeometry, tolerance ) );
+    else
+      mSimplifier.reset();
+  }
+
+  void QgsMvtEncoder::startLayer( const QString &name )
+  {
+    mLayer = Layer();
+    mLayer.name = name;
+  }
+
+  bool QgsMvtEncoder::addFeature( const QgsFeature &feature, const QgsFields &fields, const QgsAttributeList &attributes )
+  {
+    QgsGeometry geom = feature.geometry();
+    if ( geom.isNull() || !geom.boundingBox().intersects( mClipExtent ) )
+      return false;
+
+    if ( QgsWkbTypes::isCurvedType( geom.wkbType() ) )
+      geom.convertToStraightSegment();
+
+    if ( mSimplifier && geom.type() != QgsWkbTypes::PointGeometry )
+      geom = mSimplifier->simplify( geom );
+
+    // geometry commands, the cursor is relative to each feature
+    mCursor = QPoint( 0, 0 );
+    QVector<quint32> commands;
+    quint32 type = 0;
+
+    switch ( geom.type() )
+    {
+      case QgsWkbTypes::PointGeometry:
+      {
+        type = GEOM_POINT;
+        const QgsMultiPointXY points = geom.isMultipart() ? geom.asMultiPoint() : QgsMultiPointXY() << geom.asPoint();
+        QVector<QPoint> gridPoints;
+        gridPoints.reserve( points.size() );
+        for ( const QgsPointXY &point : points )
+        {
+          if ( mClipExtent.contains( point ) )
+            gridPoints << toGrid( point.x(), point.y() );
+        }
+        encodePoints( gridPoints, commands );
+        break;
+      }
+
+      case QgsWkbTypes::LineGeometry:
+      {
+        type = GEOM_LINESTRING;
+        const QgsMultiPolylineXY lines = geom.isMultipart() ? geom.asMultiPolyline() : QgsMultiPolylineXY() << geom.asPolyline();
+        for ( const QgsPolylineXY &line : lines )
+        {
+          const QgsLineString curve( line );
+          encodeLine( QgsClipper::clippedLine( curve, mClipExtent ), commands );
+        }
+        break;
+      }
+
+      case QgsWkbTypes::PolygonGeometry:
+      {
+        type = GEOM_POLYGON;
+        const QgsMultiPolygonXY polygons = geom.isMultipart() ? geom.asMultiPolygon() : QgsMultiPolygonXY() << geom.asPolygon();
+        for ( const QgsPolygonXY &polygon : polygons )
+        {
+          for ( int i = 0; i < polygon.size(); ++i )
+          {
+            QPolygonF ring = toPolygonF( polygon.at( i ) );
+            QgsClipper::trimPolygon( ring, mClipExtent );
+
+            // interior rings of a discarded exterior ring are discarded too
+            if ( !encodeRing( ring, i == 0, commands ) && i == 0 )
+              break;
+          }
+        }
+        break;
+      }
+
+      case QgsWkbTypes::UnknownGeometry:
+      case QgsWkbTypes::NullGeometry:
+        break;
+    }
+
+    if ( commands.isEmpty() )
+      return false;
+
+    QByteArray data;
+    if ( feature.id() >= 0 )
+      writeVarintField( data, 1, static_cast<quint64>( feature.id() ) );
+
+    QVector<quint32> tags;
+    for ( int idx : attributes )
+    {
+      const QVariant value = feature.attribute( idx );
+      if ( idx < 0 || idx >= fields.count() || value.isNull() )
+        continue;
+
+      tags << keyIndex( fields.at( idx ).name() ) << valueIndex( value );
+    }
+    if ( !tags.isEmpty() )
+      writePackedField( data, 2, tags );
+
+    writeVarintField( data, 3, type );
+    writePackedField( data, 4, commands );
+
+    writeBytesField( mLayer.features, 2, data );
+    ++mLayer.featureCount;
+    return true;
+  }
+
+  void QgsMvtEncoder::endLayer()
+  {
+    if ( mLayer.featureCount == 0 )
+      return;
+
+    QByteArray data;
+    writeVarintField( data, 15, 2 ); // version
+    writeBytesField( data, 1, mLayer.name.toUtf8() );
+    data.append( mLayer.features );
+    for ( const QString &key : qgis::as_const( mLayer.keys ) )
+      writeBytesField( data, 3, key.toUtf8() );
+    data.append( mLayer.values );
+    writeVarintField( data, 5, static_cast<quint64>( mResolution ) );
+
+    writeBytesField( mTile, 3, data );
+    mLayer = Layer();
+  }
+
+  QByteArray QgsMvtEncoder::encode() const
+  {
+    return mTile;
+  }
+
+  quint32 QgsMvtEncoder::keyIndex( const QString &key )
+  {
+    auto it = mLayer.keyIndexes.constFind( key );
+    if ( it != mLayer.keyIndexes.constEnd() )
+      return static_cast<quint32>( it.value() );
+
+    const int index = mLayer.keys.size();
+    mLayer.keys << key;
+    mLayer.keyIndexes.insert( key, index );
+    return static_cast<quint32>( index );
+  }
+
+  quint32 QgsMvtEncoder::valueIndex( const QVariant &value )
+  {
+    // values of different types must not be merged, e.g. "1" and 1
+    const QString id = QStringLiteral( "%1:%2" ).arg( value.type() ).arg( value.toString() );
+    auto it = mLayer.valueIndexes.constFind( id );
+    if ( it != mLayer.valueIndexes.constEnd() )
+      return static_cast<quint32>( it.value() );
+
+    QByteArray data;
+    switch ( value.type() )
+    {
+      case QVariant::Bool:
+        writeVarintField( data, 7, value.toBool() ? 1 : 0 );
+        break;
+
+      case QVariant::Int:
+      case QVariant::LongLong:
+      {
+        const qint64 v = value.toLongLong();
+        if ( v < 0 )
+          writeVarintField( data, 6, static_cast<quint64>( ( v << 1 ) ^ ( v >> 63 ) ) );
+        else
+          writeVarintField( data, 5, static_cast<quint64>( v ) );
+        break;
+      }
+
+      case QVariant::UInt:
+      case QVariant::ULongLong:
+        writeVarintField( data, 5, value.toULongLong() );
+        break;
+
+      case QVariant::Double:
+        writeDoubleField( data, 3, value.toDouble() );
+        break;
+
+      default:
+        writeBytesField( data, 1, value.toString().toUtf8() );
+        break;
+    }
+
+    writeBytesField( mLayer.values, 4, data );
+    const int index = mLayer.valueCount++;
+    mLayer.valueIndexes.insert( id, index );
+    return static_cast<quint32>( index );
+  }
+
+  QPoint QgsMvtEncoder::toGrid( double x, double y ) const
+  {
+    // the tile grid origin is the top left corner
+    return QPoint( qRound( ( x - mExtent.xMinimum() ) * mScaleX ),
+                   qRound( ( mExtent.yMaximum() - y ) * mScaleY ) );
+  }
+
+  void QgsMvtEncoder::encodePoints( const QVector<QPoint> &points, QVector<quint32> &commands )
+  {
+    if ( points.isEmpty() )
+      return;
+
+    commands << command( CMD_MOVE_TO, points.size() );
+    for ( const QPoint &point : points )
+    {
+      commands << zigZag( point.x() - mCursor.x() ) << zigZag( point.y() - mCursor.y() );
+      mCursor = point;
+    }
+  }
+
+  bool QgsMvtEncoder::encodeLine( const QPolygonF &line, QVector<quint32> &commands )
+  {
+    QVector<QPoint> points;
+    points.reserve( line.size() );
+    for ( const QPointF &point : line )
+    {
+      const QPoint gridPoint = toGrid( point.x(), point.y() );
+      if ( points.isEmpty() || points.last() != gridPoint )
+        points << gridPoint;
+    }
+
+    if ( points.size() < 2 )
+      return false;
+
+    commands << command( CMD_MOVE_TO, 1 )
+             << zigZag( points.at( 0 ).x() - mCursor.x() ) << zigZag( points.at( 0 ).y() - mCursor.y() );
+    mCursor = points.at( 0 );
+
+    commands << command( CMD_LINE_TO, points.size() - 1 );
+    for ( int i = 1; i < points.size(); ++i )
+    {
+      commands << zigZag( points.at( i ).x() - mCursor.x() ) << zigZag( points.at( i ).y() - mCursor.y() );
+      mCursor = points.at( i );
+    }
+    return true;
+  }
+
+  bool QgsMvtEncoder::encodeRing( const QPolygonF &ring, bool exterior, QVector<quint32> &commands )
+  {
+    QVector<QPoint> points;
+    points.reserve( ring.size() );
+    for ( const QPointF &point : ring )
+    {
+      const QPoint gridPoint = toGrid( point.x(), point.y() );
+      if ( points.isEmpty() || points.last() != gridPoint )
+        points << gridPoint;
+    }
+
+    // the ring is closed by the ClosePath command
+    while ( points.size() > 1 && points.first() == points.last() )
+      points.removeLast();
+
+    if ( points.size() < 3 )
+      return false;
+
+    // exterior rings must have a positive area in grid coordinates (y axis
+    // pointing down), interior rings a negative one
+    qint64 area = 0;
+    for ( int i = 0; i < points.size(); ++i )
+    {
+      const QPoint &p1 = points.at( i );
+      const QPoint &p2 = points.at( ( i + 1 ) % points.size() );
+      area += static_cast<qint64>( p1.x() ) * p2.y() - static_cast<qint64>( p2.x() ) * p1.y();
+    }
+
+    if ( area == 0 )
+      return false;
+
+    if ( ( area > 0 ) != exterior )
+      std::reverse( points.begin(), points.end() );
+
+    commands << command( CMD_MOVE_TO, 1 )
+             << zigZag( points.at( 0 ).x() - mCursor.x() ) << zigZag( points.at( 0 ).y() - mCursor.y() );
+    mCursor = points.at( 0 );
+
+    commands << command( CMD_LINE_TO, points.size() - 1 );
+    for ( int i = 1; i < points.size(); ++i )
+    {
+      commands << zigZag( points.at( i ).x() - mCursor.x() ) << zigZag( points.at( i ).y() - mCursor.y() );
+      mCursor = points.at( i );
+    }
+
+    commands << command( CMD_CLOSE_PATH, 1 );
+    return true;
+  }
+
+} // namespace QgsWms
@@ -0,0 +1,121 @@
+/***************************************************************************
+                              qgsmvtencoder.h
+
+  Mapbox Vector Tile encoder
+  --------------------------
+  begin                : December 2017
+  copyright            : (C) 2017 by the QGIS project
+  email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSMVTENCODER_H
+#define QGSMVTENCODER_H
+
+#include "qgsrectangle.h"
+#include "qgsfeature.h"
+#include "qgsmaptopixelgeometrysimplifier.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QPolygonF>
+#include <QVector>
+#include <memory>
+
+namespace QgsWms
+{
+
+  /**
+   * \ingroup server
+   * Encodes features into a Mapbox Vector Tile (protocol buffers, version 2
+   * of the specification).
+   *
+   * Geometries are expected in the CRS of the tile extent. They are
+   * simplified, clipped to the tile extent enlarged by a buffer and
+   * quantized to the tile grid.
+   */
+  class QgsMvtEncoder
+  {
+    public:
+
+      /**
+       * Constructor for QgsMvtEncoder.
+       * \param extent the tile extent in map units
+       * \param resolution number of grid units along a tile side
+       * \param buffer number of grid units kept around the tile when clipping
+       */
+      QgsMvtEncoder( const QgsRectangle &extent, int resolution = 4096, int buffer = 64 );
+
+      /**
+       * Sets the \a tolerance in map units used to simplify line and polygon
+       * geometries. A tolerance of 0 disables the simplification.
+       */
+      void setSimplifyTolerance( double tolerance );
+
+      /**
+       * Starts a new layer named \a name. Following features are added to
+       * this layer until endLayer() is called.
+       */
+      void startLayer( const QString &name );
+
+      /**
+       * Adds a \a feature to the current layer. Only the \a attributes
+       * indexes of \a fields are encoded, null values are skipped.
+       * \returns false if the feature does not intersect the tile
+       */
+      bool addFeature( const QgsFeature &feature, const QgsFields &fields, const QgsAttributeList &attributes );
+
+      /**
+       * Ends the current layer. Layers without any feature are discarded.
+       */
+      void endLayer();
+
+      /**
+       * Returns the encoded tile.
+       */
+      QByteArray encode() const;
+
+    private:
+
+      struct Layer
+      {
+        QString name;
+        QByteArray features;
+        int featureCount = 0;
+        QStringList keys;
+        QHash<QString, int> keyIndexes;
+        QByteArray values;
+        QHash<QString, int> valueIndexes;
+        int valueCount = 0;
+      };
+
+      quint32 keyIndex( const QString &key );
+      quint32 valueIndex( const QVariant &value );
+
+      QPoint toGrid( double x, double y ) const;
+      void encodePoints( const QVector<QPoint> &points, QVector<quint32> &commands );
+      bool encodeLine( const QPolygonF &line, QVector<quint32> &commands );
+      bool encodeRing( const QPolygonF &ring, bool exterior, QVector<quint32> &commands );
+
+      QgsRectangle mExtent;
+      QgsRectangle mClipExtent;
+      int mResolution = 4096;
+      double mScaleX = 1.0;
+      double mScaleY = 1.0;
+      std::unique_ptr<QgsMapToPixelSimplifier> mSimplifier;
+
+      QByteArray mTile;
+      Layer mLayer;
+      QPoint mCursor;
+  };
+
+} // namespace QgsWms
+
+#endif
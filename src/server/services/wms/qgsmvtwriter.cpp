@@ -0,0 +1,40 @@
+/***************************************************************************
+                              qgsmvtwriter.cpp
+                              ----------------
+  begin                : December 2017
+  copyright            : (C) 2017 by the QGIS project
+  email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgsmodule.h"
+#include "qgsmvtwriter.h"
+#include "qgswmsutils.h"
+#include "qgswmsrenderer.h"
+
+namespace QgsWms
+{
+
+  void writeAsMvt( QgsServerInterface *serverIface, const QgsProject *project,
+                   const QString &version, const QgsServerRequest &request,
+                   QgsServerResponse &response )
+  {
+    Q_UNUSED( version );
+
+    QgsServerRequest::Parameters params = request.parameters();
+    QgsRenderer renderer( serverIface, project, params );
+
+    const QByteArray tile = renderer.getMvt();
+
+    response.setHeader( QStringLiteral( "Content-Type" ), QStringLiteral( "application/vnd.mapbox-vector-tile" ) );
+    response.write( tile );
+  }
+
+} // namespace QgsWms
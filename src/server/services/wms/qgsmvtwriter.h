@@ -0,0 +1,32 @@
+/***************************************************************************
+                              qgsmvtwriter.h
+                              --------------
+  begin                : December 2017
+  copyright            : (C) 2017 by the QGIS project
+  email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSWMSMVTWRITER_H
+#define QGSWMSMVTWRITER_H
+
+namespace QgsWms
+{
+
+  /**
+   * Output GetMap response as a Mapbox Vector Tile
+   */
+  void writeAsMvt( QgsServerInterface *serverIface, const QgsProject *project,
+                   const QString &version, const QgsServerRequest &request,
+                   QgsServerResponse &response );
+
+} // namespace QgsWms
+
+#endif
@@ -22,6 +22,7 @@
 #include "qgsmodule.h"
 #include "qgswmsutils.h"
 #include "qgsdxfwriter.h"
+#include "qgsmvtwriter.h"
 #include "qgswmsgetcapabilities.h"
 #include "qgswmsgetmap.h"
 #include "qgswmsgetstyles.h"
@@ -98,6 +99,10 @@ namespace QgsWms
           {
             writeAsDxf( mServerIface, project, versionString, request, response );
           }
+          else if QSTR_COMPARE( format, "application/vnd.mapbox-vector-tile" )
+          {
+            writeAsMvt( mServerIface, project, versionString, request, response );
+          }
           else
           {
             writeGetMap( mServerIface, project, versionString, request, response );
@@ -133,6 +138,13 @@ namespace QgsWms
         }
         else if ( QSTR_COMPARE( req, "GetPrint" ) )
         {
+          if ( mServerIface->serverSettings() && mServerIface->serverSettings()->getPrintDisabled() )
+          {
+            // GetPrint is disabled and layouts are not loaded
+            throw QgsServiceException( QStringLiteral( "OperationNotSupported" ),
+                                       QStringLiteral( "Request GetPrint is disabled" ) );
+          }
+
           writeGetPrint( mServerIface, project, versionString, request, response );
         }
         else
@@ -200,13 +200,16 @@ namespace QgsWms
     wmsCapabilitiesElement.appendChild( getServiceElement( doc, project, version, request ) );
 
     //wms:Capability element
-    QDomElement capabilityElement = getCapabilityElement( doc, project, version, request, projectSettings );
+    // layouts are not loaded when GetPrint is disabled
+    const bool getPrintEnabled = !serverIface->serverSettings() || !serverIface->serverSettings()->getPrintDisabled();
+    QDomElement capabilityElement = getCapabilityElement( doc, project, version, request, projectSettings, getPrintEnabled );
     wmsCapabilitiesElement.appendChild( capabilityElement );
 
     if ( projectSettings )
     {
       //Insert <ComposerTemplate> elements derived from wms:_ExtendedCapabilities
-      capabilityElement.appendChild( getComposerTemplatesElement( doc, project ) );
+      if ( getPrintEnabled )
+        capabilityElement.appendChild( getComposerTemplatesElement( doc, project ) );
 
       //WFS layers
       capabilityElement.appendChild( getWFSLayersElement( doc, project ) );
@@ -380,7 +383,7 @@ namespace QgsWms
 
   QDomElement getCapabilityElement( QDomDocument &doc, const QgsProject *project,
                                     const QString &version, const QgsServerRequest &request,
-                                    bool projectSettings )
+                                    bool projectSettings, bool getPrintEnabled )
   {
     QgsServerRequest::Parameters parameters = request.parameters();
 
@@ -448,6 +451,7 @@ namespace QgsWms
     appendFormat( elem, QStringLiteral( "image/png; mode=8bit" ) );
     appendFormat( elem, QStringLiteral( "image/png; mode=1bit" ) );
     appendFormat( elem, QStringLiteral( "application/dxf" ) );
+    appendFormat( elem, QStringLiteral( "application/vnd.mapbox-vector-tile" ) );
     elem.appendChild( dcpTypeElem.cloneNode().toElement() ); //this is the same as for 'GetCapabilities'
     requestElem.appendChild( elem );
 
@@ -480,7 +484,7 @@ namespace QgsWms
     elem.appendChild( dcpTypeElem.cloneNode().toElement() ); //this is the same as for 'GetCapabilities'
     requestElem.appendChild( elem );
 
-    if ( projectSettings ) //remove composer templates from GetCapabilities in the long term
+    if ( projectSettings && getPrintEnabled ) //remove composer templates from GetCapabilities in the long term
     {
       //wms:GetPrint
       elem = doc.createElement( QStringLiteral( "GetPrint" ) /*wms:GetPrint*/ );
@@ -53,10 +53,11 @@ namespace QgsWms
   QDomElement getInspireCapabilitiesElement( QDomDocument &doc, const QgsProject *project );
 
   /**
-   * Create Capability element for get capabilities document
+   * Create Capability element for get capabilities document. The GetPrint request is only
+   * advertised in project settings when \a getPrintEnabled is true.
    */
   QDomElement getCapabilityElement( QDomDocument &doc, const QgsProject *project, const QString &version,
-                                    const QgsServerRequest &request, bool projectSettings );
+                                    const QgsServerRequest &request, bool projectSettings, bool getPrintEnabled = true );
 
   /**
    * Create Service element for get capabilities document
@@ -56,6 +56,7 @@
 #include "qgsmaprendererjobproxy.h"
 #include "qgswmsserviceexception.h"
 #include "qgsserverprojectutils.h"
+#include "qgsservermetrics.h"
 #include "qgsgui.h"
 #include "qgsmaplayerstylemanager.h"
 #include "qgswkbtypes.h"
@@ -66,6 +67,7 @@
 #include "qgspallabeling.h"
 #include "qgslayerrestorer.h"
 #include "qgsdxfexport.h"
+#include "qgsmvtencoder.h"
 #include "qgssymbollayerutils.h"
 #include "qgslayoutitemlegend.h"
 
@@ -421,6 +423,12 @@ namespace QgsWms
       exportSettings.imageSize = QSize( ( int )( width.length() * dpi / 25.4 ), ( int )( height.length() * dpi / 25.4 ) );
       // Export first page only (unless it's a pdf, see below)
       exportSettings.pages.append( 0 );
+      if ( mSettings.parallelRendering() )
+      {
+        // render map items concurrently, within the server threads limit
+        QgsApplication::setMaxThreads( mSettings.maxThreads() );
+        exportSettings.flags |= QgsLayoutRenderContext::FlagRenderMapsInParallel;
+      }
       QgsLayoutExporter exporter( layout.get() );
       exporter.exportToImage( tempOutputFile.fileName(), exportSettings );
     }
@@ -648,6 +656,8 @@ namespace QgsWms
                                     QStringLiteral( "The requested map size is too large" ) );
     }
 
+    QgsServerStageTimer setupTimer( QgsServerMetrics::LayersSetup );
+
     // get layers parameters
     QList<QgsMapLayer *> layers;
     QList<QgsWmsParametersLayer> params = mWmsParameters.layersParameters();
@@ -709,6 +719,9 @@ namespace QgsWms
     // add layers to map settings (revert order for the rendering)
     std::reverse( layers.begin(), layers.end() );
     mapSettings.setLayers( layers );
+    setupTimer.stop();
+
+    QgsServerStageTimer renderTimer( QgsServerMetrics::Rendering );
 
     // rendering step for layers
     painter.reset( layersRendering( mapSettings, *image, hitTest ) );
@@ -719,6 +732,9 @@ namespace QgsWms
     // painting is terminated
     painter->end();
 
+    renderTimer.stop();
+    QgsServerMetrics::instance()->addCount( QgsServerMetrics::RenderedPixels, static_cast< qint64 >( image->width() ) * image->height() );
+
     // scale output image if necessary (required by WMS spec)
     QImage *scaledImage = scaleImage( image.get() );
     if ( scaledImage )
@@ -844,6 +860,174 @@ namespace QgsWms
     return dxf;
   }
 
+  QByteArray QgsRenderer::getMvt()
+  {
+    // check size
+    if ( !checkMaximumWidthHeight() )
+    {
+      throw QgsBadRequestException( QStringLiteral( "Size error" ),
+                                    QStringLiteral( "The requested map size is too large" ) );
+    }
+
+    QgsServerStageTimer setupTimer( QgsServerMetrics::LayersSetup );
+
+    // get layers parameters
+    QList<QgsMapLayer *> layers;
+    QList<QgsWmsParametersLayer> params = mWmsParameters.layersParameters();
+
+    // init layer restorer before doing anything
+    std::unique_ptr<QgsLayerRestorer> restorer;
+    restorer.reset( new QgsLayerRestorer( mNicknameLayers.values() ) );
+
+    // init stylized layers according to LAYERS/STYLES or SLD
+    QString sld = mWmsParameters.sld();
+    if ( !sld.isEmpty() )
+    {
+      layers = sldStylizedLayers( sld );
+    }
+    else
+    {
+      layers = stylizedLayers( params );
+    }
+
+    // the image is not rendered, it only defines the output size and dpi
+    std::unique_ptr<QImage> image( createImage() );
+    QgsMapSettings mapSettings;
+    configureMapSettings( image.get(), mapSettings );
+    image.reset();
+
+    // remove unwanted layers (restricted layers, out of scale, ...)
+    removeUnwantedLayers( layers, mapSettings.scale() );
+
+    Q_FOREACH ( QgsMapLayer *layer, layers )
+    {
+      Q_FOREACH ( QgsWmsParametersLayer param, params )
+      {
+        if ( param.mNickname == layerNickname( *layer ) )
+        {
+          checkLayerReadPermissions( layer );
+
+          setLayerFilter( layer, param.mFilter );
+
+          setLayerAccessControlFilter( layer );
+
+          break;
+        }
+      }
+    }
+    mapSettings.setLayers( layers );
+    setupTimer.stop();
+
+    QgsServerStageTimer renderTimer( QgsServerMetrics::Rendering );
+
+    // one output pixel is the smallest detail a client displays
+    const QgsRectangle tileExtent = mapSettings.visibleExtent();
+    QgsMvtEncoder encoder( tileExtent );
+    encoder.setSimplifyTolerance( mapSettings.mapUnitsPerPixel() );
+
+    QgsRenderContext renderContext = QgsRenderContext::fromMapSettings( mapSettings );
+
+    Q_FOREACH ( QgsMapLayer *layer, layers )
+    {
+      QgsVectorLayer *vlayer = qobject_cast<QgsVectorLayer *>( layer );
+      if ( !vlayer || !vlayer->isSpatial() )
+        continue;
+
+      const QgsCoordinateTransform transform = mapSettings.layerTransform( vlayer );
+      QgsRectangle layerExtent = tileExtent;
+      if ( transform.isValid() )
+      {
+        try
+        {
+          layerExtent = transform.transformBoundingBox( tileExtent, QgsCoordinateTransform::ReverseTransform );
+        }
+        catch ( QgsCsException &e )
+        {
+          Q_UNUSED( e );
+          continue;
+        }
+      }
+
+      renderContext.expressionContext() << QgsExpressionContextUtils::layerScope( vlayer );
+
+      // published attributes
+      const QgsFields fields = vlayer->fields();
+      const QSet<QString> &excludedAttributes = vlayer->excludeAttributesWms();
+      QStringList attributeNames;
+      for ( const QgsField &field : fields )
+      {
+        if ( !excludedAttributes.contains( field.name() ) )
+          attributeNames << field.name();
+      }
+
+      QgsFeatureRequest fReq;
+      fReq.setFilterRect( layerExtent );
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+      mAccessControl->filterFeatures( vlayer, fReq );
+      attributeNames = mAccessControl->layerAttributes( vlayer, attributeNames );
+#endif
+
+      // the renderer discards the features which are not drawn at this scale
+      std::unique_ptr< QgsFeatureRenderer > renderer( vlayer->renderer() ? vlayer->renderer()->clone() : nullptr );
+      QSet<QString> requiredAttributes = attributeNames.toSet();
+      if ( renderer )
+      {
+        renderer->startRender( renderContext, fields );
+        requiredAttributes.unite( renderer->usedAttributes( renderContext ) );
+
+        const QString rendererFilter = renderer->filter( fields );
+        if ( !rendererFilter.isEmpty() && rendererFilter != QLatin1String( "TRUE" ) )
+        {
+          fReq.combineFilterExpression( rendererFilter );
+          fReq.setExpressionContext( renderContext.expressionContext() );
+        }
+      }
+      fReq.setSubsetOfAttributes( requiredAttributes, fields );
+
+      QgsAttributeList attributes;
+      for ( const QString &name : qgis::as_const( attributeNames ) )
+        attributes << fields.lookupField( name );
+
+      encoder.startLayer( layerNickname( *vlayer ) );
+
+      QgsFeature feature;
+      QgsFeatureIterator fit = vlayer->getFeatures( fReq );
+      while ( fit.nextFeature( feature ) )
+      {
+        renderContext.expressionContext().setFeature( feature );
+        if ( renderer && !renderer->willRenderFeature( feature, renderContext ) )
+          continue;
+
+        if ( transform.isValid() && feature.hasGeometry() )
+        {
+          QgsGeometry geom = feature.geometry();
+          try
+          {
+            geom.transform( transform );
+          }
+          catch ( QgsCsException &e )
+          {
+            Q_UNUSED( e );
+            continue;
+          }
+          feature.setGeometry( geom );
+        }
+
+        if ( encoder.addFeature( feature, fields, attributes ) )
+          QgsServerMetrics::instance()->addCount( QgsServerMetrics::FeaturesFetched );
+      }
+
+      encoder.endLayer();
+
+      if ( renderer )
+        renderer->stopRender( renderContext );
+
+      delete renderContext.expressionContext().popScope();
+    }
+
+    return encoder.encode();
+  }
+
   static void infoPointToMapCoordinates( int i, int j, QgsPointXY *infoPoint, const QgsMapSettings &mapSettings )
   {
     //check if i, j are in the pixel range of the image
@@ -1378,6 +1562,25 @@ namespace QgsWms
       searchRect = layerRect;
     }
 
+    const bool hasSearchRect = !searchRect.isEmpty();
+    const bool hasLayerGeometry = layer->wkbType() != QgsWkbTypes::NoGeometry;
+
+    // short-circuit the layer when no feature may be returned, so that
+    // no iterator is opened on the provider
+    if ( hasSearchRect )
+    {
+      if ( !hasLayerGeometry || !layer->renderer() )
+      {
+        return true;
+      }
+
+      const QgsRectangle layerExtent = layer->extent();
+      if ( !layerExtent.isEmpty() && !layerExtent.intersects( searchRect ) )
+      {
+        return true;
+      }
+    }
+
     //do a select with searchRect and go through all the features
 
     QgsFeature feature;
@@ -1393,13 +1596,17 @@ namespace QgsWms
     bool hasGeometry = addWktGeometry || featureBBox || filterGeom;
     fReq.setFlags( ( ( hasGeometry ) ? QgsFeatureRequest::NoFlags : QgsFeatureRequest::NoGeometry ) | QgsFeatureRequest::ExactIntersect );
 
-    if ( ! searchRect.isEmpty() )
+    if ( hasSearchRect )
     {
       fReq.setFilterRect( searchRect );
     }
     else
     {
       fReq.setFlags( fReq.flags() & ~ QgsFeatureRequest::ExactIntersect );
+
+      // no symbology visibility test is needed, so the feature count can be
+      // handled by the provider
+      fReq.setLimit( nFeatures );
     }
 
     if ( filterGeom )
@@ -1420,36 +1627,33 @@ namespace QgsWms
     fReq.setSubsetOfAttributes( attributes, layer->fields() );
 #endif
 
-    QgsFeatureIterator fit = layer->getFeatures( fReq );
     std::unique_ptr< QgsFeatureRenderer > r2( layer->renderer() ? layer->renderer()->clone() : nullptr );
     if ( r2 )
     {
       r2->startRender( renderContext, layer->fields() );
-    }
 
-    bool featureBBoxInitialized = false;
-    while ( fit.nextFeature( feature ) )
-    {
-      if ( layer->wkbType() == QgsWkbTypes::NoGeometry && ! searchRect.isEmpty() )
+      // let the provider discard features which are not rendered, the
+      // visibility test is then only applied to the remaining candidates
+      if ( hasSearchRect )
       {
-        break;
+        const QString rendererFilter = r2->filter( fields );
+        if ( !rendererFilter.isEmpty() && rendererFilter != QLatin1String( "TRUE" ) )
+        {
+          fReq.combineFilterExpression( rendererFilter );
+          fReq.setExpressionContext( renderContext.expressionContext() );
+        }
       }
+    }
 
-      ++featureCounter;
-      if ( featureCounter > nFeatures )
-      {
-        break;
-      }
+    QgsFeatureIterator fit = layer->getFeatures( fReq );
 
+    bool featureBBoxInitialized = false;
+    while ( fit.nextFeature( feature ) )
+    {
       renderContext.expressionContext().setFeature( feature );
 
-      if ( layer->wkbType() != QgsWkbTypes::NoGeometry && ! searchRect.isEmpty() )
+      if ( hasSearchRect )
       {
-        if ( !r2 )
-        {
-          continue;
-        }
-
         //check if feature is rendered at all
         bool render = r2->willRenderFeature( feature, renderContext );
         if ( !render )
@@ -1458,6 +1662,14 @@ namespace QgsWms
         }
       }
 
+      // only count features which are actually returned
+      ++featureCounter;
+      if ( featureCounter > nFeatures )
+      {
+        break;
+      }
+      QgsServerMetrics::instance()->addCount( QgsServerMetrics::FeaturesFetched );
+
       QgsRectangle box;
       if ( layer->wkbType() != QgsWkbTypes::NoGeometry && hasGeometry )
       {
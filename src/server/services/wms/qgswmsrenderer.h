@@ -114,6 +114,14 @@ namespace QgsWms
        \since QGIS 3.0*/
       QgsDxfExport getDxf( const QMap<QString, QString> &options );
 
+      /**
+       * Returns the vector layers of the map encoded as a Mapbox Vector Tile.
+       * Styling is left to the client, only the layers visible at the
+       * requested scale and the features their renderer would draw are encoded.
+       \returns the map as MVT data
+       \since QGIS 3.0*/
+      QByteArray getMvt();
+
       /**
        * Returns printed page as binary
         \param formatString out: format of the print output (e.g. pdf, svg, png, ...)
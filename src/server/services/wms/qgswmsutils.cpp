@@ -24,6 +24,7 @@
 #include "qgsmediancut.h"
 #include "qgsconfigcache.h"
 #include "qgsserverprojectutils.h"
+#include "qgsservermetrics.h"
 
 namespace QgsWms
 {
@@ -105,6 +106,8 @@ namespace QgsWms
   void writeImage( QgsServerResponse &response, QImage &img, const QString &formatStr,
                    int imageQuality )
   {
+    QgsServerStageTimer encodingTimer( QgsServerMetrics::Encoding );
+
     ImageOutputFormat outputFormat = parseImageFormat( formatStr );
     QImage  result;
     QString saveFormat;
@@ -0,0 +1,179 @@
+/***************************************************************************
+                 main.cpp  - Processing benchmark
+                             -------------------
+    begin                : October 2017
+    copyright            : (C) 2017 by QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <QDir>
+#include <QString>
+#include <QStringList>
+
+#include <iostream>
+
+#include "qgsprocessingbench.h"
+#include "qgsapplication.h"
+#include <qgsconfig.h>
+#include <qgsversion.h>
+#include "qgsnativealgorithms.h"
+#include "qgsprocessingregistry.h"
+
+/**
+ * Print usage text
+ */
+void usage( std::string const &appName )
+{
+  std::cerr << "QGIS Processing Benchmark - " << VERSION << " '" << RELEASE_NAME << "' ("
+            << QGSVERSION << ")\n"
+            << "Runs native processing algorithms against generated datasets\n"
+            << "Usage: " << appName << " [options]\n"
+            << "  options:\n"
+            << "\t[--algorithms id,id]\talgorithms to run, comma separated, default all of --list\n"
+            << "\t[--features count]\tnumber of features of the generated layers, default 10000\n"
+            << "\t[--iterations iterations]\tnumber of runs of each algorithm, default 3\n"
+            << "\t[--seed seed]\trandom seed of the generated layers, default 1\n"
+            << "\t[--log filename]\twrite log (JSON) to given file\n"
+            << "\t[--baseline filename]\tcompare the run to a log written by an earlier run\n"
+            << "\t[--compare old new]\tcompare two logs without running anything\n"
+            << "\t[--threshold percent]\tslowdown or allocation increase reported as regression, default 10\n"
+            << "\t[--prefix path]\tpath to a different build of qgis, may be used to test old versions\n"
+            << "\t[--list]\tlist the algorithms which can be benchmarked\n"
+            << "\t[--help]\t\tthis text\n\n"
+            << "  The exit code is 1 if an algorithm failed or a regression was found.\n";
+} // usage()
+
+int main( int argc, char *argv[] )
+{
+  QStringList myAlgorithms = QgsProcessingBench::availableAlgorithms();
+  int myFeatures = 10000;
+  int myIterations = 3;
+  unsigned int mySeed = 1;
+  QString myLogFileName;
+  QString myBaselineFileName;
+  QString myCompareFileName;
+  double myThreshold = 10.0;
+  QString myPrefixPath;
+
+  for ( int i = 1; i < argc; i++ )
+  {
+    QString arg = argv[i];
+
+    if ( i + 1 < argc && arg == QLatin1String( "--algorithms" ) )
+    {
+      myAlgorithms = QString( argv[++i] ).split( ',', QString::SkipEmptyParts );
+    }
+    else if ( i + 1 < argc && arg == QLatin1String( "--features" ) )
+    {
+      myFeatures = QString( argv[++i] ).toInt();
+    }
+    else if ( i + 1 < argc && ( arg == QLatin1String( "--iterations" ) || arg == QLatin1String( "-i" ) ) )
+    {
+      myIterations = QString( argv[++i] ).toInt();
+    }
+    else if ( i + 1 < argc && arg == QLatin1String( "--seed" ) )
+    {
+      mySeed = QString( argv[++i] ).toUInt();
+    }
+    else if ( i + 1 < argc && ( arg == QLatin1String( "--log" ) || arg == QLatin1String( "-l" ) ) )
+    {
+      myLogFileName = QDir::toNativeSeparators( QDir( argv[++i] ).absolutePath() );
+    }
+    else if ( i + 1 < argc && arg == QLatin1String( "--baseline" ) )
+    {
+      myBaselineFileName = QDir::toNativeSeparators( QDir( argv[++i] ).absolutePath() );
+    }
+    else if ( i + 2 < argc && arg == QLatin1String( "--compare" ) )
+    {
+      myBaselineFileName = QDir::toNativeSeparators( QDir( argv[++i] ).absolutePath() );
+      myCompareFileName = QDir::toNativeSeparators( QDir( argv[++i] ).absolutePath() );
+    }
+    else if ( i + 1 < argc && arg == QLatin1String( "--threshold" ) )
+    {
+      myThreshold = QString( argv[++i] ).toDouble();
+    }
+    else if ( i + 1 < argc && arg == QLatin1String( "--prefix" ) )
+    {
+      myPrefixPath = argv[++i];
+    }
+    else if ( arg == QLatin1String( "--list" ) )
+    {
+      for ( const QString &algorithm : QgsProcessingBench::availableAlgorithms() )
+        std::cout << algorithm.toLocal8Bit().constData() << std::endl;
+      return 0;
+    }
+    else
+    {
+      usage( argv[0] );
+      return 2;
+    }
+  }
+
+  // comparing two logs does not need any QGIS library to be initialized
+  if ( !myCompareFileName.isEmpty() )
+  {
+    bool baselineOk = false;
+    bool currentOk = false;
+    const QVariantMap baseline = QgsProcessingBench::loadLog( myBaselineFileName, &baselineOk );
+    const QVariantMap current = QgsProcessingBench::loadLog( myCompareFileName, &currentOk );
+    if ( !baselineOk || !currentOk )
+    {
+      std::cerr << "Cannot read log " << ( baselineOk ? myCompareFileName : myBaselineFileName ).toLocal8Bit().constData() << std::endl;
+      return 2;
+    }
+    return QgsProcessingBench::compare( baseline, current, myThreshold ) ? 0 : 1;
+  }
+
+  QgsApplication *myApp = new QgsApplication( argc, argv, false );
+
+  if ( myPrefixPath.isEmpty() )
+  {
+    QDir dir( QCoreApplication::applicationDirPath() );
+    dir.cdUp();
+    myPrefixPath = dir.absolutePath();
+  }
+  QgsApplication::setPrefixPath( myPrefixPath, true );
+
+  QgsApplication::initQgis();
+  QgsApplication::processingRegistry()->addProvider( new QgsNativeAlgorithms( QgsApplication::processingRegistry() ) );
+
+  bool ok = true;
+  {
+    QgsProcessingBench bench( myFeatures, myIterations, mySeed );
+    ok = bench.run( myAlgorithms );
+    bench.printLog();
+
+    if ( !myLogFileName.isEmpty() && !bench.saveLog( myLogFileName ) )
+    {
+      std::cerr << "Cannot write log " << myLogFileName.toLocal8Bit().constData() << std::endl;
+      ok = false;
+    }
+
+    if ( ok && !myBaselineFileName.isEmpty() )
+    {
+      bool baselineOk = false;
+      const QVariantMap baseline = QgsProcessingBench::loadLog( myBaselineFileName, &baselineOk );
+      if ( !baselineOk )
+      {
+        std::cerr << "Cannot read log " << myBaselineFileName.toLocal8Bit().constData() << std::endl;
+        ok = false;
+      }
+      else
+      {
+        ok = QgsProcessingBench::compare( baseline, bench.log(), myThreshold );
+      }
+    }
+  }
+
+  QgsApplication::exitQgis();
+  delete myApp;
+
+  return ok ? 0 : 1;
+}
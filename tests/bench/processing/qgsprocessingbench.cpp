@@ -0,0 +1,464 @@
+/***************************************************************************
+                 qgsprocessingbench.cpp  - Processing benchmark
+                             -------------------
+    begin                : October 2017
+    copyright            : (C) 2017 by QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <QtGlobal>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#ifndef Q_OS_WIN
+#include <sys/resource.h>
+#endif
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QThread>
+
+#ifndef QGSVERSION
+#include "qgsversion.h"
+#endif
+#include "qgsprocessingbench.h"
+#include "qgsapplication.h"
+#include "qgsgeometry.h"
+#include "qgsprocessingalgorithm.h"
+#include "qgsprocessingcontext.h"
+#include "qgsprocessingfeedback.h"
+#include "qgsprocessingregistry.h"
+#include "qgsprocessingutils.h"
+#include "qgsproject.h"
+#include "qgsvectordataprovider.h"
+#include "qgsvectorlayer.h"
+
+//! Distance between the centers of the generated polygons
+static const double CELL_SIZE = 10.0;
+
+//! Radius of the generated polygons, which overlap their neighbors
+static const double CIRCLE_RADIUS = 6.0;
+
+//! Number of vertices of the generated polygons
+static const int CIRCLE_VERTICES = 32;
+
+//! Number of distinct values of the category field
+static const int CATEGORY_COUNT = 10;
+
+// Every allocation made through operator new in the process is counted, including the
+// ones made by the QGIS libraries. Allocations made with malloc() are not counted.
+static std::atomic< quint64 > sAllocationCount( 0 );
+
+void *operator new( std::size_t size )
+{
+  sAllocationCount.fetch_add( 1, std::memory_order_relaxed );
+  if ( void *ptr = std::malloc( size ? size : 1 ) )
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete( void *ptr ) noexcept
+{
+  std::free( ptr );
+}
+
+static void cpuTimes( double &user, double &sys )
+{
+#ifndef Q_OS_WIN
+  struct rusage usage;
+  getrusage( RUSAGE_SELF, &usage );
+  user = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.;
+  sys = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1000000.;
+#else
+  user = 0.;
+  sys = 0.;
+#endif
+}
+
+static void resetPeakMemory()
+{
+#ifdef Q_OS_LINUX
+  // resets the peak resident set size reported as VmHWM, since Linux 4.0
+  QFile clearRefs( QStringLiteral( "/proc/self/clear_refs" ) );
+  if ( clearRefs.open( QIODevice::WriteOnly ) )
+    clearRefs.write( "5" );
+#endif
+}
+
+//! Returns the peak resident set size of the process in kB, or -1 if it is not known
+static qint64 peakMemory()
+{
+#ifdef Q_OS_LINUX
+  QFile status( QStringLiteral( "/proc/self/status" ) );
+  if ( status.open( QIODevice::ReadOnly | QIODevice::Text ) )
+  {
+    const QStringList lines = QString( status.readAll() ).split( '\n' );
+    for ( const QString &line : lines )
+    {
+      if ( line.startsWith( QLatin1String( "VmHWM:" ) ) )
+        return line.mid( 6 ).trimmed().split( ' ' ).value( 0 ).toLongLong();
+    }
+  }
+#endif
+#ifndef Q_OS_WIN
+  struct rusage usage;
+  if ( getrusage( RUSAGE_SELF, &usage ) == 0 )
+  {
+#ifdef Q_OS_MAC
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+  }
+#endif
+  return -1;
+}
+
+QgsProcessingBench::QgsProcessingBench( int featureCount, int iterations, unsigned int seed )
+  : mFeatureCount( std::max( 1, featureCount ) )
+  , mIterations( std::max( 1, iterations ) )
+  , mSeed( seed )
+{
+  createLayers();
+}
+
+QgsProcessingBench::~QgsProcessingBench() = default;
+
+QStringList QgsProcessingBench::availableAlgorithms()
+{
+  return QStringList() << QStringLiteral( "native:buffer" )
+         << QStringLiteral( "native:centroids" )
+         << QStringLiteral( "native:clip" )
+         << QStringLiteral( "native:dissolve" )
+         << QStringLiteral( "native:extractbylocation" )
+         << QStringLiteral( "native:joinattributestable" );
+}
+
+void QgsProcessingBench::createLayers()
+{
+  std::mt19937 generator( mSeed );
+  std::uniform_real_distribution< double > jitter( -2.0, 2.0 );
+
+  const int side = std::max( 1, static_cast< int >( std::ceil( std::sqrt( static_cast< double >( mFeatureCount ) ) ) ) );
+  const double extent = side * CELL_SIZE;
+  std::uniform_real_distribution< double > position( 0.0, extent );
+
+  // overlapping circles on a grid, split in a few categories
+  mPolygons.reset( new QgsVectorLayer( QStringLiteral( "Polygon?crs=EPSG:3857&field=id:integer&field=category:integer&field=name:string(20)" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < mFeatureCount; ++i )
+  {
+    const double x = ( i % side + 0.5 ) * CELL_SIZE + jitter( generator );
+    const double y = ( i / side + 0.5 ) * CELL_SIZE + jitter( generator );
+    QgsPolylineXY ring;
+    for ( int v = 0; v <= CIRCLE_VERTICES; ++v )
+    {
+      const double angle = 2 * M_PI * ( v % CIRCLE_VERTICES ) / CIRCLE_VERTICES;
+      ring << QgsPointXY( x + CIRCLE_RADIUS * std::cos( angle ), y + CIRCLE_RADIUS * std::sin( angle ) );
+    }
+
+    QgsFeature f( mPolygons->fields() );
+    f.setAttributes( QgsAttributes() << i << i % CATEGORY_COUNT << QStringLiteral( "polygon %1" ).arg( i ) );
+    f.setGeometry( QgsGeometry::fromPolygonXY( QgsPolygonXY() << ring ) );
+    features << f;
+  }
+  mPolygons->dataProvider()->addFeatures( features );
+
+  // points spread over the same extent
+  mPoints.reset( new QgsVectorLayer( QStringLiteral( "Point?crs=EPSG:3857&field=id:integer" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) ) );
+  features.clear();
+  for ( int i = 0; i < mFeatureCount; ++i )
+  {
+    QgsFeature f( mPoints->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( position( generator ), position( generator ) ) ) );
+    features << f;
+  }
+  mPoints->dataProvider()->addFeatures( features );
+
+  // a few larger rectangles to clip and select with
+  mOverlay.reset( new QgsVectorLayer( QStringLiteral( "Polygon?crs=EPSG:3857&field=id:integer" ), QStringLiteral( "overlay" ), QStringLiteral( "memory" ) ) );
+  std::uniform_real_distribution< double > size( CELL_SIZE, 5 * CELL_SIZE );
+  features.clear();
+  for ( int i = 0; i < std::max( 1, mFeatureCount / 100 ); ++i )
+  {
+    const double x = position( generator );
+    const double y = position( generator );
+    QgsFeature f( mOverlay->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + size( generator ), y + size( generator ) ) ) );
+    features << f;
+  }
+  mOverlay->dataProvider()->addFeatures( features );
+
+  // attributes to join on the category field
+  mTable.reset( new QgsVectorLayer( QStringLiteral( "None?field=category:integer&field=label:string(20)" ), QStringLiteral( "table" ), QStringLiteral( "memory" ) ) );
+  features.clear();
+  for ( int i = 0; i < CATEGORY_COUNT; ++i )
+  {
+    QgsFeature f( mTable->fields() );
+    f.setAttributes( QgsAttributes() << i << QStringLiteral( "category %1" ).arg( i ) );
+    features << f;
+  }
+  mTable->dataProvider()->addFeatures( features );
+}
+
+QgsVectorLayer *QgsProcessingBench::inputLayer( const QString &algorithm ) const
+{
+  if ( algorithm == QLatin1String( "native:extractbylocation" ) )
+    return mPoints.get();
+  else
+    return mPolygons.get();
+}
+
+QVariantMap QgsProcessingBench::parameters( const QString &algorithm ) const
+{
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( inputLayer( algorithm ) ) );
+  if ( algorithm == QLatin1String( "native:buffer" ) )
+  {
+    parameters.insert( QStringLiteral( "DISTANCE" ), 1.0 );
+    parameters.insert( QStringLiteral( "SEGMENTS" ), 8 );
+    parameters.insert( QStringLiteral( "END_CAP_STYLE" ), 0 );
+    parameters.insert( QStringLiteral( "JOIN_STYLE" ), 0 );
+    parameters.insert( QStringLiteral( "MITER_LIMIT" ), 2.0 );
+    parameters.insert( QStringLiteral( "DISSOLVE" ), false );
+  }
+  else if ( algorithm == QLatin1String( "native:clip" ) )
+  {
+    parameters.insert( QStringLiteral( "OVERLAY" ), QVariant::fromValue( mOverlay.get() ) );
+  }
+  else if ( algorithm == QLatin1String( "native:dissolve" ) )
+  {
+    parameters.insert( QStringLiteral( "FIELD" ), QStringLiteral( "category" ) );
+  }
+  else if ( algorithm == QLatin1String( "native:extractbylocation" ) )
+  {
+    parameters.insert( QStringLiteral( "PREDICATE" ), QVariantList() << 0 );
+    parameters.insert( QStringLiteral( "INTERSECT" ), QVariant::fromValue( mOverlay.get() ) );
+  }
+  else if ( algorithm == QLatin1String( "native:joinattributestable" ) )
+  {
+    parameters.insert( QStringLiteral( "FIELD" ), QStringLiteral( "category" ) );
+    parameters.insert( QStringLiteral( "INPUT_2" ), QVariant::fromValue( mTable.get() ) );
+    parameters.insert( QStringLiteral( "FIELD_2" ), QStringLiteral( "category" ) );
+  }
+  parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+  return parameters;
+}
+
+bool QgsProcessingBench::run( const QStringList &algorithms )
+{
+  mLogMap.clear();
+  mLogMap.insert( QStringLiteral( "revision" ), QGSVERSION );
+  mLogMap.insert( QStringLiteral( "features" ), mFeatureCount );
+  mLogMap.insert( QStringLiteral( "iterations" ), mIterations );
+  mLogMap.insert( QStringLiteral( "seed" ), mSeed );
+  mLogMap.insert( QStringLiteral( "threads" ), QThread::idealThreadCount() );
+
+  bool ok = true;
+  QVariantMap algorithmsMap;
+  for ( const QString &algorithm : algorithms )
+  {
+    bool algorithmOk = false;
+    const QVariantMap map = runAlgorithm( algorithm, algorithmOk );
+    if ( !algorithmOk )
+    {
+      ok = false;
+      continue;
+    }
+    algorithmsMap.insert( algorithm, map );
+  }
+  mLogMap.insert( QStringLiteral( "algorithms" ), algorithmsMap );
+  return ok;
+}
+
+QVariantMap QgsProcessingBench::runAlgorithm( const QString &algorithm, bool &ok )
+{
+  ok = false;
+  const QgsProcessingAlgorithm *alg = QgsApplication::processingRegistry()->algorithmById( algorithm );
+  if ( !alg || !availableAlgorithms().contains( algorithm ) )
+  {
+    std::cerr << "Cannot benchmark algorithm " << algorithm.toLocal8Bit().constData() << std::endl;
+    return QVariantMap();
+  }
+
+  QVector< double > wallTimes;
+  double user = 0.;
+  double sys = 0.;
+  double allocations = 0.;
+  qint64 peak = -1;
+  long outputFeatures = 0;
+  for ( int i = 0; i < mIterations; ++i )
+  {
+    // the output is kept in the context, and only released once the time is measured
+    QgsProcessingContext context;
+    context.setProject( QgsProject::instance() );
+    QgsProcessingFeedback feedback;
+    const QVariantMap params = parameters( algorithm );
+
+    resetPeakMemory();
+    double userStart, sysStart, userEnd, sysEnd;
+    cpuTimes( userStart, sysStart );
+    const quint64 allocationsStart = sAllocationCount.load();
+    QElapsedTimer timer;
+    timer.start();
+
+    bool runOk = false;
+    const QVariantMap results = alg->run( params, context, &feedback, &runOk );
+
+    wallTimes << timer.nsecsElapsed() / 1000000000.;
+    allocations += sAllocationCount.load() - allocationsStart;
+    cpuTimes( userEnd, sysEnd );
+    user += userEnd - userStart;
+    sys += sysEnd - sysStart;
+    peak = std::max( peak, peakMemory() );
+
+    if ( !runOk )
+    {
+      std::cerr << "Error running " << algorithm.toLocal8Bit().constData() << std::endl;
+      return QVariantMap();
+    }
+
+    QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( QgsProcessingUtils::mapLayerFromString( results.value( QStringLiteral( "OUTPUT" ) ).toString(), context ) );
+    outputFeatures = output ? output->featureCount() : 0;
+  }
+
+  double min = wallTimes.at( 0 );
+  double max = wallTimes.at( 0 );
+  double avg = 0.;
+  for ( double wall : qgis::as_const( wallTimes ) )
+  {
+    min = std::min( min, wall );
+    max = std::max( max, wall );
+    avg += wall;
+  }
+  avg /= wallTimes.size();
+  double stdev = 0.;
+  for ( double wall : qgis::as_const( wallTimes ) )
+    stdev += std::pow( wall - avg, 2 );
+  stdev = std::sqrt( stdev / wallTimes.size() );
+
+  QVariantMap wallMap;
+  wallMap.insert( QStringLiteral( "min" ), min );
+  wallMap.insert( QStringLiteral( "max" ), max );
+  wallMap.insert( QStringLiteral( "avg" ), avg );
+  wallMap.insert( QStringLiteral( "stdev" ), stdev );
+
+  const long inputFeatures = inputLayer( algorithm )->featureCount();
+  QVariantMap map;
+  map.insert( QStringLiteral( "wall" ), wallMap );
+  map.insert( QStringLiteral( "user" ), user / mIterations );
+  map.insert( QStringLiteral( "sys" ), sys / mIterations );
+  map.insert( QStringLiteral( "input_features" ), static_cast< double >( inputFeatures ) );
+  map.insert( QStringLiteral( "output_features" ), static_cast< double >( outputFeatures ) );
+  map.insert( QStringLiteral( "features_per_second" ), avg > 0 ? inputFeatures / avg : 0. );
+  map.insert( QStringLiteral( "peak_rss_kb" ), static_cast< double >( peak ) );
+  map.insert( QStringLiteral( "allocations" ), allocations / mIterations );
+
+  ok = true;
+  return map;
+}
+
+void QgsProcessingBench::printLog() const
+{
+  std::cout << "features: " << mFeatureCount << ", iterations: " << mIterations << std::endl;
+
+  const QVariantMap algorithmsMap = mLogMap.value( QStringLiteral( "algorithms" ) ).toMap();
+  for ( auto it = algorithmsMap.constBegin(); it != algorithmsMap.constEnd(); ++it )
+  {
+    const QVariantMap map = it.value().toMap();
+    const QString line = QStringLiteral( "%1: wall %2 s, %3 features/s, peak %4 kB, %5 allocations" )
+                         .arg( it.key() )
+                         .arg( map.value( QStringLiteral( "wall" ) ).toMap().value( QStringLiteral( "avg" ) ).toDouble(), 0, 'f', 3 )
+                         .arg( map.value( QStringLiteral( "features_per_second" ) ).toDouble(), 0, 'f', 0 )
+                         .arg( map.value( QStringLiteral( "peak_rss_kb" ) ).toDouble(), 0, 'f', 0 )
+                         .arg( map.value( QStringLiteral( "allocations" ) ).toDouble(), 0, 'f', 0 );
+    std::cout << line.toLocal8Bit().constData() << std::endl;
+  }
+}
+
+bool QgsProcessingBench::saveLog( const QString &fileName ) const
+{
+  QFile file( fileName );
+  if ( !file.open( QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate ) )
+    return false;
+
+  file.write( QJsonDocument::fromVariant( mLogMap ).toJson() );
+  return true;
+}
+
+QVariantMap QgsProcessingBench::loadLog( const QString &fileName, bool *ok )
+{
+  if ( ok )
+    *ok = false;
+
+  QFile file( fileName );
+  if ( !file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    return QVariantMap();
+
+  const QJsonDocument document = QJsonDocument::fromJson( file.readAll() );
+  if ( !document.isObject() )
+    return QVariantMap();
+
+  if ( ok )
+    *ok = true;
+  return document.toVariant().toMap();
+}
+
+bool QgsProcessingBench::compare( const QVariantMap &baseline, const QVariantMap &current, double threshold )
+{
+  if ( baseline.value( QStringLiteral( "features" ) ).toInt() != current.value( QStringLiteral( "features" ) ).toInt() )
+    std::cout << "warning: the runs used datasets of different sizes" << std::endl;
+
+  auto change = []( double before, double after )
+  {
+    return before > 0 ? 100.0 * ( after - before ) / before : 0.;
+  };
+
+  bool ok = true;
+  const QVariantMap baselineAlgorithms = baseline.value( QStringLiteral( "algorithms" ) ).toMap();
+  const QVariantMap currentAlgorithms = current.value( QStringLiteral( "algorithms" ) ).toMap();
+  for ( auto it = currentAlgorithms.constBegin(); it != currentAlgorithms.constEnd(); ++it )
+  {
+    if ( !baselineAlgorithms.contains( it.key() ) )
+      continue;
+
+    const QVariantMap before = baselineAlgorithms.value( it.key() ).toMap();
+    const QVariantMap after = it.value().toMap();
+    const double wallBefore = before.value( QStringLiteral( "wall" ) ).toMap().value( QStringLiteral( "avg" ) ).toDouble();
+    const double wallAfter = after.value( QStringLiteral( "wall" ) ).toMap().value( QStringLiteral( "avg" ) ).toDouble();
+    const double allocationsBefore = before.value( QStringLiteral( "allocations" ) ).toDouble();
+    const double allocationsAfter = after.value( QStringLiteral( "allocations" ) ).toDouble();
+    const double peakBefore = before.value( QStringLiteral( "peak_rss_kb" ) ).toDouble();
+    const double peakAfter = after.value( QStringLiteral( "peak_rss_kb" ) ).toDouble();
+
+    const double wallChange = change( wallBefore, wallAfter );
+    const double allocationsChange = change( allocationsBefore, allocationsAfter );
+    const bool regression = wallChange > threshold || allocationsChange > threshold;
+    if ( regression )
+      ok = false;
+
+    const QString line = QStringLiteral( "%1: wall %2 -> %3 s (%4 %), allocations %5 -> %6 (%7 %), peak %8 -> %9 kB%10" )
+                         .arg( it.key() )
+                         .arg( wallBefore, 0, 'f', 3 ).arg( wallAfter, 0, 'f', 3 ).arg( wallChange, 0, 'f', 1 )
+                         .arg( allocationsBefore, 0, 'f', 0 ).arg( allocationsAfter, 0, 'f', 0 ).arg( allocationsChange, 0, 'f', 1 )
+                         .arg( peakBefore, 0, 'f', 0 ).arg( peakAfter, 0, 'f', 0 )
+                         .arg( regression ? QStringLiteral( "  REGRESSION" ) : QString() );
+    std::cout << line.toLocal8Bit().constData() << std::endl;
+  }
+  return ok;
+}
@@ -0,0 +1,89 @@
+/***************************************************************************
+                 qgsprocessingbench.h  - Processing benchmark
+                             -------------------
+    begin                : October 2017
+    copyright            : (C) 2017 by QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSPROCESSINGBENCH_H
+#define QGSPROCESSINGBENCH_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+#include <memory>
+
+class QgsVectorLayer;
+
+/**
+ * Runs native processing algorithms against generated datasets, and measures
+ * their wall time, throughput, peak memory and number of allocations.
+ */
+class QgsProcessingBench
+{
+  public:
+
+    /**
+     * Constructor for QgsProcessingBench. Generated input layers have about \a featureCount
+     * features, created from the random \a seed so that runs are repeatable. Each algorithm
+     * is run \a iterations times.
+     */
+    QgsProcessingBench( int featureCount, int iterations, unsigned int seed );
+    ~QgsProcessingBench();
+
+    //! Returns the ids of the algorithms which can be benchmarked
+    static QStringList availableAlgorithms();
+
+    /**
+     * Benchmarks each of the \a algorithms. Returns false if one of them failed.
+     */
+    bool run( const QStringList &algorithms );
+
+    //! Returns the measurements of the last run()
+    QVariantMap log() const { return mLogMap; }
+
+    //! Prints a summary of the measurements to the standard output
+    void printLog() const;
+
+    //! Saves the measurements to \a fileName as JSON
+    bool saveLog( const QString &fileName ) const;
+
+    //! Loads measurements saved by saveLog() from \a fileName
+    static QVariantMap loadLog( const QString &fileName, bool *ok = nullptr );
+
+    /**
+     * Compares the \a current measurements to a \a baseline, and prints the differences.
+     * Returns false if an algorithm got slower, or allocates more, by more than
+     * \a threshold percent.
+     */
+    static bool compare( const QVariantMap &baseline, const QVariantMap &current, double threshold );
+
+  private:
+
+    void createLayers();
+    QVariantMap parameters( const QString &algorithm ) const;
+    QgsVectorLayer *inputLayer( const QString &algorithm ) const;
+    QVariantMap runAlgorithm( const QString &algorithm, bool &ok );
+
+    int mFeatureCount;
+    int mIterations;
+    unsigned int mSeed;
+
+    std::unique_ptr< QgsVectorLayer > mPolygons;
+    std::unique_ptr< QgsVectorLayer > mPoints;
+    std::unique_ptr< QgsVectorLayer > mOverlay;
+    std::unique_ptr< QgsVectorLayer > mTable;
+
+    QVariantMap mLogMap;
+};
+
+#endif // QGSPROCESSINGBENCH_H
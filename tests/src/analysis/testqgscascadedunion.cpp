@@ -0,0 +1,126 @@
+/***************************************************************************
+  testqgscascadedunion.cpp
+  ------------------------
+Date                 : December 2017
+Copyright            : (C) 2017 by the QGIS project
+Email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+
+//header for class being tested
+#include "qgscascadedunion.h"
+#include "qgsgeometry.h"
+#include "qgsfeedback.h"
+#include <qgsapplication.h>
+#include <QThreadPool>
+
+
+class TestQgsCascadedUnion : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void init();// will be called before each testfunction is executed.
+    void cleanup();// will be called after every testfunction.
+    void smallSet();
+    void largeSet();
+    void canceled();
+
+  private:
+
+    int mMaxThreadCount = 0;
+
+    //! Returns a grid of overlapping squares, in row order
+    QVector< QgsGeometry > squares( int rows, int columns ) const;
+};
+
+void TestQgsCascadedUnion::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsCascadedUnion::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsCascadedUnion::init()
+{
+  // large sets are united on several threads, even on single core machines
+  mMaxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QThreadPool::globalInstance()->setMaxThreadCount( std::max( 4, mMaxThreadCount ) );
+}
+
+void TestQgsCascadedUnion::cleanup()
+{
+  QThreadPool::globalInstance()->setMaxThreadCount( mMaxThreadCount );
+}
+
+QVector<QgsGeometry> TestQgsCascadedUnion::squares( int rows, int columns ) const
+{
+  QVector< QgsGeometry > geometries;
+  for ( int row = 0; row < rows; ++row )
+  {
+    for ( int column = 0; column < columns; ++column )
+      geometries << QgsGeometry::fromRect( QgsRectangle( column, row, column + 1.5, row + 1.5 ) );
+  }
+  return geometries;
+}
+
+void TestQgsCascadedUnion::smallSet()
+{
+  QVERIFY( QgsCascadedUnion::unaryUnion( QVector< QgsGeometry >() ).isNull() );
+
+  QgsGeometry result = QgsCascadedUnion::unaryUnion( squares( 2, 2 ) );
+  QGSCOMPARENEAR( result.area(), 2.5 * 2.5, 0.000001 );
+}
+
+void TestQgsCascadedUnion::largeSet()
+{
+  // large enough to be split in several partitions, with null geometries mixed in
+  QVector< QgsGeometry > geometries = squares( 60, 60 );
+  geometries.insert( 100, QgsGeometry() );
+  geometries << QgsGeometry();
+
+  QgsGeometry result = QgsCascadedUnion::unaryUnion( geometries );
+  QVERIFY( !result.isNull() );
+  QGSCOMPARENEAR( result.area(), 60.5 * 60.5, 0.000001 );
+  QCOMPARE( result.boundingBox(), QgsRectangle( 0, 0, 60.5, 60.5 ) );
+  QVERIFY( result.equals( QgsGeometry::unaryUnion( squares( 60, 60 ) ) ) );
+
+  // disjoint groups of squares, united over several levels of the cascade
+  geometries.clear();
+  for ( int group = 0; group < 5; ++group )
+  {
+    for ( const QgsGeometry &square : squares( 30, 30 ) )
+    {
+      QgsGeometry geometry = square;
+      geometry.translate( group * 100, 0 );
+      geometries << geometry;
+    }
+  }
+  result = QgsCascadedUnion::unaryUnion( geometries );
+  QCOMPARE( result.constGet()->partCount(), 5 );
+  QGSCOMPARENEAR( result.area(), 5 * 30.5 * 30.5, 0.000001 );
+}
+
+void TestQgsCascadedUnion::canceled()
+{
+  QgsFeedback feedback;
+  feedback.cancel();
+  QVERIFY( QgsCascadedUnion::unaryUnion( squares( 60, 60 ), &feedback ).isNull() );
+}
+
+
+QGSTEST_MAIN( TestQgsCascadedUnion )
+#include "testqgscascadedunion.moc"
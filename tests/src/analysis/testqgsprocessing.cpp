@@ -380,6 +380,55 @@ class DummyProvider3 : public QgsProcessingProvider
 
 };
 
+//! Feature based algorithm which skips validity checks and breaks the geometry of odd features
+class DummyInvalidGeometryAlgorithm : public QgsProcessingFeatureBasedAlgorithm
+{
+  public:
+
+    QString name() const override { return QStringLiteral( "invalidgeometry" ); }
+    QString displayName() const override { return name(); }
+    QString outputName() const override { return QStringLiteral( "invalid" ); }
+    QgsProcessingFeatureSource::Flag sourceFlags() const override { return QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks; }
+    DummyInvalidGeometryAlgorithm *createInstance() const override { return new DummyInvalidGeometryAlgorithm(); }
+
+    QgsFeatureList processFeature( const QgsFeature &feature, QgsProcessingContext &, QgsProcessingFeedback * ) override
+    {
+      QgsFeature f = feature;
+      if ( f.attribute( 0 ).toInt() % 2 )
+        f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 2 2, 2 0, 0 2, 0 0))" ) ) );
+      return QgsFeatureList() << f;
+    }
+};
+
+//! Parallel version of DummyInvalidGeometryAlgorithm
+class DummyParallelInvalidGeometryAlgorithm : public DummyInvalidGeometryAlgorithm
+{
+  public:
+
+    QString name() const override { return QStringLiteral( "parallelinvalidgeometry" ); }
+    DummyParallelInvalidGeometryAlgorithm *createInstance() const override { return new DummyParallelInvalidGeometryAlgorithm(); }
+
+  protected:
+
+    bool supportsParallelProcessing() const override { return true; }
+};
+
+class DummyChainProvider : public QgsProcessingProvider
+{
+  public:
+
+    QString id() const override { return QStringLiteral( "dummychain" ); }
+    QString name() const override { return QStringLiteral( "dummychain" ); }
+
+  protected:
+
+    void loadAlgorithms() override
+    {
+      addAlgorithm( new DummyInvalidGeometryAlgorithm() );
+      addAlgorithm( new DummyParallelInvalidGeometryAlgorithm() );
+    }
+};
+
 class TestQgsProcessing: public QObject
 {
     Q_OBJECT
@@ -442,6 +491,8 @@ class TestQgsProcessing: public QObject
     void asPythonCommand();
     void modelerAlgorithm();
     void modelExecution();
+    void modelFeatureBasedChains();
+    void modelParallelBranches();
     void modelAcceptableValues();
     void tempUtils();
     void convertCompatible();
@@ -703,6 +754,10 @@ void TestQgsProcessing::context()
   context.setInvalidGeometryCheck( QgsFeatureRequest::GeometrySkipInvalid );
   QCOMPARE( context.invalidGeometryCheck(), QgsFeatureRequest::GeometrySkipInvalid );
 
+  QCOMPARE( context.maximumThreads(), -1 );
+  context.setMaximumThreads( 3 );
+  QCOMPARE( context.maximumThreads(), 3 );
+
   QgsVectorLayer *vector = new QgsVectorLayer( "Polygon", "vector", "memory" );
   context.temporaryLayerStore()->addMapLayer( vector );
   QCOMPARE( context.temporaryLayerStore()->mapLayer( vector->id() ), vector );
@@ -713,6 +768,7 @@ void TestQgsProcessing::context()
   QCOMPARE( context2.invalidGeometryCheck(), context.invalidGeometryCheck() );
   QCOMPARE( context2.flags(), context.flags() );
   QCOMPARE( context2.project(), context.project() );
+  QCOMPARE( context2.maximumThreads(), 3 );
   // layers from temporaryLayerStore must not be copied by copyThreadSafeSettings
   QVERIFY( context2.temporaryLayerStore()->mapLayers().isEmpty() );
 
@@ -5555,6 +5611,223 @@ void TestQgsProcessing::modelExecution()
   QCOMPARE( actualParts, expectedParts );
 }
 
+void TestQgsProcessing::modelFeatureBasedChains()
+{
+  QgsProcessingModelAlgorithm model;
+  model.addModelParameter( new QgsProcessingParameterFeatureSource( "SOURCE_LAYER" ), QgsProcessingModelParameter( "SOURCE_LAYER" ) );
+
+  QgsProcessingModelChildAlgorithm algc1;
+  algc1.setChildId( "cx1" );
+  algc1.setAlgorithmId( "native:centroids" );
+  algc1.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromModelParameter( "SOURCE_LAYER" ) );
+  model.addChildAlgorithm( algc1 );
+  QgsProcessingModelChildAlgorithm algc2;
+  algc2.setChildId( "cx2" );
+  algc2.setAlgorithmId( "native:translategeometry" );
+  algc2.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromChildOutput( "cx1", "OUTPUT" ) );
+  algc2.addParameterSources( "DELTA_X", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromStaticValue( 1 ) );
+  model.addChildAlgorithm( algc2 );
+  QgsProcessingModelChildAlgorithm algc3;
+  algc3.setChildId( "cx3" );
+  algc3.setAlgorithmId( "native:translategeometry" );
+  algc3.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromChildOutput( "cx2", "OUTPUT" ) );
+  algc3.addParameterSources( "DELTA_Y", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromStaticValue( 2 ) );
+  QMap<QString, QgsProcessingModelOutput> outputs;
+  QgsProcessingModelOutput out( "OUT" );
+  out.setChildOutputName( "OUTPUT" );
+  outputs.insert( QStringLiteral( "OUT" ), out );
+  algc3.setModelOutputs( outputs );
+  model.addChildAlgorithm( algc3 );
+  // also reads the output of cx1, but is not active
+  QgsProcessingModelChildAlgorithm algc4;
+  algc4.setChildId( "cx4" );
+  algc4.setAlgorithmId( "native:centroids" );
+  algc4.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromChildOutput( "cx1", "OUTPUT" ) );
+  algc4.setActive( false );
+  model.addChildAlgorithm( algc4 );
+
+  QSet< QString > toExecute;
+  toExecute << QStringLiteral( "cx1" ) << QStringLiteral( "cx2" ) << QStringLiteral( "cx3" );
+  QCOMPARE( model.featureBasedChains( toExecute ), QList< QStringList >() << ( QStringList() << "cx1" << "cx2" << "cx3" ) );
+  // output of cx1 is read twice, so it must be materialized
+  toExecute << QStringLiteral( "cx4" );
+  QCOMPARE( model.featureBasedChains( toExecute ), QList< QStringList >() << ( QStringList() << "cx2" << "cx3" ) );
+  // model outputs are always materialized
+  toExecute.remove( QStringLiteral( "cx4" ) );
+  toExecute.remove( QStringLiteral( "cx1" ) );
+  QCOMPARE( model.featureBasedChains( toExecute ), QList< QStringList >() << ( QStringList() << "cx2" << "cx3" ) );
+  toExecute.remove( QStringLiteral( "cx3" ) );
+  QVERIFY( model.featureBasedChains( toExecute ).isEmpty() );
+
+  // run the model, streaming features from cx1 through cx3
+  std::unique_ptr< QgsVectorLayer > layer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?field=id:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeatureList features;
+  for ( int i = 0; i < 3; ++i )
+  {
+    QgsFeature f( layer->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromRect( QgsRectangle( i, 0, i + 2, 4 ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+  QgsProcessingContext context;
+  QgsProcessingFeedback feedback;
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "SOURCE_LAYER" ), QVariant::fromValue( layer.get() ) );
+  parameters.insert( QStringLiteral( "cx3:OUT" ), QStringLiteral( "memory:" ) );
+  bool ok = false;
+  QVariantMap results = model.run( parameters, context, &feedback, &ok );
+  QVERIFY( ok );
+
+  QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( QgsProcessingUtils::mapLayerFromString( results.value( QStringLiteral( "cx3:OUT" ) ).toString(), context ) );
+  QVERIFY( output );
+  QCOMPARE( output->featureCount(), 3L );
+  QgsFeatureIterator it = output->getFeatures();
+  QgsFeature f;
+  int i = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( 0 ).toInt(), i );
+    QCOMPARE( f.geometry().asWkt( 0 ), QStringLiteral( "Point (%1 4)" ).arg( i + 2 ) );
+    i++;
+  }
+  QCOMPARE( i, 3 );
+
+  // chained children check the geometries they receive, as if they read an intermediate layer
+  DummyChainProvider *provider = new DummyChainProvider();
+  QVERIFY( QgsApplication::processingRegistry()->addProvider( provider ) );
+  QgsProcessingModelAlgorithm invalidModel;
+  invalidModel.addModelParameter( new QgsProcessingParameterFeatureSource( "SOURCE_LAYER" ), QgsProcessingModelParameter( "SOURCE_LAYER" ) );
+  QgsProcessingModelChildAlgorithm invalidChild;
+  invalidChild.setChildId( "cx1" );
+  invalidChild.setAlgorithmId( "dummychain:invalidgeometry" );
+  invalidChild.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromModelParameter( "SOURCE_LAYER" ) );
+  invalidModel.addChildAlgorithm( invalidChild );
+  QgsProcessingModelChildAlgorithm translateChild;
+  translateChild.setChildId( "cx2" );
+  translateChild.setAlgorithmId( "native:translategeometry" );
+  translateChild.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromChildOutput( "cx1", "OUTPUT" ) );
+  translateChild.setModelOutputs( outputs );
+  invalidModel.addChildAlgorithm( translateChild );
+  QCOMPARE( invalidModel.featureBasedChains( QSet< QString >() << QStringLiteral( "cx1" ) << QStringLiteral( "cx2" ) ),
+            QList< QStringList >() << ( QStringList() << "cx1" << "cx2" ) );
+
+  auto runInvalidModel = [&]( QgsFeatureRequest::InvalidGeometryCheck check ) -> long
+  {
+    QgsProcessingContext invalidContext;
+    invalidContext.setInvalidGeometryCheck( check );
+    // parallel heads process their features in parallel, even on single core machines
+    invalidContext.setMaximumThreads( 2 );
+    QVariantMap invalidParameters;
+    invalidParameters.insert( QStringLiteral( "SOURCE_LAYER" ), QVariant::fromValue( layer.get() ) );
+    invalidParameters.insert( QStringLiteral( "cx2:OUT" ), QStringLiteral( "memory:" ) );
+    bool invalidOk = false;
+    QVariantMap invalidResults = invalidModel.run( invalidParameters, invalidContext, &feedback, &invalidOk );
+    if ( !invalidOk )
+      return -1;
+    QgsVectorLayer *invalidOutput = qobject_cast< QgsVectorLayer * >( QgsProcessingUtils::mapLayerFromString( invalidResults.value( QStringLiteral( "cx2:OUT" ) ).toString(), invalidContext ) );
+    return invalidOutput ? invalidOutput->featureCount() : -2;
+  };
+  QCOMPARE( runInvalidModel( QgsFeatureRequest::GeometryNoCheck ), 3L );
+  QCOMPARE( runInvalidModel( QgsFeatureRequest::GeometrySkipInvalid ), 2L );
+  QCOMPARE( runInvalidModel( QgsFeatureRequest::GeometryAbortOnInvalid ), -1L );
+
+  // a head processed in parallel, with enough features for the chained child
+  // to fail while the next block is still being processed
+  invalidModel.childAlgorithm( QStringLiteral( "cx1" ) ).setAlgorithmId( "dummychain:parallelinvalidgeometry" );
+  QVERIFY( invalidModel.childAlgorithm( QStringLiteral( "cx1" ) ).algorithm() );
+  std::unique_ptr< QgsVectorLayer > largeLayer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?field=id:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
+  QVERIFY( largeLayer->isValid() );
+  features.clear();
+  for ( int i = 0; i < 2500; ++i )
+  {
+    QgsFeature f( largeLayer->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromRect( QgsRectangle( i, 0, i + 2, 4 ) ) );
+    features << f;
+  }
+  QVERIFY( largeLayer->dataProvider()->addFeatures( features ) );
+  layer = std::move( largeLayer );
+  QCOMPARE( runInvalidModel( QgsFeatureRequest::GeometryNoCheck ), 2500L );
+  QCOMPARE( runInvalidModel( QgsFeatureRequest::GeometrySkipInvalid ), 1250L );
+  QCOMPARE( runInvalidModel( QgsFeatureRequest::GeometryAbortOnInvalid ), -1L );
+
+  QgsApplication::processingRegistry()->removeProvider( provider );
+}
+
+void TestQgsProcessing::modelParallelBranches()
+{
+  // two branches reading the same temporary layer, which may run at the same time
+  QgsProcessingModelAlgorithm model;
+  model.addModelParameter( new QgsProcessingParameterFeatureSource( "SOURCE_LAYER" ), QgsProcessingModelParameter( "SOURCE_LAYER" ) );
+
+  QgsProcessingModelChildAlgorithm algc1;
+  algc1.setChildId( "cx1" );
+  algc1.setAlgorithmId( "native:centroids" );
+  algc1.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromModelParameter( "SOURCE_LAYER" ) );
+  model.addChildAlgorithm( algc1 );
+  for ( int i = 2; i <= 3; ++i )
+  {
+    QgsProcessingModelChildAlgorithm child;
+    child.setChildId( QStringLiteral( "cx%1" ).arg( i ) );
+    child.setAlgorithmId( "native:translategeometry" );
+    child.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromChildOutput( "cx1", "OUTPUT" ) );
+    child.addParameterSources( "DELTA_X", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromStaticValue( i ) );
+    QMap<QString, QgsProcessingModelOutput> outputs;
+    QgsProcessingModelOutput out( "OUT" );
+    out.setChildOutputName( "OUTPUT" );
+    outputs.insert( QStringLiteral( "OUT" ), out );
+    child.setModelOutputs( outputs );
+    model.addChildAlgorithm( child );
+  }
+
+  std::unique_ptr< QgsVectorLayer > layer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?field=id:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeatureList features;
+  for ( int i = 0; i < 3; ++i )
+  {
+    QgsFeature f( layer->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromRect( QgsRectangle( i, 0, i + 2, 4 ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+  // in parallel, even on single core machines, and one child after another
+  for ( int maximumThreads : QList< int >() << 2 << 1 )
+  {
+    QgsProcessingContext context;
+    context.setMaximumThreads( maximumThreads );
+    QgsProcessingFeedback feedback;
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "SOURCE_LAYER" ), QVariant::fromValue( layer.get() ) );
+    parameters.insert( QStringLiteral( "cx2:OUT" ), QStringLiteral( "memory:" ) );
+    parameters.insert( QStringLiteral( "cx3:OUT" ), QStringLiteral( "memory:" ) );
+    bool ok = false;
+    QVariantMap results = model.run( parameters, context, &feedback, &ok );
+    QVERIFY( ok );
+
+    for ( int i = 2; i <= 3; ++i )
+    {
+      QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( QgsProcessingUtils::mapLayerFromString( results.value( QStringLiteral( "cx%1:OUT" ).arg( i ) ).toString(), context ) );
+      QVERIFY( output );
+      QCOMPARE( output->featureCount(), 3L );
+      QgsFeatureIterator it = output->getFeatures();
+      QgsFeature f;
+      int id = 0;
+      while ( it.nextFeature( f ) )
+      {
+        QCOMPARE( f.attribute( 0 ).toInt(), id );
+        QCOMPARE( f.geometry().asWkt( 0 ), QStringLiteral( "Point (%1 2)" ).arg( id + 1 + i ) );
+        id++;
+      }
+      QCOMPARE( id, 3 );
+    }
+  }
+}
+
 void TestQgsProcessing::modelAcceptableValues()
 {
   QgsProcessingModelAlgorithm m;
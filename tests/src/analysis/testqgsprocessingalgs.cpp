@@ -24,6 +24,8 @@
 #include "qgsprocessingmodelalgorithm.h"
 #include "qgsnativealgorithms.h"
 
+#include <QThread>
+
 class TestQgsProcessingAlgs: public QObject
 {
     Q_OBJECT
@@ -36,6 +38,9 @@ class TestQgsProcessingAlgs: public QObject
     void packageAlg();
     void renameLayerAlg();
     void loadLayerAlg();
+    void parallelFeatureAlg();
+    void extractByLocationIndexed();
+    void dissolveBatches();
 
   private:
 
@@ -217,6 +222,186 @@ void TestQgsProcessingAlgs::loadLayerAlg()
   QCOMPARE( context->layersToLoadOnCompletion().value( layerId, QgsProcessingContext::LayerDetails( QString(), nullptr, QString() ) ).outputName, QStringLiteral( "my layer" ) );
 }
 
+void TestQgsProcessingAlgs::parallelFeatureAlg()
+{
+  const QgsProcessingAlgorithm *centroids( QgsApplication::processingRegistry()->algorithmById( QStringLiteral( "native:centroids" ) ) );
+  QVERIFY( centroids );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  context->setProject( QgsProject::instance() );
+
+  // enough features to be processed in several blocks
+  std::unique_ptr< QgsVectorLayer > layer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?field=id:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeatureList features;
+  for ( int i = 0; i < 2500; ++i )
+  {
+    QgsFeature f( layer->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    if ( i % 100 != 0 )
+      f.setGeometry( QgsGeometry::fromRect( QgsRectangle( i, 0, i + 2, 4 ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+  QgsProcessingFeedback feedback;
+
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( layer.get() ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+  bool ok = false;
+  QVariantMap results = centroids->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+
+  QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( QgsProcessingUtils::mapLayerFromString( results.value( QStringLiteral( "OUTPUT" ) ).toString(), *context ) );
+  QVERIFY( output );
+  QCOMPARE( output->featureCount(), 2500L );
+
+  // output features keep the order of the input features
+  QgsFeatureIterator it = output->getFeatures();
+  QgsFeature f;
+  int i = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( 0 ).toInt(), i );
+    if ( i % 100 != 0 )
+      QCOMPARE( f.geometry().asWkt( 0 ), QStringLiteral( "Point (%1 2)" ).arg( i + 1 ) );
+    else
+      QVERIFY( !f.hasGeometry() );
+    i++;
+  }
+  QCOMPARE( i, 2500 );
+}
+
+void TestQgsProcessingAlgs::extractByLocationIndexed()
+{
+  const QgsProcessingAlgorithm *extract( QgsApplication::processingRegistry()->algorithmById( QStringLiteral( "native:extractbylocation" ) ) );
+  QVERIFY( extract );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  context->setProject( QgsProject::instance() );
+
+  // both layers are large enough to be joined with an index on the smaller one
+  std::unique_ptr< QgsVectorLayer > points = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Point?crs=EPSG:3857&field=id:integer" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < 300; ++i )
+  {
+    QgsFeature f( points->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, 0 ) ) );
+    features << f;
+  }
+  QVERIFY( points->dataProvider()->addFeatures( features ) );
+
+  std::unique_ptr< QgsVectorLayer > polygons = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=EPSG:3857&field=id:integer" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) );
+  features.clear();
+  for ( int i = 0; i < 160; ++i )
+  {
+    QgsFeature f( polygons->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromRect( QgsRectangle( 2 * i - 0.25, -1, 2 * i + 0.25, 1 ) ) );
+    features << f;
+  }
+  QVERIFY( polygons->dataProvider()->addFeatures( features ) );
+
+  auto extractCount = [&]( QgsVectorLayer * input, QgsVectorLayer * intersect, int predicate ) -> long
+  {
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( input ) );
+    parameters.insert( QStringLiteral( "INTERSECT" ), QVariant::fromValue( intersect ) );
+    parameters.insert( QStringLiteral( "PREDICATE" ), QVariant::fromValue( QList< int >() << predicate ) );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+    QgsProcessingFeedback feedback;
+    bool ok = false;
+    QVariantMap results = extract->run( parameters, *context, &feedback, &ok );
+    if ( !ok )
+      return -1;
+    QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( QgsProcessingUtils::mapLayerFromString( results.value( QStringLiteral( "OUTPUT" ) ).toString(), *context ) );
+    return output ? output->featureCount() : -1;
+  };
+
+  // polygons are indexed, points are streamed
+  QCOMPARE( extractCount( points.get(), polygons.get(), 0 ), 150L );
+  QCOMPARE( extractCount( points.get(), polygons.get(), 2 ), 150L );
+  QCOMPARE( extractCount( points.get(), polygons.get(), 6 ), 150L );
+  QCOMPARE( extractCount( points.get(), polygons.get(), 1 ), 0L );
+
+  // points are indexed, polygons are streamed
+  QCOMPARE( extractCount( polygons.get(), points.get(), 0 ), 150L );
+  QCOMPARE( extractCount( polygons.get(), points.get(), 2 ), 10L );
+  QCOMPARE( extractCount( polygons.get(), points.get(), 1 ), 150L );
+  QCOMPARE( extractCount( polygons.get(), points.get(), 6 ), 0L );
+}
+
+void TestQgsProcessingAlgs::dissolveBatches()
+{
+  const QgsProcessingAlgorithm *dissolve( QgsApplication::processingRegistry()->algorithmById( QStringLiteral( "native:dissolve" ) ) );
+  QVERIFY( dissolve );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  context->setProject( QgsProject::instance() );
+
+  // more categories than fit in two batches, each one made of three overlapping squares,
+  // and a last category large enough to be united in several partitions
+  const int categories = std::max( 1, QThread::idealThreadCount() ) * 4 * 2 + 3;
+  std::unique_ptr< QgsVectorLayer > layer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?field=cat:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeatureList features;
+  for ( int category = 0; category < categories; ++category )
+  {
+    for ( int i = 0; i < 3; ++i )
+    {
+      QgsFeature f( layer->fields() );
+      f.setAttributes( QgsAttributes() << category );
+      f.setGeometry( QgsGeometry::fromRect( QgsRectangle( category * 10 + i, 0, category * 10 + i + 2, 2 ) ) );
+      features << f;
+    }
+  }
+  for ( int row = 0; row < 40; ++row )
+  {
+    for ( int column = 0; column < 40; ++column )
+    {
+      QgsFeature f( layer->fields() );
+      f.setAttributes( QgsAttributes() << categories );
+      f.setGeometry( QgsGeometry::fromRect( QgsRectangle( column, 100 + row, column + 1.5, 100 + row + 1.5 ) ) );
+      features << f;
+    }
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( layer.get() ) );
+  parameters.insert( QStringLiteral( "FIELD" ), QStringList() << QStringLiteral( "cat" ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+  QgsProcessingFeedback feedback;
+  bool ok = false;
+  QVariantMap results = dissolve->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+
+  QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( QgsProcessingUtils::mapLayerFromString( results.value( QStringLiteral( "OUTPUT" ) ).toString(), *context ) );
+  QVERIFY( output );
+  QCOMPARE( output->featureCount(), static_cast< long >( categories + 1 ) );
+
+  QSet< int > found;
+  QgsFeatureIterator it = output->getFeatures();
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+  {
+    const int category = f.attribute( 0 ).toInt();
+    found << category;
+    if ( category == categories )
+    {
+      QGSCOMPARENEAR( f.geometry().area(), 40.5 * 40.5, 0.000001 );
+    }
+    else
+    {
+      QGSCOMPARENEAR( f.geometry().area(), 8.0, 0.000001 );
+      QCOMPARE( f.geometry().boundingBox(), QgsRectangle( category * 10, 0, category * 10 + 4, 2 ) );
+    }
+  }
+  QCOMPARE( found.count(), categories + 1 );
+}
+
 
 QGSTEST_MAIN( TestQgsProcessingAlgs )
 #include "testqgsprocessingalgs.moc"
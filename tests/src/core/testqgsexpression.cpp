@@ -1386,6 +1386,94 @@ class TestQgsExpression: public QObject
       QCOMPARE( v.toInt(), 5 );
     }
 
+    void eval_compiled_data()
+    {
+      QTest::addColumn<QString>( "string" );
+
+      QTest::newRow( "int plus" ) << "a + 3";
+      QTest::newRow( "int div" ) << "a / 2";
+      QTest::newRow( "int mod zero" ) << "a % z";
+      QTest::newRow( "int intdiv" ) << "a // 2";
+      QTest::newRow( "mixed mul" ) << "b * a";
+      QTest::newRow( "pow" ) << "a ^ 2";
+      QTest::newRow( "minus" ) << "-a";
+      QTest::newRow( "minus null" ) << "-n";
+      QTest::newRow( "null plus" ) << "n + 1";
+      QTest::newRow( "logic" ) << "a > b AND NOT ( z <> 0 )";
+      QTest::newRow( "logic null" ) << "n = 1 OR a = 5";
+      QTest::newRow( "logic unknown" ) << "n = 1 AND a = 5";
+      QTest::newRow( "compare" ) << "a % 3 = 2";
+      QTest::newRow( "nested" ) << "( a + b ) * 2 - 1.5";
+      QTest::newRow( "abs" ) << "abs( a - b * 3 )";
+      QTest::newRow( "sqrt" ) << "sqrt( a ) > 2";
+      QTest::newRow( "abs null" ) << "abs( n )";
+      QTest::newRow( "string attribute" ) << "s + 1";
+      QTest::newRow( "string operator" ) << "a || 'x'";
+    }
+
+    void eval_compiled()
+    {
+      QFETCH( QString, string );
+
+      QgsFields fields;
+      fields.append( QgsField( QStringLiteral( "a" ), QVariant::Int ) );
+      fields.append( QgsField( QStringLiteral( "b" ), QVariant::Double ) );
+      fields.append( QgsField( QStringLiteral( "z" ), QVariant::LongLong ) );
+      fields.append( QgsField( QStringLiteral( "n" ), QVariant::Int ) );
+      fields.append( QgsField( QStringLiteral( "s" ), QVariant::String ) );
+      QgsFeature f( fields, 1 );
+      f.setAttributes( QgsAttributes() << 5 << 2.5 << 0LL << QVariant( QVariant::Int ) << QStringLiteral( "7" ) );
+      QgsExpressionContext context = QgsExpressionContextUtils::createFeatureBasedContext( f, fields );
+
+      // a prepared expression runs its compiled form, an unprepared one walks the tree
+      QgsExpression compiled( string );
+      QVERIFY( compiled.prepare( &context ) );
+      QgsExpression tree( string );
+
+      QVariant expected = tree.evaluate( &context );
+      QVariant result = compiled.evaluate( &context );
+      QCOMPARE( result.isNull(), expected.isNull() );
+      QCOMPARE( result.type(), expected.type() );
+      QCOMPARE( result, expected );
+      QCOMPARE( compiled.hasEvalError(), tree.hasEvalError() );
+    }
+
+    void eval_batch()
+    {
+      QgsFields fields;
+      fields.append( QgsField( QStringLiteral( "a" ), QVariant::Int ) );
+      fields.append( QgsField( QStringLiteral( "b" ), QVariant::Double ) );
+      QVector<QgsFeature> features;
+      for ( int i = 0; i < 10; ++i )
+      {
+        QgsFeature f( fields, i );
+        f.setAttributes( QgsAttributes() << i << i * 0.5 );
+        features << f;
+      }
+      // values the compiled expression cannot handle are evaluated one by one
+      features[3].setAttribute( 0, QVariant( QVariant::Int ) );
+      features[5].setAttribute( 0, QStringLiteral( "12" ) );
+      features[7].setAttribute( 0, QStringLiteral( "x" ) );
+
+      QgsExpressionContext context = QgsExpressionContextUtils::createFeatureBasedContext( QgsFeature(), fields );
+      QgsExpression exp( QStringLiteral( "abs( a - 2 ) * b > 1" ) );
+      QVERIFY( exp.prepare( &context ) );
+      QVector<QVariant> results = exp.evaluate( features, &context );
+      QCOMPARE( results.count(), features.count() );
+      QVERIFY( exp.hasEvalError() );
+
+      QgsExpression tree( exp.expression() );
+      for ( int i = 0; i < features.count(); ++i )
+      {
+        context.setFeature( features.at( i ) );
+        QVariant expected = tree.evaluate( &context );
+        QCOMPARE( results.at( i ), expected );
+        QCOMPARE( results.at( i ).type(), expected.type() );
+      }
+
+      QCOMPARE( exp.evaluate( QVector<QgsFeature>(), &context ).count(), 0 );
+    }
+
     void eval_get_feature_data()
     {
       QTest::addColumn<QString>( "string" );
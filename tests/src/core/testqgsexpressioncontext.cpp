@@ -21,6 +21,7 @@
 #include "qgsapplication.h"
 #include "qgsproject.h"
 #include "qgscolorscheme.h"
+#include "qgsgeometry.h"
 #include <QObject>
 #include "qgstest.h"
 
@@ -41,6 +42,7 @@ class TestQgsExpressionContext : public QObject
     void contextCopy();
     void contextStackFunctions();
     void evaluate();
+    void variableLookup();
     void setFeature();
     void setFields();
     void takeScopes();
@@ -51,6 +53,7 @@ class TestQgsExpressionContext : public QObject
     void featureBasedContext();
 
     void cache();
+    void cachedFunctionResults();
 
     void valuesAsMap();
     void description();
@@ -128,6 +131,29 @@ class TestQgsExpressionContext : public QObject
 
         int *mVal = nullptr;
     };
+
+    class CacheableFunction : public ModifiableFunction
+    {
+      public:
+        explicit CacheableFunction( int *v )
+          : ModifiableFunction( v )
+          , mVal( v )
+        {}
+
+        QgsScopedExpressionFunction *clone() const override
+        {
+          return new CacheableFunction( mVal );
+        }
+
+        bool isCacheable() const override
+        {
+          return true;
+        }
+
+      private:
+
+        int *mVal = nullptr;
+    };
 };
 
 void TestQgsExpressionContext::initTestCase()
@@ -451,6 +477,61 @@ void TestQgsExpressionContext::evaluate()
   QCOMPARE( testExpWContextFunction.evaluate( &context2 ).toInt(), 52 );
 }
 
+void TestQgsExpressionContext::variableLookup()
+{
+  QgsExpressionContext context;
+  QgsExpressionContextScope *s1 = new QgsExpressionContextScope();
+  s1->setVariable( QStringLiteral( "test" ), 5 );
+  s1->setVariable( QStringLiteral( "other" ), 1 );
+  context << s1;
+
+  QgsExpressionContextVariableLookup lookup( QStringLiteral( "test" ) );
+  QCOMPARE( context.variable( lookup ).toInt(), 5 );
+  QVERIFY( !lookup.isVarFunctionOverridden() );
+
+  // changing a value keeps the lookup valid
+  s1->setVariable( QStringLiteral( "test" ), 7 );
+  QCOMPARE( context.variable( lookup ).toInt(), 7 );
+
+  // a scope on top of the stack hides the variable
+  QgsExpressionContextScope *s2 = new QgsExpressionContextScope();
+  s2->setVariable( QStringLiteral( "test" ), 9 );
+  context << s2;
+  QCOMPARE( context.variable( lookup ).toInt(), 9 );
+  delete context.popScope();
+  QCOMPARE( context.variable( lookup ).toInt(), 7 );
+
+  // removing variables moves the others within the scope
+  s1->removeVariable( QStringLiteral( "other" ) );
+  QCOMPARE( context.variable( lookup ).toInt(), 7 );
+  s1->removeVariable( QStringLiteral( "test" ) );
+  QVERIFY( !context.variable( lookup ).isValid() );
+  s1->setVariable( QStringLiteral( "test" ), 11 );
+  QCOMPARE( context.variable( lookup ).toInt(), 11 );
+
+  // the same lookup can be used with another context
+  QgsExpressionContext context2;
+  QgsExpressionContextScope *s3 = new QgsExpressionContextScope();
+  s3->setVariable( QStringLiteral( "test" ), 13 );
+  context2 << s3;
+  QCOMPARE( context2.variable( lookup ).toInt(), 13 );
+  QCOMPARE( context.variable( lookup ).toInt(), 11 );
+
+  // prepared expressions keep following the scopes of the context
+  QgsExpression exp( QStringLiteral( "@test + 1" ) );
+  QVERIFY( exp.prepare( &context ) );
+  QCOMPARE( exp.evaluate( &context ).toInt(), 12 );
+  QgsExpressionContextScope *s4 = new QgsExpressionContextScope();
+  s4->setVariable( QStringLiteral( "test" ), 1 );
+  context << s4;
+  QCOMPARE( exp.evaluate( &context ).toInt(), 2 );
+  s4->setVariable( QStringLiteral( "test" ), 2 );
+  QCOMPARE( exp.evaluate( &context ).toInt(), 3 );
+  delete context.popScope();
+  QCOMPARE( exp.evaluate( &context ).toInt(), 12 );
+  QCOMPARE( exp.evaluate( &context2 ).toInt(), 14 );
+}
+
 void TestQgsExpressionContext::setFeature()
 {
   QgsFeature feature( 50LL );
@@ -763,6 +844,62 @@ void TestQgsExpressionContext::cache()
   QVERIFY( !c.cachedValue( "test" ).isValid() );
 }
 
+void TestQgsExpressionContext::cachedFunctionResults()
+{
+  QgsExpression::registerFunction( new ModifiableFunction( nullptr ), true );
+
+  int calls = 0;
+  QgsExpressionContext context;
+  QgsExpressionContextScope *scope = new QgsExpressionContextScope();
+  scope->addFunction( QStringLiteral( "test_function" ), new CacheableFunction( &calls ) );
+  context << scope;
+
+  QgsFields fields;
+  fields.append( QgsField( QStringLiteral( "a" ), QVariant::Int ) );
+  QgsFeature f( fields, 1 );
+  f.setAttributes( QgsAttributes() << 5 );
+  context.setFeature( f );
+
+  // the same call made by several expressions only runs once for a feature
+  QgsExpression exp1( QStringLiteral( "test_function( 1 ) + 1" ) );
+  QgsExpression exp2( QStringLiteral( "test_function( 1 ) * 10" ) );
+  QgsExpression exp3( QStringLiteral( "test_function( 2 )" ) );
+  QCOMPARE( exp1.evaluate( &context ).toInt(), 2 );
+  QCOMPARE( exp2.evaluate( &context ).toInt(), 10 );
+  QCOMPARE( calls, 1 );
+  QCOMPARE( exp3.evaluate( &context ).toInt(), 2 );
+  QCOMPARE( calls, 2 );
+
+  // results are dropped once another feature is set
+  QgsFeature f2( fields, 2 );
+  f2.setAttributes( QgsAttributes() << 6 );
+  context.setFeature( f2 );
+  QCOMPARE( exp1.evaluate( &context ).toInt(), 4 );
+  QCOMPARE( calls, 3 );
+
+  // and whenever a feature is set, even one with the same id
+  f2.setAttributes( QgsAttributes() << 7 );
+  context.setFeature( f2 );
+  QCOMPARE( exp1.evaluate( &context ).toInt(), 5 );
+  QCOMPARE( calls, 4 );
+
+  QVariant result;
+  QVERIFY( !context.cachedFunctionResult( QStringLiteral( "x" ), QVariantList() << 1, result ) );
+  context.setCachedFunctionResult( QStringLiteral( "x" ), QVariantList() << 1, 7 );
+  QVERIFY( context.cachedFunctionResult( QStringLiteral( "x" ), QVariantList() << 1, result ) );
+  QCOMPARE( result.toInt(), 7 );
+  QVERIFY( !context.cachedFunctionResult( QStringLiteral( "x" ), QVariantList() << QStringLiteral( "1" ), result ) );
+
+  // geometries are identified by their shared data
+  QgsGeometry g = QgsGeometry::fromWkt( QStringLiteral( "Point( 1 1 )" ) );
+  context.setCachedFunctionResult( QStringLiteral( "g" ), QVariantList() << QVariant::fromValue( g ), 1 );
+  QVERIFY( context.cachedFunctionResult( QStringLiteral( "g" ), QVariantList() << QVariant::fromValue( QgsGeometry( g ) ), result ) );
+  QVERIFY( !context.cachedFunctionResult( QStringLiteral( "g" ), QVariantList() << QVariant::fromValue( QgsGeometry::fromWkt( QStringLiteral( "Point( 1 1 )" ) ) ), result ) );
+
+  context.clearCachedValues();
+  QVERIFY( !context.cachedFunctionResult( QStringLiteral( "x" ), QVariantList() << 1, result ) );
+}
+
 void TestQgsExpressionContext::valuesAsMap()
 {
   QgsExpressionContext context;
@@ -22,6 +22,32 @@
 #include "qgsfield.h"
 #include "qgsgeometry.h"
 
+//! Decoder returning the index multiplied by 10, and counting the decoded attributes
+class TestAttributeDecoder : public QgsAttributeDecoder
+{
+  public:
+    explicit TestAttributeDecoder( int *decodeCount, bool *deleted = nullptr )
+      : mDecodeCount( decodeCount )
+      , mDeleted( deleted )
+    {}
+
+    ~TestAttributeDecoder() override
+    {
+      if ( mDeleted )
+        *mDeleted = true;
+    }
+
+    QVariant decode( int index ) const override
+    {
+      ( *mDecodeCount )++;
+      return QVariant( index * 10 );
+    }
+
+  private:
+    int *mDecodeCount = nullptr;
+    bool *mDeleted = nullptr;
+};
+
 class TestQgsFeature: public QObject
 {
     Q_OBJECT
@@ -38,6 +64,7 @@ class TestQgsFeature: public QObject
     void assignment();
     void gettersSetters(); //test getters and setters
     void attributes();
+    void lazyAttributes();
     void geometry();
     void asVariant(); //test conversion to and from a QVariant
     void fields();
@@ -265,6 +292,60 @@ void TestQgsFeature::attributes()
   QCOMPARE( feature.attributes(), mAttrs );
 }
 
+void TestQgsFeature::lazyAttributes()
+{
+  int decodeCount = 0;
+  bool decoderDeleted = false;
+  QgsFeature feature( mFields );
+  feature.setLazyAttributes( 3, new TestAttributeDecoder( &decodeCount, &decoderDeleted ) );
+  QVERIFY( feature.isValid() );
+  QCOMPARE( feature.attributeCount(), 3 );
+  QCOMPARE( decodeCount, 0 );
+
+  // values are decoded once, on first access
+  QCOMPARE( feature.attribute( 1 ), QVariant( 10 ) );
+  QCOMPARE( feature.attribute( QStringLiteral( "field2" ) ), QVariant( 10 ) );
+  QCOMPARE( decodeCount, 1 );
+
+  // copies share the decoded values
+  QgsFeature copy( feature );
+  QCOMPARE( copy.attribute( 1 ), QVariant( 10 ) );
+  QCOMPARE( decodeCount, 1 );
+
+  // modified attributes are not decoded, and do not affect the copies
+  copy.setAttribute( 0, QVariant( 5 ) );
+  QCOMPARE( copy.attribute( 0 ), QVariant( 5 ) );
+  QCOMPARE( decodeCount, 1 );
+  QCOMPARE( feature.attribute( 0 ), QVariant( 0 ) );
+  QCOMPARE( decodeCount, 2 );
+  QVERIFY( !decoderDeleted );
+  QCOMPARE( copy.attributes(), QgsAttributes() << QVariant( 5 ) << QVariant( 10 ) << QVariant( 20 ) );
+  QCOMPARE( decodeCount, 3 );
+  // the decoder is released once all the values are decoded
+  QVERIFY( decoderDeleted );
+  QCOMPARE( feature.attributes(), QgsAttributes() << QVariant( 0 ) << QVariant( 10 ) << QVariant( 20 ) );
+  QCOMPARE( decodeCount, 3 );
+  QVERIFY( copy != feature );
+
+  // the decoded values are kept, reading them does not modify the feature
+  const QgsAttributes attributes = feature.attributes();
+  QCOMPARE( feature.attributes(), attributes );
+  QCOMPARE( feature.attribute( 2 ), QVariant( 20 ) );
+  QCOMPARE( QgsFeature( feature ).attributes(), attributes );
+  QCOMPARE( decodeCount, 3 );
+
+  copy.deleteAttribute( 0 );
+  QCOMPARE( copy.attributes(), QgsAttributes() << QVariant( 10 ) << QVariant( 20 ) );
+
+  // setting all the attributes drops the decoder
+  feature.setAttributes( mAttrs );
+  QCOMPARE( feature.attributes(), mAttrs );
+  feature.setLazyAttributes( 3, new TestAttributeDecoder( &decodeCount ) );
+  feature.initAttributes( 2 );
+  QCOMPARE( feature.attributes(), QgsAttributes( 2 ) );
+  QCOMPARE( decodeCount, 3 );
+}
+
 void TestQgsFeature::geometry()
 {
   QgsFeature feature;
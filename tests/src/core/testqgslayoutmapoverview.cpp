@@ -20,6 +20,7 @@
 #include "qgsmultirenderchecker.h"
 #include "qgslayoutitemmap.h"
 #include "qgslayoutitemmapoverview.h"
+#include "qgslayoutrendercontext.h"
 #include "qgsproject.h"
 #include "qgsmultibandcolorrenderer.h"
 #include "qgsrasterlayer.h"
@@ -47,6 +48,7 @@ class TestQgsLayoutMapOverview : public QObject
     void overviewMapInvert(); //test if invert of overview map frame works
     void overviewMapCenter(); //test if centering of overview map frame works
     void overviewReprojected(); //test that overview frame is reprojected
+    void overviewMapParallel(); //test rendering the maps concurrently
 
   private:
     QgsRasterLayer *mRasterLayer = nullptr;
@@ -290,5 +292,33 @@ void TestQgsLayoutMapOverview::overviewReprojected()
   QVERIFY( testResult );
 }
 
+void TestQgsLayoutMapOverview::overviewMapParallel()
+{
+  QgsLayout l( QgsProject::instance() );
+  l.initializeDefaults();
+  l.renderContext().setFlag( QgsLayoutRenderContext::FlagRenderMapsInParallel, true );
+  QgsLayoutItemMap *map = new QgsLayoutItemMap( &l );
+  map->attemptSetSceneRect( QRectF( 20, 20, 200, 100 ) );
+  map->setFrameEnabled( true );
+  map->setLayers( QList<QgsMapLayer *>() << mRasterLayer );
+  l.addLayoutItem( map );
+
+  QgsLayoutItemMap *overviewMap = new QgsLayoutItemMap( &l );
+  overviewMap->attemptSetSceneRect( QRectF( 20, 130, 70, 70 ) );
+  overviewMap->setFrameEnabled( true );
+  overviewMap->setLayers( QList<QgsMapLayer *>() << mRasterLayer );
+  l.addLayoutItem( overviewMap );
+  map->setExtent( QgsRectangle( 96, -152, 160, -120 ) ); //zoom in
+  overviewMap->setExtent( QgsRectangle( 0, -256, 256, 0 ) );
+  overviewMap->overview()->setLinkedMap( map );
+
+  // both maps are rendered in background jobs, the result must match the sequential render
+  QgsLayoutChecker checker( QStringLiteral( "composermap_overview" ), &l );
+  checker.setControlPathPrefix( QStringLiteral( "composer_mapoverview" ) );
+
+  bool testResult = checker.testLayout( mReport, 0, 0 );
+  QVERIFY( testResult );
+}
+
 QGSTEST_MAIN( TestQgsLayoutMapOverview )
 #include "testqgslayoutmapoverview.moc"
@@ -136,6 +136,42 @@ class TestQgsSpatialIndex : public QObject
       QVERIFY( fids[0] == 1 );
     }
 
+    void testBulkLoad()
+    {
+      QgsVectorLayer vl( QStringLiteral( "Point" ), QStringLiteral( "x" ), QStringLiteral( "memory" ) );
+      QgsFeatureList features;
+      for ( const QgsFeature &f : _pointFeatures() )
+        features << f;
+      vl.dataProvider()->addFeatures( features );
+
+      QgsSpatialIndex index( *vl.dataProvider() );
+      QList<QgsFeatureId> fids = index.intersects( QgsRectangle( -10, -10, 0, 10 ) );
+      std::sort( fids.begin(), fids.end() );
+      QCOMPARE( fids, QList<QgsFeatureId>() << 2 << 3 );
+      QVERIFY( index.intersects( QgsRectangle( 5, 5, 10, 10 ) ).isEmpty() );
+
+      // batch queries
+      QVector< QList<QgsFeatureId> > results = index.intersects( QVector<QgsRectangle>() << QgsRectangle( 0, 0, 10, 10 ) << QgsRectangle( 5, 5, 10, 10 ) << QgsRectangle( -1, -1, -1, -1 ) );
+      QCOMPARE( results.size(), 3 );
+      QCOMPARE( results.at( 0 ), QList<QgsFeatureId>() << 1 );
+      QVERIFY( results.at( 1 ).isEmpty() );
+      QCOMPARE( results.at( 2 ), QList<QgsFeatureId>() << 3 );
+
+      fids = index.nearestNeighbor( QgsPointXY( 2, -1.5 ), 1 );
+      QCOMPARE( fids, QList<QgsFeatureId>() << 4 );
+      fids = index.nearestNeighbor( QgsPointXY( 0, 0 ), 2 );
+      QCOMPARE( fids.count(), 4 );
+
+      // a copy modified after a bulk load
+      QgsSpatialIndex indexCopy( index );
+      indexCopy.insertFeature( 5, QgsRectangle( 6, 6, 7, 7 ) );
+      QVERIFY( indexCopy.deleteFeature( _pointFeatures().at( 0 ) ) );
+      QCOMPARE( indexCopy.intersects( QgsRectangle( 0, 0, 10, 10 ) ), QList<QgsFeatureId>() << 5 );
+      results = indexCopy.intersects( QVector<QgsRectangle>() << QgsRectangle( -10, -10, 0, 0 ) );
+      QCOMPARE( results.at( 0 ), QList<QgsFeatureId>() << 3 );
+      QCOMPARE( index.intersects( QgsRectangle( 0, 0, 10, 10 ) ), QList<QgsFeatureId>() << 1 );
+    }
+
     void benchmarkIntersect()
     {
       // add 50K features to the index
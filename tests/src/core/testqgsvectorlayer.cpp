@@ -20,6 +20,7 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QDesktopServices>
+#include <QSignalSpy>
 
 //qgis includes...
 #include <qgsgeometry.h>
@@ -33,6 +34,7 @@
 #include <qgsproject.h>
 #include <qgssymbol.h>
 #include <qgssinglesymbolrenderer.h>
+#include <qgscategorizedsymbolrenderer.h>
 //qgis test includes
 #include "qgsrenderchecker.h"
 
@@ -90,6 +92,8 @@ class TestQgsVectorLayer : public QObject
     void cleanup() {} // will be called after every testfunction.
 
     void QgsVectorLayerNonSpatialIterator();
+    void nextFeatures();
+    void countSymbolFeatures();
     void QgsVectorLayerGetValues();
     void QgsVectorLayersetRenderer();
     void QgsVectorLayersetFeatureBlendMode();
@@ -188,6 +192,183 @@ void TestQgsVectorLayer::QgsVectorLayerNonSpatialIterator()
   QVERIFY( myCount == 3 );
 }
 
+void TestQgsVectorLayer::nextFeatures()
+{
+  std::unique_ptr< QgsVectorLayer > layer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Point?field=col1:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeatureList features;
+  for ( int i = 0; i < 10; ++i )
+  {
+    QgsFeature f( layer->fields() );
+    f.setAttribute( 0, i );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+  // blocks from the iterator
+  QVector<QgsFeature> block;
+  QgsFeatureIterator fit = layer->getFeatures();
+  QCOMPARE( fit.nextFeatures( block, 4 ), 4 );
+  QCOMPARE( block.size(), 4 );
+  QCOMPARE( block.at( 0 ).attribute( 0 ).toInt(), 0 );
+  QCOMPARE( block.at( 3 ).attribute( 0 ).toInt(), 3 );
+  QCOMPARE( fit.nextFeatures( block, 4 ), 4 );
+  QCOMPARE( block.at( 0 ).attribute( 0 ).toInt(), 4 );
+  QCOMPARE( fit.nextFeatures( block, 4 ), 2 );
+  QCOMPARE( block.size(), 2 );
+  QCOMPARE( block.at( 1 ).attribute( 0 ).toInt(), 9 );
+  QCOMPARE( fit.nextFeatures( block, 4 ), 0 );
+  QVERIFY( block.isEmpty() );
+
+  // limit and filter are respected
+  fit = layer->getFeatures( QgsFeatureRequest().setLimit( 3 ) );
+  QCOMPARE( fit.nextFeatures( block, 4 ), 3 );
+  QCOMPARE( fit.nextFeatures( block, 4 ), 0 );
+
+  fit = layer->getFeatures( QgsFeatureRequest().setFilterExpression( QStringLiteral( "col1 % 2 = 0" ) ) );
+  QCOMPARE( fit.nextFeatures( block, 10 ), 5 );
+  QCOMPARE( block.at( 4 ).attribute( 0 ).toInt(), 8 );
+
+  // mixed with nextFeature
+  QgsFeature f;
+  fit = layer->getFeatures();
+  QVERIFY( fit.nextFeature( f ) );
+  QCOMPARE( fit.nextFeatures( block, 20 ), 9 );
+  QCOMPARE( block.at( 0 ).attribute( 0 ).toInt(), 1 );
+  QVERIFY( !fit.nextFeature( f ) );
+
+  // default constructed iterator
+  QCOMPARE( QgsFeatureIterator().nextFeatures( block, 4 ), 0 );
+
+  // blocks handed over from the provider are still reprojected and checked
+  std::unique_ptr< QgsVectorLayer > polygons = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=EPSG:4326&field=id:integer" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) );
+  QVERIFY( polygons->isValid() );
+  features.clear();
+  for ( int i = 0; i < 5; ++i )
+  {
+    QgsFeature f( polygons->fields() );
+    f.setAttribute( 0, i );
+    // feature 2 is a self-intersecting bowtie
+    f.setGeometry( QgsGeometry::fromWkt( i == 2 ? QStringLiteral( "Polygon((0 0, 1 1, 1 0, 0 1, 0 0))" )
+                                         : QStringLiteral( "Polygon((%1 0, %2 0, %2 1, %1 1, %1 0))" ).arg( i ).arg( i + 1 ) ) );
+    features << f;
+  }
+  QVERIFY( polygons->dataProvider()->addFeatures( features ) );
+
+  QgsFeatureRequest request;
+  request.setDestinationCrs( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ), QgsProject::instance()->transformContext() );
+  request.setInvalidGeometryCheck( QgsFeatureRequest::GeometrySkipInvalid );
+  fit = polygons->getFeatures( request );
+  QCOMPARE( fit.nextFeatures( block, 10 ), 4 );
+  QCOMPARE( block.at( 2 ).attribute( 0 ).toInt(), 3 );
+  QCOMPARE( block.at( 2 ).fields(), polygons->fields() );
+  QGSCOMPARENEAR( block.at( 2 ).geometry().boundingBox().xMinimum(), 333958.5, 1 );
+  QCOMPARE( fit.nextFeatures( block, 10 ), 0 );
+
+  request.setInvalidGeometryCheck( QgsFeatureRequest::GeometryAbortOnInvalid );
+  fit = polygons->getFeatures( request );
+  QCOMPARE( fit.nextFeatures( block, 10 ), 2 );
+  QCOMPARE( fit.nextFeatures( block, 10 ), 0 );
+
+  // features which need per feature handling from the layer: edit buffer and virtual fields
+  polygons->addExpressionField( QStringLiteral( "\"id\" * 2" ), QgsField( QStringLiteral( "double_id" ), QVariant::Int ) );
+  QVERIFY( polygons->startEditing() );
+  QVERIFY( polygons->changeAttributeValue( 2, 0, 20 ) );
+  QgsFeature added( polygons->fields() );
+  added.setAttributes( QgsAttributes() << 5 << QVariant() );
+  QVERIFY( polygons->addFeature( added ) );
+
+  fit = polygons->getFeatures();
+  int count = 0;
+  QSet< int > ids;
+  while ( fit.nextFeatures( block, 2 ) > 0 )
+  {
+    for ( const QgsFeature &feature : qgis::as_const( block ) )
+    {
+      ids << feature.attribute( 0 ).toInt();
+      QCOMPARE( feature.attribute( 1 ).toInt(), feature.attribute( 0 ).toInt() * 2 );
+      ++count;
+    }
+  }
+  QCOMPARE( count, 6 );
+  QCOMPARE( ids, QSet< int >() << 0 << 20 << 2 << 3 << 4 << 5 );
+  polygons->rollBack();
+
+  // blocks read from the OGR layer cursor match the features read one by one
+  const QList< QgsRectangle > rects = QList< QgsRectangle >() << QgsRectangle() << QgsRectangle( -118, 34, -100, 42 );
+  for ( const QgsRectangle &rect : rects )
+  {
+    QList< QgsFeatureId > expected;
+    QgsFeature f;
+    fit = mpLinesLayer->dataProvider()->getFeatures( QgsFeatureRequest().setFilterRect( rect ) );
+    while ( fit.nextFeature( f ) )
+      expected << f.id();
+    QVERIFY( !expected.isEmpty() );
+
+    QList< QgsFeatureId > fetched;
+    fit = mpLinesLayer->dataProvider()->getFeatures( QgsFeatureRequest().setFilterRect( rect ) );
+    while ( fit.nextFeatures( block, 3 ) > 0 )
+    {
+      for ( const QgsFeature &feature : qgis::as_const( block ) )
+      {
+        QVERIFY( feature.isValid() );
+        QVERIFY( feature.hasGeometry() );
+        QCOMPARE( feature.fields(), mpLinesLayer->dataProvider()->fields() );
+        fetched << feature.id();
+      }
+    }
+    QCOMPARE( fetched, expected );
+  }
+}
+
+void TestQgsVectorLayer::countSymbolFeatures()
+{
+  // more features than counted by a single thread at once
+  std::unique_ptr< QgsVectorLayer > layer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Point?field=cat:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeatureList features;
+  for ( int i = 0; i < 5000; ++i )
+  {
+    QgsFeature f( layer->fields() );
+    f.setAttribute( 0, i % 13 == 0 ? QVariant() : QVariant( i % 7 ) );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+  // value 6 has no category
+  QgsCategoryList categories;
+  for ( int i = 0; i < 6; ++i )
+    categories << QgsRendererCategory( i, QgsSymbol::defaultSymbol( QgsWkbTypes::PointGeometry ), QString::number( i ) );
+  categories << QgsRendererCategory( QVariant(), QgsSymbol::defaultSymbol( QgsWkbTypes::PointGeometry ), QStringLiteral( "null" ) );
+  layer->setRenderer( new QgsCategorizedSymbolRenderer( QStringLiteral( "cat" ), categories ) );
+
+  // sequential count with the renderer
+  QHash< QString, long > expected;
+  std::unique_ptr< QgsFeatureRenderer > renderer( layer->renderer()->clone() );
+  QgsRenderContext context;
+  context.setExpressionContext( layer->createExpressionContext() );
+  renderer->startRender( context, layer->fields() );
+  QgsFeature f;
+  QgsFeatureIterator fit = layer->getFeatures();
+  while ( fit.nextFeature( f ) )
+  {
+    context.expressionContext().setFeature( f );
+    const QSet<QString> keys = renderer->legendKeysForFeature( f, context );
+    for ( const QString &key : keys )
+      expected[key] += 1;
+  }
+  renderer->stopRender( context );
+  QCOMPARE( expected.size(), 7 );
+
+  QSignalSpy spy( layer.get(), &QgsVectorLayer::symbolFeatureCountMapChanged );
+  QVERIFY( layer->countSymbolFeatures() );
+  QVERIFY( spy.count() == 1 || spy.wait( 30000 ) );
+
+  for ( auto it = expected.constBegin(); it != expected.constEnd(); ++it )
+    QCOMPARE( layer->featureCount( it.key() ), it.value() );
+}
+
 void TestQgsVectorLayer::QgsVectorLayerGetValues()
 {
   QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Point?field=col1:real" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
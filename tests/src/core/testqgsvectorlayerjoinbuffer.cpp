@@ -65,6 +65,7 @@ class TestVectorLayerJoinBuffer : public QObject
     void testCacheUpdate();
     void testRemoveJoinOnLayerDelete();
     void testResolveReferences();
+    void testJoinBatched();
 
   private:
     QgsProject mProject;
@@ -665,6 +666,122 @@ void TestVectorLayerJoinBuffer::testResolveReferences()
   delete vlA;
 }
 
+void TestVectorLayerJoinBuffer::testJoinBatched()
+{
+  // more target features than a batch, with repeated and missing join values
+  QgsVectorLayer *vlA = new QgsVectorLayer( QStringLiteral( "Point?field=id_a:integer" ), QStringLiteral( "A" ), QStringLiteral( "memory" ) );
+  QgsVectorLayer *vlB = new QgsVectorLayer( QStringLiteral( "Point?field=id_b:integer&field=value_b:integer&field=name_b:string" ), QStringLiteral( "B" ), QStringLiteral( "memory" ) );
+
+  QgsFeatureList featuresA;
+  for ( int i = 0; i < 2500; ++i )
+  {
+    QgsFeature f( vlA->dataProvider()->fields() );
+    f.setAttribute( QStringLiteral( "id_a" ), i % 700 );
+    featuresA << f;
+  }
+  QVERIFY( vlA->dataProvider()->addFeatures( featuresA ) );
+
+  QgsFeatureList featuresB;
+  for ( int i = 0; i < 600; ++i )
+  {
+    QgsFeature f( vlB->dataProvider()->fields() );
+    f.setAttribute( QStringLiteral( "id_b" ), i );
+    f.setAttribute( QStringLiteral( "value_b" ), i * 10 );
+    f.setAttribute( QStringLiteral( "name_b" ), QStringLiteral( "name %1" ).arg( i ) );
+    featuresB << f;
+  }
+  QVERIFY( vlB->dataProvider()->addFeatures( featuresB ) );
+
+  QgsProject project;
+  project.addMapLayers( QList<QgsMapLayer *>() << vlA << vlB );
+
+  QgsVectorLayerJoinInfo joinInfo;
+  joinInfo.setTargetFieldName( QStringLiteral( "id_a" ) );
+  joinInfo.setJoinLayer( vlB );
+  joinInfo.setJoinFieldName( QStringLiteral( "id_b" ) );
+  joinInfo.setUsingMemoryCache( false );
+  joinInfo.setPrefix( QStringLiteral( "B_" ) );
+  vlA->addJoin( joinInfo );
+  QCOMPARE( vlA->fields().count(), 3 );
+
+  int count = 0;
+  QgsFeature f;
+  QgsFeatureIterator fi = vlA->getFeatures();
+  while ( fi.nextFeature( f ) )
+  {
+    const int id = f.attribute( QStringLiteral( "id_a" ) ).toInt();
+    if ( id < 600 )
+    {
+      QCOMPARE( f.attribute( QStringLiteral( "B_value_b" ) ).toInt(), id * 10 );
+      QCOMPARE( f.attribute( QStringLiteral( "B_name_b" ) ).toString(), QStringLiteral( "name %1" ).arg( id ) );
+    }
+    else
+    {
+      QVERIFY( f.attribute( QStringLiteral( "B_value_b" ) ).isNull() );
+      QVERIFY( f.attribute( QStringLiteral( "B_name_b" ) ).isNull() );
+    }
+    ++count;
+  }
+  QCOMPARE( count, 2500 );
+
+  // subset of joined fields and subset of attributes
+  vlA->removeJoin( vlB->id() );
+  joinInfo.setJoinFieldNamesSubset( new QStringList( QStringList() << QStringLiteral( "name_b" ) ) );
+  vlA->addJoin( joinInfo );
+  QCOMPARE( vlA->fields().count(), 2 );
+
+  QgsFeatureRequest request;
+  request.setSubsetOfAttributes( QStringList() << QStringLiteral( "B_name_b" ), vlA->fields() );
+  fi = vlA->getFeatures( request );
+  count = 0;
+  while ( fi.nextFeature( f ) )
+  {
+    const int id = f.attribute( QStringLiteral( "id_a" ) ).toInt();
+    if ( id < 600 )
+      QCOMPARE( f.attribute( QStringLiteral( "B_name_b" ) ).toString(), QStringLiteral( "name %1" ).arg( id ) );
+    else
+      QVERIFY( f.attribute( QStringLiteral( "B_name_b" ) ).isNull() );
+    ++count;
+  }
+  QCOMPARE( count, 2500 );
+
+  // joined attributes are fetched once per batch: changes made to the joined layer while
+  // iterating are only seen by the features of the next batches
+  vlA->removeJoin( vlB->id() );
+  joinInfo.setJoinFieldNamesSubset( nullptr );
+  vlA->addJoin( joinInfo );
+
+  fi = vlA->getFeatures();
+  QVERIFY( fi.nextFeature( f ) );
+  QgsChangedAttributesMap changes;
+  QgsFeatureIterator fiB = vlB->getFeatures();
+  QgsFeature fB;
+  while ( fiB.nextFeature( fB ) )
+    changes[ fB.id() ].insert( 1, -1 );
+  fiB.close();
+  QVERIFY( vlB->dataProvider()->changeAttributeValues( changes ) );
+
+  count = 1;
+  while ( fi.nextFeature( f ) )
+  {
+    const int id = f.attribute( QStringLiteral( "id_a" ) ).toInt();
+    if ( id < 600 )
+      QCOMPARE( f.attribute( QStringLiteral( "B_value_b" ) ).toInt(), count < 1000 ? id * 10 : -1 );
+    ++count;
+  }
+  QCOMPARE( count, 2500 );
+
+  // a limited request only reads ahead the features it can still return
+  fi = vlA->getFeatures( QgsFeatureRequest().setLimit( 5 ) );
+  count = 0;
+  while ( fi.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( QStringLiteral( "B_value_b" ) ).toInt(), -1 );
+    ++count;
+  }
+  QCOMPARE( count, 5 );
+}
+
 
 QGSTEST_MAIN( TestVectorLayerJoinBuffer )
 #include "testqgsvectorlayerjoinbuffer.moc"
@@ -42,7 +42,7 @@ from utilities import (
 )
 
 from providertestbase import ProviderTestCase
-from qgis.PyQt.QtCore import QVariant
+from qgis.PyQt.QtCore import QVariant, QDate
 
 start_app()
 TEST_DATA_DIR = unitTestDataPath()
@@ -350,6 +350,110 @@ class TestPyQgsMemoryProvider(unittest.TestCase, ProviderTestCase):
         self.assertEqual(fet.fields()[1].name(), 'mapinfo_is_the_stone_age')
         self.assertEqual(fet.fields()[2].name(), 'super_size')
 
+    def testDeleteAndFetchFeatures(self):
+        layer = QgsVectorLayer("Point?field=id:integer", "test", "memory")
+        provider = layer.dataProvider()
+
+        features = []
+        for i in range(10):
+            f = QgsFeature(provider.fields())
+            f.setAttributes([i])
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(i, i)))
+            features.append(f)
+        res, features = provider.addFeatures(features)
+        self.assertTrue(res)
+        ids = [f.id() for f in features]
+
+        self.assertTrue(provider.deleteFeatures([ids[0], ids[4], ids[9]]))
+        self.assertEqual(provider.featureCount(), 7)
+        self.assertEqual([f['id'] for f in provider.getFeatures()], [1, 2, 3, 5, 6, 7, 8])
+
+        # fetch by id
+        self.assertEqual(next(provider.getFeatures(QgsFeatureRequest(ids[5])))['id'], 5)
+        self.assertFalse([f for f in provider.getFeatures(QgsFeatureRequest(ids[4]))])
+
+        # changes after deletions
+        self.assertTrue(provider.changeGeometryValues({ids[5]: QgsGeometry.fromPointXY(QgsPointXY(100, 100))}))
+        self.assertTrue(provider.changeAttributeValues({ids[6]: {0: 60}}))
+        self.assertEqual([f['id'] for f in provider.getFeatures(QgsFeatureRequest(QgsRectangle(99, 99, 101, 101)))], [5])
+        self.assertEqual([f['id'] for f in provider.getFeatures(QgsFeatureRequest(QgsRectangle(5, 5, 6, 6)))], [60])
+        self.assertEqual(provider.extent(), QgsRectangle(1, 1, 100, 100))
+
+        # new features get new ids
+        f = QgsFeature(provider.fields())
+        f.setAttributes([10])
+        res, added = provider.addFeatures([f])
+        self.assertTrue(res)
+        self.assertTrue(added[0].id() > ids[9])
+
+    def testCreateSpatialIndexWithFeatures(self):
+        layer = QgsVectorLayer("Point?field=id:integer", "test", "memory")
+        provider = layer.dataProvider()
+
+        features = []
+        for i in range(100):
+            f = QgsFeature(provider.fields())
+            f.setAttributes([i])
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(i, i)))
+            features.append(f)
+        self.assertTrue(provider.addFeatures(features)[0])
+
+        # all features are indexed, regardless of the subset string
+        self.assertTrue(provider.setSubsetString('"id" < 10'))
+        self.assertTrue(provider.createSpatialIndex())
+        self.assertTrue(provider.setSubsetString(''))
+        self.assertEqual(sorted([f['id'] for f in provider.getFeatures(QgsFeatureRequest(QgsRectangle(49.5, 49.5, 52.5, 52.5)))]), [50, 51, 52])
+
+    def testStoredValues(self):
+        layer = QgsVectorLayer("LineString?field=i:integer&field=l:long&field=d:double&field=s:string&field=dt:date", "test", "memory")
+        provider = layer.dataProvider()
+
+        values = [[1, 5000000000, 1.5, 'a', QDate(2018, 1, 2)],
+                  [NULL, NULL, NULL, NULL, NULL],
+                  [-2, -3, -0.25, '', QDate(2018, 3, 4)],
+                  ['x', 2.5, 'y', 7, 'z'],
+                  [3, 4, 0.1, 'a', NULL]]
+        features = []
+        for i, attributes in enumerate(values):
+            f = QgsFeature(provider.fields())
+            f.setAttributes(attributes)
+            if i != 1:
+                f.setGeometry(QgsGeometry.fromWkt('CompoundCurveZ(({0} 0 1, {0} 1 2))'.format(i)))
+            features.append(f)
+        res, features = provider.addFeatures(features)
+        self.assertTrue(res)
+        ids = [f.id() for f in features]
+
+        fetched = [f for f in provider.getFeatures()]
+        self.assertEqual([f.attributes() for f in fetched], values)
+        self.assertEqual([f.geometry().asWkt() for f in fetched],
+                         ['CompoundCurveZ ((0 0 1, 0 1 2))', '', 'CompoundCurveZ ((2 0 1, 2 1 2))',
+                          'CompoundCurveZ ((3 0 1, 3 1 2))', 'CompoundCurveZ ((4 0 1, 4 1 2))'])
+        self.assertFalse(fetched[1].hasGeometry())
+
+        # geometries are not built when not requested
+        self.assertFalse([f for f in provider.getFeatures(QgsFeatureRequest().setFlags(QgsFeatureRequest.NoGeometry)) if f.hasGeometry()])
+
+        # replaced and removed geometries
+        for i in range(100):
+            self.assertTrue(provider.changeGeometryValues({ids[0]: QgsGeometry.fromWkt('LineString({} 0, 0 1)'.format(i))}))
+        self.assertTrue(provider.changeGeometryValues({ids[2]: QgsGeometry()}))
+        self.assertTrue(provider.changeAttributeValues({ids[3]: {0: 8, 1: NULL, 3: 'a'}, ids[4]: {2: 'w'}}))
+        self.assertTrue(provider.deleteFeatures([ids[1]]))
+        self.assertTrue(provider.addAttributes([QgsField('added', QVariant.Int)]))
+
+        fetched = [f for f in provider.getFeatures()]
+        self.assertEqual([f.geometry().asWkt() for f in fetched],
+                         ['LineString (99 0, 0 1)', '', 'CompoundCurveZ ((3 0 1, 3 1 2))', 'CompoundCurveZ ((4 0 1, 4 1 2))'])
+        self.assertEqual([f.attributes()[:4] for f in fetched],
+                         [[1, 5000000000, 1.5, 'a'], [-2, -3, -0.25, ''], [8, NULL, 'y', 'a'], [3, 4, 'w', 'a']])
+        self.assertEqual([f['added'] for f in fetched], [NULL] * 4)
+        self.assertEqual(provider.extent(), QgsRectangle(0, 0, 99, 1))
+
+        self.assertTrue(provider.deleteAttributes([1, 3]))
+        self.assertEqual([f.attributes() for f in provider.getFeatures()],
+                         [[1, 1.5, QDate(2018, 1, 2), NULL], [-2, -0.25, QDate(2018, 3, 4), NULL], [8, 'y', 'z', NULL], [3, 'w', NULL, NULL]])
+
     def testUniqueSource(self):
         """
         Similar memory layers should have unique source - some code checks layer source to identify
@@ -14,12 +14,14 @@ __revision__ = '$Format:%H$'
 
 import os
 import shutil
+import struct
 import sys
 import tempfile
 
 from osgeo import gdal, ogr  # NOQA
 from qgis.core import (QgsFeature, QgsFeatureRequest, QgsSettings, QgsDataProvider,
-                       QgsVectorDataProvider, QgsVectorLayer, QgsWkbTypes, QgsNetworkAccessManager)
+                       QgsVectorDataProvider, QgsVectorLayer, QgsWkbTypes, QgsNetworkAccessManager,
+                       QgsGeometry, QgsPointXY, QgsRectangle)
 from qgis.testing import start_app, unittest
 
 from utilities import unitTestDataPath
@@ -237,6 +239,60 @@ class PyQgsOGRProvider(unittest.TestCase):
         os.unlink(datasource)
         self.assertFalse(os.path.exists(datasource))
 
+    def testSidecarSpatialIndex(self):
+        """ Test the spatial index of formats without a native one"""
+
+        datasource = os.path.join(self.basetestpath, 'testSidecarSpatialIndex.geojson')
+        with open(datasource, 'wt') as f:
+            f.write('{"type": "FeatureCollection", "features": [\n')
+            f.write(',\n'.join('{"type": "Feature", "properties": {"id": %d}, "geometry": {"type": "Point", "coordinates": [%d, %d]}}' % (i, i, i) for i in range(100)))
+            f.write(']}\n')
+
+        # keep the index files out of the user profile
+        cache_dir = tempfile.mkdtemp()
+        self.dirs_to_cleanup.append(cache_dir)
+        settings = QgsSettings()
+        settings.setValue('cache/spatialIndexDirectory', cache_dir)
+        self.addCleanup(settings.remove, 'cache/spatialIndexDirectory')
+
+        vl = QgsVectorLayer(datasource, 'test', 'ogr')
+        self.assertTrue(vl.isValid())
+        self.assertTrue(vl.dataProvider().capabilities() & QgsVectorDataProvider.CreateSpatialIndex)
+        self.assertTrue(vl.dataProvider().createSpatialIndex())
+        self.assertEqual(len([f for f in os.listdir(cache_dir) if f.endswith('.qgsidx')]), 1)
+
+        request = QgsFeatureRequest().setFilterRect(QgsRectangle(9.5, 9.5, 20.5, 20.5))
+        self.assertEqual(sorted([f['id'] for f in vl.getFeatures(request)]), list(range(10, 21)))
+        del vl
+
+        # the index is reused when opening the layer again
+        vl = QgsVectorLayer(datasource, 'test', 'ogr')
+        self.assertEqual(sorted([f['id'] for f in vl.getFeatures(request)]), list(range(10, 21)))
+        self.assertEqual(len([f for f in vl.getFeatures(QgsFeatureRequest().setFilterRect(QgsRectangle(200, 200, 300, 300)))]), 0)
+        del vl
+
+        # a corrupted index is ignored: break the bounds of the intermediate level
+        index_path = os.path.join(cache_dir, [f for f in os.listdir(cache_dir) if f.endswith('.qgsidx')][0])
+        with open(index_path, 'rb') as f:
+            data = bytearray(f.read())
+        key_size = struct.unpack('>I', data[0:4])[0]
+        # key, magic, version, node size, item count, then the level bounds vector
+        level_bounds = 4 + key_size + 16
+        self.assertGreater(struct.unpack('>I', data[level_bounds:level_bounds + 4])[0], 2)
+        data[level_bounds + 8:level_bounds + 12] = struct.pack('>i', 0x7fffffff)
+        with open(index_path, 'wb') as f:
+            f.write(data)
+        vl = QgsVectorLayer(datasource, 'test', 'ogr')
+        self.assertEqual(sorted([f['id'] for f in vl.getFeatures(request)]), list(range(10, 21)))
+
+        # edits are taken into account
+        f = QgsFeature()
+        f.setAttributes([100])
+        f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(15.2, 15.2)))
+        self.assertTrue(vl.dataProvider().addFeatures([f]))
+        self.assertEqual(sorted([f['id'] for f in vl.getFeatures(request)]), list(range(10, 21)) + [100])
+        del vl
+
     def testGdb(self):
         """ Test opening a GDB database layer"""
         gdb_path = os.path.join(unitTestDataPath(), 'test_gdb.gdb')
@@ -163,6 +163,31 @@ class TestPyQgsPostgresProvider(unittest.TestCase, ProviderTestCase):
         }
         self.assertEqual(values, expected)
 
+    def testBinaryValues(self):
+        query = ('(SELECT 1::int4 id, (-2)::int2 i2, (-3)::int4 i4, 5000000000::int8 i8, 1.5::float4 f4, 0.1::float4 f4_dec, 1.0000001::float4 f4_prec, (-2.25)::float8 f8, '
+                 '\'1999-12-31\'::date d, \'23:59:58.5\'::time t, \'1999-12-31 23:59:59.5\'::timestamp ts, '
+                 '\'2017-07-15 12:30:00.25\'::timestamp ts_summer, \'1969-07-20 20:17:40\'::timestamp ts_before, '
+                 'NULL::float8 n, NULL::geometry(Point, 4326) geom)')
+        vl = QgsVectorLayer('%s srid=4326 table="%s" (geom) key=\'id\' sql=' % (self.dbconn, query), "testbinary", "postgres")
+        self.assertTrue(vl.isValid())
+
+        f = next(vl.getFeatures())
+        self.assertEqual(f['i2'], -2)
+        self.assertEqual(f['i4'], -3)
+        self.assertEqual(f['i8'], 5000000000)
+        self.assertEqual(f['f4'], 1.5)
+        # float4 values are not widened with their binary error
+        self.assertEqual(f['f4_dec'], 0.1)
+        self.assertEqual(f['f4_prec'], 1.0000001)
+        self.assertEqual(f['f8'], -2.25)
+        self.assertEqual(f['d'], QDate(1999, 12, 31))
+        self.assertEqual(f['t'], QTime(23, 59, 58, 500))
+        self.assertEqual(f['ts'], QDateTime(QDate(1999, 12, 31), QTime(23, 59, 59, 500)))
+        # daylight saving time must not shift the decoded values
+        self.assertEqual(f['ts_summer'], QDateTime(QDate(2017, 7, 15), QTime(12, 30, 0, 250)))
+        self.assertEqual(f['ts_before'], QDateTime(QDate(1969, 7, 20), QTime(20, 17, 40)))
+        self.assertEqual(f['n'], NULL)
+
     def testQueryLayers(self):
         def test_query(dbconn, query, key):
             ql = QgsVectorLayer('%s srid=4326 table="%s" (geom) key=\'%s\' sql=' % (dbconn, query.replace('"', '\\"'), key), "testgeom", "postgres")
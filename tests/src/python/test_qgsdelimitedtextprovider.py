@@ -805,6 +805,57 @@ class TestQgsDelimitedTextProviderOther(unittest.TestCase):
         requests = None
         self.runTest(filename, requests, **params)
 
+    def test_041_random_access_large_file(self):
+        # Features are fetched by id from a file starting with a byte order mark
+        # and using windows line endings
+        tmpdir = tempfile.mkdtemp()
+        filename = os.path.join(tmpdir, 'large.csv')
+        with open(filename, 'wb') as f:
+            f.write(b'\xef\xbb\xbfid,name,x,y\r\n')
+            for i in range(2000):
+                f.write('{},n\u00e9{},{},{}\r\n'.format(i, i, i, -i).encode('utf-8'))
+
+        url = MyUrl.fromLocalFile(filename)
+        url.addQueryItem('type', 'csv')
+        url.addQueryItem('xField', 'x')
+        url.addQueryItem('yField', 'y')
+        vl = QgsVectorLayer(url.toString(), 'test', 'delimitedtext')
+        self.assertTrue(vl.isValid())
+        self.assertEqual(vl.fields().names(), ['id', 'name', 'x', 'y'])
+        self.assertEqual(vl.featureCount(), 2000)
+
+        # line numbers are the feature ids, the header is line 1
+        for i in [1500, 10, 1999, 700, 0, 701]:
+            f = next(vl.getFeatures(QgsFeatureRequest(i + 2)))
+            self.assertEqual(f['id'], i)
+            self.assertEqual(f['name'], 'n\u00e9{}'.format(i))
+            self.assertEqual(f.geometry().asPoint().x(), i)
+
+    def test_042_file_truncated_while_read(self):
+        # The file is read by blocks, a truncated file only ends the iteration early
+        tmpdir = tempfile.mkdtemp()
+        filename = os.path.join(tmpdir, 'truncated.csv')
+        with open(filename, 'wb') as f:
+            f.write(b'id,x,y\n')
+            for i in range(20000):
+                f.write('{},{},{}\n'.format(i, i, -i).encode('utf-8'))
+
+        url = MyUrl.fromLocalFile(filename)
+        url.addQueryItem('type', 'csv')
+        url.addQueryItem('xField', 'x')
+        url.addQueryItem('yField', 'y')
+        vl = QgsVectorLayer(url.toString(), 'test', 'delimitedtext')
+        self.assertTrue(vl.isValid())
+        self.assertEqual(vl.featureCount(), 20000)
+
+        it = vl.getFeatures()
+        self.assertEqual(next(it)['id'], 0)
+        with open(filename, 'r+b') as f:
+            f.truncate(1000)
+        ids = [f['id'] for f in it]
+        self.assertTrue(len(ids) < 19999)
+        self.assertEqual(ids[:3], [1, 2, 3])
+
 
 if __name__ == '__main__':
     unittest.main()
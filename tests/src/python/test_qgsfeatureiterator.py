@@ -101,6 +101,47 @@ class TestQgsFeatureIterator(unittest.TestCase):
         expectedIds = [7, 8, 12]
         self.assertEqual(set(ids), set(expectedIds))
 
+    def test_Prefetch(self):
+        layer = QgsVectorLayer("Point?field=x:integer", "prefetch", "memory")
+        features = []
+        for i in range(1000):
+            f = QgsFeature(layer.fields())
+            f['x'] = i
+            f.setGeometry(QgsGeometry.fromWkt('Point({} {})'.format(i, i)))
+            features.append(f)
+        self.assertTrue(layer.dataProvider().addFeatures(features))
+
+        request = QgsFeatureRequest().setFlags(QgsFeatureRequest.PrefetchFeatures)
+        it = layer.getFeatures(request)
+        self.assertTrue(it.isValid())
+        self.assertEqual([f['x'] for f in it], list(range(1000)))
+
+        # filtering, ordering and limit are applied by the prefetched iterator
+        request = QgsFeatureRequest().setFlags(QgsFeatureRequest.PrefetchFeatures).setFilterExpression('x >= 500')
+        request.addOrderBy('x', False)
+        request.setLimit(3)
+        self.assertEqual([f['x'] for f in layer.getFeatures(request)], [999, 998, 997])
+
+        # features from the edit buffer
+        layer.startEditing()
+        self.assertTrue(layer.deleteFeatures([f.id() for f in layer.getFeatures(QgsFeatureRequest().setFilterExpression('x > 1'))]))
+        request = QgsFeatureRequest().setFlags(QgsFeatureRequest.PrefetchFeatures)
+        self.assertEqual([f['x'] for f in layer.getFeatures(request)], [0, 1])
+
+        # rewind
+        it = layer.getFeatures(request)
+        f = QgsFeature()
+        self.assertTrue(it.nextFeature(f))
+        self.assertTrue(it.rewind())
+        self.assertEqual([f['x'] for f in it], [0, 1])
+        layer.rollBack()
+
+        # closing before the end stops the background thread
+        it = layer.getFeatures(request)
+        self.assertTrue(it.nextFeature(f))
+        self.assertTrue(it.close())
+        self.assertFalse(it.nextFeature(f))
+
     def addFeatures(self, vl):
         feat = QgsFeature()
         fields = vl.fields()
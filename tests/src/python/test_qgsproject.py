@@ -24,7 +24,8 @@ from qgis.core import (QgsProject,
                        QgsCoordinateReferenceSystem,
                        QgsVectorLayer,
                        QgsRasterLayer,
-                       QgsMapLayer)
+                       QgsMapLayer,
+                       QgsPrintLayout)
 from qgis.gui import (QgsLayerTreeMapCanvasBridge,
                       QgsMapCanvas)
 
@@ -753,6 +754,46 @@ class TestQgsProject(unittest.TestCase):
         project2.clear()
         self.assertFalse(project2.isZipped())
 
+    def testReadFlags(self):
+        tmpDir = QTemporaryDir()
+        tmpFile = "{}/project.qgs".format(tmpDir.path())
+
+        project = QgsProject()
+        l0 = QgsVectorLayer(os.path.join(TEST_DATA_DIR, "points.shp"), "points", "ogr")
+        project.addMapLayers([l0])
+        layout = QgsPrintLayout(project)
+        layout.setName('layout1')
+        self.assertTrue(project.layoutManager().addLayout(layout))
+        self.assertTrue(project.write(tmpFile))
+
+        # default flags
+        project2 = QgsProject()
+        self.assertTrue(project2.read(tmpFile))
+        self.assertEqual(len(project2.mapLayers()), 1)
+        self.assertEqual(len(project2.layoutManager().layouts()), 1)
+        self.assertFalse(project2.trustLayerMetadata())
+
+        # don't load layouts
+        project3 = QgsProject()
+        self.assertTrue(project3.read(tmpFile, QgsProject.FlagDontLoadLayouts))
+        self.assertEqual(len(project3.mapLayers()), 1)
+        self.assertEqual(len(project3.layoutManager().layouts()), 0)
+
+        # trust layer metadata
+        project4 = QgsProject()
+        self.assertTrue(project4.read(tmpFile, QgsProject.FlagTrustLayerMetadata))
+        self.assertEqual(len(project4.mapLayers()), 1)
+        self.assertTrue(list(project4.mapLayers().values())[0].readExtentFromXml())
+
+        # the flag is not stored in the project
+        self.assertFalse(project4.trustLayerMetadata())
+        tmpFile2 = "{}/project2.qgs".format(tmpDir.path())
+        self.assertTrue(project4.write(tmpFile2))
+        project5 = QgsProject()
+        self.assertTrue(project5.read(tmpFile2))
+        self.assertFalse(project5.trustLayerMetadata())
+        self.assertFalse(list(project5.mapLayers().values())[0].readExtentFromXml())
+
     def testUpgradeOtfFrom2x(self):
         """
         Test that upgrading a 2.x project correctly brings across project CRS and OTF transformation settings
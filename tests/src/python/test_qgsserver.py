@@ -341,6 +341,31 @@ class TestQgsServer(QgsServerTestBase):
         expected = self.strip_version_xmlns(b'<ServiceExceptionReport version="1.3.0" xmlns="http://www.opengis.net/ogc">\n <ServiceException code="Service configuration error">Service unknown or unsupported</ServiceException>\n</ServiceExceptionReport>\n')
         self.assertEqual(self.strip_version_xmlns(body), expected)
 
+    def test_metrics(self):
+        """Test the built-in metrics output"""
+        project = self.testdata_path + "test_project_wfs.qgs"
+
+        # metrics are disabled by default: METRICS is an unknown service
+        header, body = self._execute_request('?MAP=%s&SERVICE=METRICS' % urllib.parse.quote(project))
+        self.assertTrue(b'Service unknown or unsupported' in body)
+
+        self.server.putenv('QGIS_SERVER_METRICS', '1')
+        try:
+            # two requests on the same project: one cache miss (if not yet
+            # cached) and at least one hit
+            self._execute_request('?MAP=%s' % urllib.parse.quote(project))
+            self._execute_request('?MAP=%s' % urllib.parse.quote(project))
+
+            header, body = self._execute_request('?SERVICE=METRICS')
+            self.assertTrue(b'Content-Type: text/plain; version=0.0.4' in header)
+            self.assertTrue(b'# TYPE qgis_server_requests_total counter' in body)
+            self.assertTrue(b'qgis_server_config_cache_hits_total' in body)
+            self.assertTrue(b'qgis_server_stage_seconds_total{stage="project_load"}' in body)
+            hits = re.search(b'qgis_server_config_cache_hits_total (\\d+)', body)
+            self.assertTrue(int(hits.group(1)) >= 1)
+        finally:
+            self.server.putenv('QGIS_SERVER_METRICS', '')
+
     # WCS tests
     def wcs_request_compare(self, request):
         project = self.projectPath
@@ -133,6 +133,46 @@ class TestQgsServerSettings(unittest.TestCase):
         self.assertEqual(self.settings.cacheDirectory(), "/tmp/fake")
         os.environ.pop(env)
 
+    def test_env_trust_layer_metadata(self):
+        env = "QGIS_SERVER_TRUST_LAYER_METADATA"
+
+        self.assertFalse(self.settings.trustLayerMetadata())
+
+        os.environ[env] = "1"
+        self.settings.load()
+        self.assertTrue(self.settings.trustLayerMetadata())
+        os.environ.pop(env)
+
+        os.environ[env] = "0"
+        self.settings.load()
+        self.assertFalse(self.settings.trustLayerMetadata())
+        os.environ.pop(env)
+
+    def test_env_disable_getprint(self):
+        env = "QGIS_SERVER_DISABLE_GETPRINT"
+
+        self.assertFalse(self.settings.getPrintDisabled())
+
+        os.environ[env] = "1"
+        self.settings.load()
+        self.assertTrue(self.settings.getPrintDisabled())
+        os.environ.pop(env)
+
+        os.environ[env] = "0"
+        self.settings.load()
+        self.assertFalse(self.settings.getPrintDisabled())
+        os.environ.pop(env)
+
+    def test_env_metrics(self):
+        env = "QGIS_SERVER_METRICS"
+
+        self.assertFalse(self.settings.metricsEnabled())
+
+        os.environ[env] = "1"
+        self.settings.load()
+        self.assertTrue(self.settings.metricsEnabled())
+        os.environ.pop(env)
+
     def test_priority(self):
         env = "QGIS_OPTIONS_PATH"
         dpath = "conf0"
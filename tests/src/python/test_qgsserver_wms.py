@@ -232,6 +232,46 @@ class TestQgsServerWMS(QgsServerTestBase):
                                  'wms_getfeatureinfo_notvisible',
                                  'test_project_scalevisibility.qgs')
 
+    def wms_getfeatureinfo_count(self, extra):
+        """Returns the number of features in a text/xml GetFeatureInfo response on testlayer"""
+        project = self.testdata_path + 'test_project.qgs'
+        query_string = 'https://www.qgis.org/?MAP=%s&SERVICE=WMS&VERSION=1.3&REQUEST=GetFeatureInfo' % urllib.parse.quote(project)
+        query_string += ('&layers=testlayer%20%C3%A8%C3%A9&styles=&' +
+                         'info_format=text%2Fxml&' +
+                         'width=600&height=400&srs=EPSG%3A3857&' +
+                         'query_layers=testlayer%20%C3%A8%C3%A9' + extra)
+        header, body = self._execute_request(query_string)
+        self.assertIn(b'GetFeatureInfoResponse', body, body)
+        return body.count(b'<Feature ')
+
+    def test_getfeatureinfo_feature_count(self):
+        # several features are found around the clicked point, only FEATURE_COUNT are returned
+        around = ('&bbox=913190.6389747962%2C5606005.488876367%2C913235.426296057%2C5606035.347090538&' +
+                  'X=300&Y=200&FI_POINT_TOLERANCE=1000')
+        self.assertEqual(self.wms_getfeatureinfo_count(around + '&FEATURE_COUNT=10'), 3)
+        self.assertEqual(self.wms_getfeatureinfo_count(around + '&FEATURE_COUNT=2'), 2)
+        self.assertEqual(self.wms_getfeatureinfo_count(around + '&FEATURE_COUNT=1'), 1)
+        self.assertEqual(self.wms_getfeatureinfo_count(around), 1)
+
+        # without a clicked point, the count is handed to the provider
+        filter = '&FILTER=testlayer%20%C3%A8%C3%A9' + urllib.parse.quote(':"NAME" = \'two\' OR "NAME" = \'three\'')
+        self.assertEqual(self.wms_getfeatureinfo_count(filter + '&FEATURE_COUNT=10'), 2)
+        self.assertEqual(self.wms_getfeatureinfo_count(filter + '&FEATURE_COUNT=1'), 1)
+
+    def test_getfeatureinfo_outside_layer_extent(self):
+        # the layer is skipped without being queried, and still listed in the response
+        project = self.testdata_path + 'test_project.qgs'
+        query_string = 'https://www.qgis.org/?MAP=%s&SERVICE=WMS&VERSION=1.3&REQUEST=GetFeatureInfo' % urllib.parse.quote(project)
+        query_string += ('&layers=testlayer%20%C3%A8%C3%A9&styles=&' +
+                         'info_format=text%2Fxml&' +
+                         'width=600&height=400&srs=EPSG%3A3857&' +
+                         'bbox=0%2C0%2C1000%2C1000&' +
+                         'query_layers=testlayer%20%C3%A8%C3%A9&X=300&Y=200&FI_POINT_TOLERANCE=1000&FEATURE_COUNT=10')
+        header, body = self._execute_request(query_string)
+        self.assertIn(b'GetFeatureInfoResponse', body, body)
+        self.assertIn('<Layer name="testlayer èé"'.encode('utf-8'), body, body)
+        self.assertNotIn(b'<Feature ', body, body)
+
     def test_describelayer(self):
         # Test DescribeLayer
         self.wms_request_compare('DescribeLayer',
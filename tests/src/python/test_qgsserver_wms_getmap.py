@@ -972,6 +972,36 @@ class TestQgsServerWMSGetMap(QgsServerTestBase):
         r_group_sld, _ = self._result(self._execute_request(qs))
         self.assertEqual(r_individual, r_group_sld, 'Individual layers query and SLD group layers query results should be identical')
 
+    def test_wms_getmap_mvt(self):
+        qs = "?" + "&".join(["%s=%s" % i for i in list({
+            "MAP": urllib.parse.quote(self.projectPath),
+            "SERVICE": "WMS",
+            "VERSION": "1.1.1",
+            "REQUEST": "GetMap",
+            "LAYERS": "Country,Hello",
+            "STYLES": "",
+            "FORMAT": "application/vnd.mapbox-vector-tile",
+            "BBOX": "-16817707,-4710778,5696513,14587125",
+            "HEIGHT": "256",
+            "WIDTH": "256",
+            "CRS": "EPSG:3857"
+        }.items())])
+
+        r, h = self._result(self._execute_request(qs))
+        self.assertEqual(h['Content-Type'], 'application/vnd.mapbox-vector-tile')
+
+        # tile made of layers messages (field 3, length delimited)
+        self.assertTrue(len(r) > 0)
+        self.assertEqual(r[0], 0x1a)
+        self.assertTrue(b'Country' in r)
+        self.assertTrue(b'Hello' in r)
+
+        # empty tile outside of the layers extent
+        qs = qs.replace("-16817707,-4710778,5696513,14587125", "-15000000,-5000000,-14999000,-4999000")
+        r, h = self._result(self._execute_request(qs))
+        self.assertEqual(h['Content-Type'], 'application/vnd.mapbox-vector-tile')
+        self.assertEqual(r, b'')
+
 
 if __name__ == '__main__':
     unittest.main()
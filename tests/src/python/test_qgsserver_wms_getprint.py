@@ -358,6 +358,35 @@ class TestQgsServerWMSGetPrint(QgsServerTestBase):
         assert h.get("Content-Type").startswith('image'), r
         self._img_diff_error(r, h, "WMS_GetPrint_Highlight")
 
+    def test_wms_getprint_disabled(self):
+        self.server.putenv('QGIS_SERVER_DISABLE_GETPRINT', '1')
+        try:
+            # GetPrint is not advertised, and layouts are not listed
+            qs = "?" + "&".join(["%s=%s" % i for i in list({
+                "MAP": urllib.parse.quote(self.projectGroupsPath),
+                "SERVICE": "WMS",
+                "VERSION": "1.3.0",
+                "REQUEST": "GetProjectSettings"
+            }.items())])
+            r, h = self._result(self._execute_request(qs))
+            self.assertIn(b'<GetFeatureInfo>', r)
+            self.assertNotIn(b'<GetPrint>', r)
+            self.assertNotIn(b'<ComposerTemplates', r)
+
+            qs = "?" + "&".join(["%s=%s" % i for i in list({
+                "MAP": urllib.parse.quote(self.projectGroupsPath),
+                "SERVICE": "WMS",
+                "VERSION": "1.3.0",
+                "REQUEST": "GetPrint",
+                "TEMPLATE": "layoutA4",
+                "FORMAT": "png",
+                "CRS": "EPSG:3857"
+            }.items())])
+            r, h = self._result(self._execute_request(qs))
+            self.assertIn(b'OperationNotSupported', r)
+        finally:
+            self.server.putenv('QGIS_SERVER_DISABLE_GETPRINT', '')
+
     def test_wms_getprint_label(self):
         qs = "?" + "&".join(["%s=%s" % i for i in list({
             "MAP": urllib.parse.quote(self.projectPath),